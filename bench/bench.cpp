@@ -0,0 +1,590 @@
+#include "test-classes/hedgehog.hpp"
+#include "test-classes/polymorphic.hpp"
+#include "test-classes/simple.hpp"
+#include "test-classes/tree.hpp"
+#include "test-classes/withcontainer.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef SERIALIZER_BENCH_ZPP_BITS
+#include <zpp_bits.h>
+#endif
+
+#ifdef SERIALIZER_BENCH_CEREAL
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/array.hpp>
+#include <cereal/types/list.hpp>
+#include <cereal/types/memory.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#include <sstream>
+#endif
+
+#ifdef SERIALIZER_BENCH_CISTA
+#include <cista.h>
+#endif
+
+/******************************************************************************/
+/*                            allocation counting                             */
+/******************************************************************************/
+
+/// @brief Number of calls to the global operator new since the beginning of
+///        the program (the benchmark is single threaded).
+static size_t nbAllocations = 0;
+
+void *operator new(size_t size) {
+    ++nbAllocations;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+
+/******************************************************************************/
+/*                                  harness                                   */
+/******************************************************************************/
+
+/// @brief Minimal time spent on each measurement (can be changed with the
+///        first command line argument).
+static double minTime = 0.2;
+
+/// @brief Prevent the compiler from optimizing away the benchmarked values.
+template <typename T> inline void doNotOptimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// @brief Result of one measurement (one object is processed per run).
+struct Measure {
+    double mbps = 0;         ///< throughput
+    double nsPerObj = 0;     ///< time per object
+    double allocsPerObj = 0; ///< allocations (operator new) per object
+};
+
+/// @brief Run the function until `minTime` is reached and compute the
+///        statistics.
+/// @param nbBytes Number of bytes processed by one run.
+/// @param run     Function the execute.
+inline Measure measure(size_t nbBytes, auto &&run) {
+    using clock = std::chrono::steady_clock;
+    size_t nbRuns = 0;
+
+    run(); // warmup (the buffers reach their final capacity here)
+
+    size_t allocations = nbAllocations;
+    auto start = clock::now();
+    std::chrono::duration<double> elapsed{};
+    do {
+        run();
+        ++nbRuns;
+        elapsed = clock::now() - start;
+    } while (elapsed.count() < minTime);
+    allocations = nbAllocations - allocations;
+
+    double secs = elapsed.count();
+    return Measure{
+        .mbps = (double)(nbBytes * nbRuns) / secs / 1e6,
+        .nsPerObj = secs * 1e9 / (double)nbRuns,
+        .allocsPerObj = (double)allocations / (double)nbRuns,
+    };
+}
+
+/// @brief Print the table header.
+inline void printHeader() {
+    std::printf("%-14s %-14s %-8s %10s | %10s %10s %8s | %10s %10s %8s\n",
+                "library", "workload", "payload", "bytes", "ser MB/s",
+                "ser ns", "ser alc", "des MB/s", "des ns", "des alc");
+    std::printf("%s\n", std::string(118, '-').c_str());
+}
+
+/// @brief Run and print the serialization and deserialization measurements.
+/// @param library  Name of the library.
+/// @param workload Name of the workload.
+/// @param payload  Size parameter of the workload.
+/// @param nbBytes  Function that returns the size of the serialized data
+///                 (called after the serialization).
+/// @param ser      Serialization function.
+/// @param des      Deserialization function.
+inline void run(char const *library, char const *workload, size_t payload,
+                auto &&ser, auto &&des, auto &&nbBytes) {
+    ser();
+    size_t bytes = nbBytes();
+    Measure s = measure(bytes, ser);
+    Measure d = measure(bytes, des);
+
+    std::printf("%-14s %-14s %-8zu %10zu | %10.1f %10.1f %8.2f | %10.1f "
+                "%10.1f %8.2f\n",
+                library, workload, payload, bytes, s.mbps, s.nsPerObj,
+                s.allocsPerObj, d.mbps, d.nsPerObj, d.allocsPerObj);
+}
+
+/// @brief Deterministic pseudo random values (same data for all libraries).
+inline int random(size_t i) { return (int)((i * 2654435761u) % 100000); }
+
+/******************************************************************************/
+/*                               serializer-cpp                               */
+/******************************************************************************/
+
+void benchSimple(size_t strSize) {
+    Simple origin(1, 2, std::string(strSize, 'x'));
+    Simple other;
+    serializer::Bytes buff;
+
+    run(
+        "serializer", "Simple", strSize, [&] { origin.serialize(buff); },
+        [&] {
+            other.deserialize(buff);
+            doNotOptimize(other);
+        },
+        [&] { return buff.size(); });
+}
+
+void fillContainer(WithContainer &obj, size_t nbElements) {
+    for (size_t i = 0; i < nbElements; ++i) {
+        obj.addInt(random(i));
+        obj.addDouble((double)random(i) / 3.0);
+        obj.addSimple(Simple(random(i), (int)i, "simple"));
+        if (i % 8 == 0) {
+            obj.addVec(std::vector<int>(8, random(i)));
+        }
+    }
+    for (size_t i = 0; i < 10; ++i) {
+        obj.addArr((int)i, random(i));
+        obj.addArrSimple((int)i, Simple((int)i, (int)i, "array"));
+    }
+}
+
+void benchContainer(size_t nbElements) {
+    WithContainer origin;
+    WithContainer other;
+    serializer::Bytes buff;
+
+    fillContainer(origin, nbElements);
+    run(
+        "serializer", "WithContainer", nbElements,
+        [&] { origin.serialize(buff); },
+        [&] {
+            other.deserialize(buff);
+            doNotOptimize(other);
+        },
+        [&] { return buff.size(); });
+}
+
+void benchTree(size_t nbNodes) {
+    Tree<int> origin;
+    serializer::Bytes buff;
+
+    for (size_t i = 0; i < nbNodes; ++i) {
+        origin.insert(random(i));
+    }
+    run(
+        "serializer", "Tree", nbNodes, [&] { origin.serialize(buff); },
+        [&] {
+            Tree<int> other; // the nodes are allocated during the
+                             // deserialization (destruction is measured too)
+            other.deserialize(buff);
+            doNotOptimize(other);
+        },
+        [&] { return buff.size(); });
+}
+
+void benchPolymorphic(size_t nbElements) {
+    SuperCollection origin;
+    serializer::Bytes buff;
+
+    for (size_t i = 0; i < nbElements; ++i) {
+        if (i % 2) {
+            origin.push_back(new Class1("class1", random(i), (int)i, 3.14));
+        } else {
+            origin.push_back(new Class2("class2", random(i), "str"));
+        }
+    }
+    run(
+        "serializer", "Polymorphic", nbElements,
+        [&] { origin.serialize(buff); },
+        [&] {
+            SuperCollection other;
+            other.deserialize(buff);
+            doNotOptimize(other);
+        },
+        [&] { return buff.size(); });
+}
+
+void benchMatrix(size_t size) {
+    std::vector<double> data(size * size);
+    Matrix<double> origin(size, size, 16, data.data());
+    serializer::Bytes buff;
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (double)random(i);
+    }
+    run(
+        "serializer", "Matrix", size, [&] { origin.serialize(buff); },
+        [&] {
+            Matrix<double> other;
+            other.deserialize(buff);
+            doNotOptimize(other);
+            delete[] other.data();
+        },
+        [&] { return buff.size(); });
+}
+
+void benchMatrixBlock(size_t size) {
+    std::vector<double> data(size * size);
+    MatrixBlock<double, Input> origin(0, 0, size, size, 16, data.size(),
+                                      data.data());
+    serializer::Bytes buff;
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (double)random(i);
+    }
+    run(
+        "serializer", "MatrixBlock", size, [&] { origin.serialize(buff); },
+        [&] {
+            MatrixBlock<double, Input> other;
+            other.deserialize(buff);
+            doNotOptimize(other);
+            delete[] other.data();
+        },
+        [&] { return buff.size(); });
+}
+
+/******************************************************************************/
+/*                                  zpp_bits                                  */
+/******************************************************************************/
+
+#ifdef SERIALIZER_BENCH_ZPP_BITS
+namespace zpp_mirror {
+
+struct Simple {
+    int x;
+    int y;
+    std::string str;
+};
+
+struct Container {
+    std::vector<int> emptyVec;
+    std::vector<int> vec;
+    std::list<double> lst;
+    std::vector<Simple> classVec;
+    std::vector<std::vector<int>> vec2D;
+    std::array<int, 10> arr;
+    std::array<Simple, 10> arrSimple;
+};
+
+struct Node {
+    int value;
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+};
+
+struct Matrix {
+    unsigned int id;
+    size_t width, height, blockSize, nbRawBlocks, nbColBlocks;
+    std::vector<double> data;
+};
+
+} // end namespace zpp_mirror
+
+template <typename T>
+void benchZppBits(char const *workload, size_t payload, T const &origin) {
+    std::vector<std::byte> buff;
+
+    run(
+        "zpp_bits", workload, payload,
+        [&] {
+            buff.clear();
+            zpp::bits::out out(buff);
+            (void)out(origin);
+        },
+        [&] {
+            T other{};
+            zpp::bits::in in(buff);
+            (void)in(other);
+            doNotOptimize(other);
+        },
+        [&] { return buff.size(); });
+}
+#endif
+
+/******************************************************************************/
+/*                                   cereal                                   */
+/******************************************************************************/
+
+#ifdef SERIALIZER_BENCH_CEREAL
+namespace cereal_mirror {
+
+struct Simple {
+    int x;
+    int y;
+    std::string str;
+    template <class Archive> void serialize(Archive &ar) { ar(x, y, str); }
+};
+
+struct Container {
+    std::vector<int> emptyVec;
+    std::vector<int> vec;
+    std::list<double> lst;
+    std::vector<Simple> classVec;
+    std::vector<std::vector<int>> vec2D;
+    std::array<int, 10> arr;
+    std::array<Simple, 10> arrSimple;
+    template <class Archive> void serialize(Archive &ar) {
+        ar(emptyVec, vec, lst, classVec, vec2D, arr, arrSimple);
+    }
+};
+
+struct Node {
+    int value;
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+    template <class Archive> void serialize(Archive &ar) {
+        ar(value, left, right);
+    }
+};
+
+struct Matrix {
+    unsigned int id;
+    size_t width, height, blockSize, nbRawBlocks, nbColBlocks;
+    std::vector<double> data;
+    template <class Archive> void serialize(Archive &ar) {
+        ar(id, width, height, blockSize, nbRawBlocks, nbColBlocks, data);
+    }
+};
+
+} // end namespace cereal_mirror
+
+template <typename T>
+void benchCereal(char const *workload, size_t payload, T const &origin) {
+    std::string buff;
+
+    run(
+        "cereal", workload, payload,
+        [&] {
+            std::ostringstream oss(std::move(buff));
+            {
+                cereal::BinaryOutputArchive ar(oss);
+                ar(origin);
+            }
+            buff = std::move(oss).str();
+        },
+        [&] {
+            T other{};
+            std::istringstream iss(buff);
+            cereal::BinaryInputArchive ar(iss);
+            ar(other);
+            doNotOptimize(other);
+        },
+        [&] { return buff.size(); });
+}
+#endif
+
+/******************************************************************************/
+/*                                   cista                                    */
+/******************************************************************************/
+
+#ifdef SERIALIZER_BENCH_CISTA
+namespace cista_mirror {
+
+namespace data = cista::offset;
+
+struct Simple {
+    int x;
+    int y;
+    data::string str;
+};
+
+struct Container {
+    data::vector<int> emptyVec;
+    data::vector<int> vec;
+    data::vector<double> lst; // cista has no list
+    data::vector<Simple> classVec;
+    data::vector<data::vector<int>> vec2D;
+    data::array<int, 10> arr;
+    data::array<Simple, 10> arrSimple;
+};
+
+struct Node {
+    int value;
+    data::unique_ptr<Node> left;
+    data::unique_ptr<Node> right;
+};
+
+struct Matrix {
+    unsigned int id;
+    size_t width, height, blockSize, nbRawBlocks, nbColBlocks;
+    data::vector<double> data;
+};
+
+} // end namespace cista_mirror
+
+template <typename T>
+void benchCista(char const *workload, size_t payload, T const &origin) {
+    std::vector<unsigned char> buff;
+
+    run(
+        "cista", workload, payload, [&] { buff = cista::serialize(origin); },
+        [&] {
+            // cista deserializes in place (no copy of the data)
+            auto other = cista::deserialize<T>(buff);
+            doNotOptimize(other);
+        },
+        [&] { return buff.size(); });
+}
+#endif
+
+/******************************************************************************/
+/*                          alternatives workloads                            */
+/******************************************************************************/
+
+/// @brief Build the mirror types of the test classes for a given library (the
+///        mirror types have the same members as the test classes).
+template <typename Simple, typename Container, typename Node, typename Matrix>
+struct Mirror {
+    static Simple simple(size_t strSize) {
+        Simple s{};
+        s.x = 1;
+        s.y = 2;
+        s.str = std::string(strSize, 'x');
+        return s;
+    }
+
+    static Container container(size_t nbElements) {
+        Container c{};
+        for (size_t i = 0; i < nbElements; ++i) {
+            c.vec.push_back(random(i));
+            c.lst.push_back((double)random(i) / 3.0);
+            c.classVec.push_back(Simple{random(i), (int)i, "simple"});
+            if (i % 8 == 0) {
+                c.vec2D.emplace_back(8, random(i));
+            }
+        }
+        for (size_t i = 0; i < 10; ++i) {
+            c.arr[i] = random(i);
+            c.arrSimple[i] = Simple{(int)i, (int)i, "array"};
+        }
+        return c;
+    }
+
+    static auto tree(size_t nbNodes) {
+        decltype(Node::left) root;
+        for (size_t i = 0; i < nbNodes; ++i) {
+            auto *curr = &root;
+            int value = random(i);
+            while (*curr) {
+                curr = (*curr)->value < value ? &(*curr)->left
+                                              : &(*curr)->right;
+            }
+            *curr = decltype(root)(new Node{value, {}, {}});
+        }
+        return root;
+    }
+
+    static Matrix matrix(size_t size) {
+        Matrix m{};
+        m.width = m.height = size;
+        m.blockSize = 16;
+        m.nbRawBlocks = m.nbColBlocks = size / 16 + (size % 16 == 0 ? 0 : 1);
+        for (size_t i = 0; i < size * size; ++i) {
+            m.data.push_back((double)random(i));
+        }
+        return m;
+    }
+};
+
+/******************************************************************************/
+/*                                    main                                    */
+/******************************************************************************/
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        minTime = std::atof(argv[1]);
+    }
+
+    printHeader();
+
+    for (size_t size : {8, 256, 4096}) {
+        benchSimple(size);
+    }
+    for (size_t size : {10, 1000, 100000}) {
+        benchContainer(size);
+    }
+    for (size_t size : {10, 1000, 100000}) {
+        benchTree(size);
+    }
+    for (size_t size : {10, 1000, 100000}) {
+        benchPolymorphic(size);
+    }
+    for (size_t size : {16, 256, 2048}) {
+        benchMatrix(size);
+    }
+    for (size_t size : {16, 256, 2048}) {
+        benchMatrixBlock(size);
+    }
+
+#ifdef SERIALIZER_BENCH_ZPP_BITS
+    using ZppMirror = Mirror<zpp_mirror::Simple, zpp_mirror::Container,
+                             zpp_mirror::Node, zpp_mirror::Matrix>;
+    for (size_t size : {8, 256, 4096}) {
+        benchZppBits("Simple", size, ZppMirror::simple(size));
+    }
+    for (size_t size : {10, 1000, 100000}) {
+        benchZppBits("WithContainer", size, ZppMirror::container(size));
+    }
+    for (size_t size : {10, 1000, 100000}) {
+        benchZppBits("Tree", size, ZppMirror::tree(size));
+    }
+    for (size_t size : {16, 256, 2048}) {
+        benchZppBits("Matrix", size, ZppMirror::matrix(size));
+    }
+#endif
+
+#ifdef SERIALIZER_BENCH_CEREAL
+    using CerealMirror =
+        Mirror<cereal_mirror::Simple, cereal_mirror::Container,
+               cereal_mirror::Node, cereal_mirror::Matrix>;
+    for (size_t size : {8, 256, 4096}) {
+        benchCereal("Simple", size, CerealMirror::simple(size));
+    }
+    for (size_t size : {10, 1000, 100000}) {
+        benchCereal("WithContainer", size, CerealMirror::container(size));
+    }
+    for (size_t size : {10, 1000, 100000}) {
+        benchCereal("Tree", size, CerealMirror::tree(size));
+    }
+    for (size_t size : {16, 256, 2048}) {
+        benchCereal("Matrix", size, CerealMirror::matrix(size));
+    }
+#endif
+
+#ifdef SERIALIZER_BENCH_CISTA
+    using CistaMirror = Mirror<cista_mirror::Simple, cista_mirror::Container,
+                               cista_mirror::Node, cista_mirror::Matrix>;
+    for (size_t size : {8, 256, 4096}) {
+        benchCista("Simple", size, CistaMirror::simple(size));
+    }
+    for (size_t size : {10, 1000, 100000}) {
+        benchCista("WithContainer", size, CistaMirror::container(size));
+    }
+    for (size_t size : {16, 256, 2048}) {
+        benchCista("Matrix", size, CistaMirror::matrix(size));
+    }
+#endif
+
+    return 0;
+}
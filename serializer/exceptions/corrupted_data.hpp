@@ -0,0 +1,27 @@
+#ifndef SERIALIZER_CORRUPTED_DATA_ERROR_HPP
+#define SERIALIZER_CORRUPTED_DATA_ERROR_HPP
+#include <exception>
+#include <string>
+#include <utility>
+
+/// @brief namespace serializer exception
+namespace serializer::exceptions {
+
+/// @brief Exception thrown by the verified deserialization when the data is
+///        truncated, when a size overflows the buffer or when the checksum
+///        doesn't match.
+class CorruptedDataError : public std::exception {
+  public:
+    /// @brief Constructor
+    explicit CorruptedDataError(std::string msg) : msg(std::move(msg)) {}
+
+    /// @brief what
+    const char *what() const noexcept override { return msg.c_str(); }
+
+  private:
+    std::string msg; ///< message for what.
+};
+
+} // namespace serializer::exceptions
+
+#endif
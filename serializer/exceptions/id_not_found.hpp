@@ -13,7 +13,8 @@ class IdNotFoundError : public std::exception {
     /// @brief Constructor
     IdNotFoundError(auto id) {
         std::ostringstream oss;
-        oss << "error: the identifier '" << id
+        // the unary plus prints the 1 byte ids as numbers
+        oss << "error: the identifier '" << +id
             << "' was not found in the given type table.";
         msg = oss.str();
     }
@@ -1,6 +1,9 @@
 #ifndef SERIALIZER_CONCEPTS_H
 #define SERIALIZER_CONCEPTS_H
+#include "../serializer/serialize.hpp"
 #include "type_check.hpp"
+#include <bit>
+#include <concepts>
 
 /// @brief namespace serializer concepts
 namespace serializer::concepts {
@@ -15,6 +18,10 @@ template <typename T, typename MemT>
 concept Deserializable =
     requires(mtf::clean_t<T> obj, MemT &mem) { obj.deserialize(mem, 0); };
 
+/// @brief Types that have a serializer::Codec specialization.
+template <typename T>
+concept HasCodec = requires { sizeof(serializer::Codec<mtf::clean_t<T>>); };
+
 /// @brief Smart pointers.
 template <typename T>
 concept SmartPtr = mtf::is_smart_ptr_v<T>;
@@ -40,10 +47,30 @@ concept StaticArray = std::is_array_v<mtf::clean_t<T>>;
 template <typename T>
 concept Array = mtf::is_std_array_v<T>;
 
+/// @brief Views on contiguous memory (std::string_view and std::span). They are
+///        serialized like the containers they refer to.
+template <typename T>
+concept View = mtf::is_string_view_v<T> || mtf::is_span_v<T>;
+
+/// @brief Multi-dimensional views (std::mdspan). Only the elements are
+///        serialized (the extents and the layout are given by the view).
+template <typename T>
+concept MdSpan = mtf::is_mdspan_v<T>;
+
+/// @brief Match std::optional (serialized as a flag followed by the value).
+template <typename T>
+concept Optional = mtf::is_optional_v<T>;
+
+/// @brief Match std::variant (serialized as the index of the active
+///        alternative followed by its value).
+template <typename T>
+concept Variant = mtf::is_variant_v<T>;
+
 /// @brief Trivial types that can be cast directly
 template <typename T>
 concept Trivial =
     !std::is_pointer_v<mtf::clean_t<T>> && !Array<T> && !StaticArray<T> &&
+    !View<T> && !MdSpan<T> && !Optional<T> && !Variant<T> &&
     std::is_copy_assignable_v<mtf::clean_t<T>> &&
     std::is_trivially_copyable_v<mtf::clean_t<T>>;
 
@@ -55,6 +82,11 @@ concept Enum = std::is_enum_v<mtf::clean_t<T>>;
 template <typename T>
 concept String = mtf::is_string_v<T>;
 
+/// @brief Strings and string views (stored in the dictionary of the interned
+///        memories).
+template <typename T>
+concept InternableString = String<T> || mtf::is_string_view_v<T>;
+
 /// @brief Iterable types.
 template <typename T>
 concept Iterable = requires { typename mtf::clean_t<T>::iterator; };
@@ -98,6 +130,104 @@ concept IdType = requires(T id) {
     id = 0;
 };
 
+/// @brief Memory buffers that manage the appends themselves (tools::Bytes,
+///        tools::Measure, ...). The size is always equal to `pos + nbBytes`
+///        after an append.
+template <typename MemT>
+concept Appendable = requires(mtf::clean_t<MemT> mem,
+                              mtf::byte_type_t<MemT> const *bytes) {
+    mem.append(size_t(0), bytes, size_t(0));
+};
+
+/// @brief Memory buffers which bytes can be modified through data().
+template <typename MemT>
+concept DataAccessible = requires(mtf::clean_t<MemT> mem) { mem.data(); };
+
+/// @brief Memory buffers that only measure the serialized size (tools::Measure,
+///        nothing is stored).
+template <typename MemT>
+concept MeasuresOnly =
+    requires { requires mtf::clean_t<MemT>::measures_only; };
+
+/// @brief Memory buffers that are not entirely accessible through data() (ex:
+///        streams). `fetch(pos, n)` gives access to the n bytes at pos and
+///        `read(pos, dest, n)` copies them into dest.
+template <typename MemT>
+concept Fetchable = requires(mtf::clean_t<MemT> mem,
+                             mtf::byte_type_t<MemT> *bytes) {
+    { mem.fetch(size_t(0), size_t(0)) };
+    mem.read(size_t(0), bytes, size_t(0));
+};
+
+/// @brief Memory buffers that can reference the large blocks of the
+///        serialized objects instead of copying them (tools::ScatterGather).
+template <typename MemT>
+concept ReferencesBlocks = requires(mtf::clean_t<MemT> mem,
+                                    mtf::byte_type_t<MemT> const *bytes) {
+    mem.appendExternal(size_t(0), bytes, size_t(0));
+};
+
+/// @brief Memory buffers that provide an allocator for the objects created
+///        during the deserialization (ex: tools::WithArena).
+template <typename MemT>
+concept HasArena = requires(mtf::clean_t<MemT> mem) { mem.arena(); };
+
+/// @brief Memory buffers that serialize the objects shared by several pointers
+///        only once (tools::Tracked).
+template <typename MemT>
+concept TracksObjects = requires(mtf::clean_t<MemT> mem) { mem.objects(); };
+
+/// @brief Memory buffers that serialize each distinct string only once
+///        (tools::Interned).
+template <typename MemT>
+concept InternsStrings = requires(mtf::clean_t<MemT> mem) { mem.strings(); };
+
+/// @brief Memory buffers that keep the existing pointees of the destination
+///        during the deserialization (tools::Reuse).
+template <typename MemT>
+concept ReusesObjects =
+    requires { requires mtf::clean_t<MemT>::reuse_objects; };
+
+/// @brief Memory buffers that use varints for the sizes (tools::Compact).
+template <typename MemT>
+concept CompactSizes =
+    requires { requires mtf::clean_t<MemT>::compact_sizes; };
+
+/// @brief Memory buffers that use varints for the integers (tools::Compact).
+template <typename MemT>
+concept CompactIntegers =
+    requires { requires mtf::clean_t<MemT>::compact_integers; };
+
+/// @brief Memory buffers that serialize the large containers with several
+///        threads (tools::Parallel).
+template <typename MemT>
+concept ParallelContainers =
+    requires { requires mtf::clean_t<MemT>::parallel_containers; };
+
+/// @brief Memory buffers that check the bounds of the reads and of the sizes
+///        during the deserialization (tools::Verified).
+template <typename MemT>
+concept BoundsChecked =
+    requires { requires mtf::clean_t<MemT>::bounds_checked; };
+
+/// @brief Memory buffers that fix the byte order of the data (tools::Endian).
+template <typename MemT>
+concept FixedByteOrder = requires {
+    { mtf::clean_t<MemT>::byte_order } -> std::convertible_to<std::endian>;
+};
+
+/// @brief Memory buffers that are notified of the members of the serialized
+///        objects (tools::MemberRecorder and tools::MemberSelector).
+template <typename MemT>
+concept TracksMembers =
+    requires { requires mtf::clean_t<MemT>::track_members; };
+
+/// @brief Memory buffers that record the cost of the serialization per type
+///        (tools::Instrumented).
+template <typename MemT>
+concept Instrumented =
+    requires(mtf::clean_t<MemT> mem) { mem.instrumentation(); };
+
 /* unsupported types */
 
 /// @brief Used to detect the types for which we do not have an automatic
@@ -105,14 +235,16 @@ concept IdType = requires(T id) {
 template <typename T>
 concept AutoSerializationSupported =
     SmartPtr<T> || Pointer<T> || Trivial<T> || Enum<T> || String<T> ||
-    Iterable<T> || TupleLike<T> || StaticArray<T>;
+    Iterable<T> || TupleLike<T> || StaticArray<T> || MdSpan<T> ||
+    Optional<T> || Variant<T>;
 
 /// @brief Used to detect the types for which we do not have an automatic
 ///        deserialization function.
 template <typename T>
 concept AutoDeserializationSupported =
     ConcreteSmartPtr<T> || ConcretePtr<T> || Trivial<T> || Enum<T> ||
-    String<T> || Iterable<T> || TupleLike<T> || StaticArray<T>;
+    String<T> || Iterable<T> || TupleLike<T> || StaticArray<T> || MdSpan<T> ||
+    Optional<T> || Variant<T>;
 
 /// @brief Detect if a type is serializable.
 template <typename T, typename MemT>
@@ -1,9 +1,12 @@
 #ifndef SERIALIZER_SERIALIZER_META_H
 #define SERIALIZER_SERIALIZER_META_H
+#include "../tools/columnar.hpp"
 #include "../tools/dynamic_array.hpp"
+#include "../tools/numeric_codecs.hpp"
 #include "concepts.hpp"
 #include "type_check.hpp"
 #include "type_transform.hpp"
+#include <type_traits>
 
 /// @file This file contains concepts and metafunctions used only in the
 ///       serializer (avoid recursive includes)
@@ -24,40 +27,107 @@ struct is_dynamic_array<tools::DynamicArray<T, Sizes...>> : std::true_type {};
 template <typename T>
 constexpr bool is_dynamic_array_v = is_dynamic_array<clean_t<T>>::value;
 
+/// @brief True if T is a ContiguousArray, false otherwise
+template <typename T> struct is_contiguous_array : std::false_type {};
+
+template <typename T, typename... Sizes>
+struct is_contiguous_array<tools::ContiguousArray<T, Sizes...>>
+    : std::true_type {};
+
+/// @brief True if T is a ContiguousArray, false otherwise
+template <typename T>
+constexpr bool is_contiguous_array_v = is_contiguous_array<clean_t<T>>::value;
+
+/// @brief True if T is a StridedArray, false otherwise
+template <typename T> struct is_strided_array : std::false_type {};
+
+template <typename T, typename RT, typename CT, typename ST>
+struct is_strided_array<tools::StridedArray<T, RT, CT, ST>>
+    : std::true_type {};
+
+/// @brief True if T is a StridedArray, false otherwise
+template <typename T>
+constexpr bool is_strided_array_v = is_strided_array<clean_t<T>>::value;
+
+/// @brief True if T is an Encoded wrapper, false otherwise
+template <typename T> struct is_encoded : std::false_type {};
+
+template <typename Codec, typename Data>
+struct is_encoded<tools::Encoded<Codec, Data>> : std::true_type {};
+
+/// @brief True if T is an Encoded wrapper, false otherwise
+template <typename T>
+constexpr bool is_encoded_v = is_encoded<clean_t<T>>::value;
+
+/// @brief True if T is a Columnar wrapper, false otherwise
+template <typename T> struct is_columnar : std::false_type {};
+
+template <typename C>
+struct is_columnar<tools::Columnar<C>> : std::true_type {};
+
+/// @brief True if T is a Columnar wrapper, false otherwise
+template <typename T>
+constexpr bool is_columnar_v = is_columnar<clean_t<T>>::value;
+
+/// @brief True if the serialize method of T copies the bytes of the object
+///        (SERIALIZE_STRUCT). It can be specialized for the other types which
+///        serialize functions are equivalent to a bit copy.
+template <typename T>
+struct is_bitwise_serializable
+    : std::bool_constant<requires { requires T::bitwise_serializable; }> {};
+
+/// @brief True if the serialize method of T copies the bytes of the object.
+template <typename T>
+constexpr bool is_bitwise_serializable_v =
+    is_bitwise_serializable<clean_t<T>>::value;
+
 } // end namespace mtf
 
 /// @brief namespace concepts
 namespace concepts {
 
+/// @brief Types which serialized form is a copy of their bytes.
+template <typename T>
+concept BitwiseSerializable =
+    std::is_trivially_copyable_v<mtf::clean_t<T>> &&
+    mtf::is_bitwise_serializable_v<T>;
+
 /// @brief Types that are not serialized automatically (custom serializer /
 ///        error).
 template <typename T, typename MemT, typename... AdditionalTypes>
 concept NonAutomaticSerialize =
-    mtf::contains_v<T, AdditionalTypes...> ||
-    (concepts::NonSerializable<T, MemT> && !mtf::is_dynamic_array_v<T>);
+    mtf::contains_v<T, AdditionalTypes...> || concepts::HasCodec<T> ||
+    (concepts::NonSerializable<T, MemT> && !mtf::is_dynamic_array_v<T> &&
+     !mtf::is_contiguous_array_v<T> && !mtf::is_strided_array_v<T> &&
+     !mtf::is_encoded_v<T> && !mtf::is_columnar_v<T>);
 
 /// @brief Types that are not deserialized automatically (custom serializer /
 ///        error).
 template <typename T, typename MemT, typename... AdditionalTypes>
 concept NonAutomaticDeserialize =
-    mtf::contains_v<T, AdditionalTypes...> ||
-    (concepts::NonDeserializable<T, MemT> && !mtf::is_dynamic_array_v<T>);
+    mtf::contains_v<T, AdditionalTypes...> || concepts::HasCodec<T> ||
+    (concepts::NonDeserializable<T, MemT> && !mtf::is_dynamic_array_v<T> &&
+     !mtf::is_contiguous_array_v<T> && !mtf::is_strided_array_v<T> &&
+     !mtf::is_encoded_v<T> && !mtf::is_columnar_v<T>);
 
 /// @brief Types that use a serialize method
 template <typename T, typename MemT, typename... AdditionalTypes>
-concept UseSerialize =
-    concepts::Serializable<T, MemT> && !mtf::contains_v<T, AdditionalTypes...>;
+concept UseSerialize = concepts::Serializable<T, MemT> &&
+                       !mtf::contains_v<T, AdditionalTypes...> &&
+                       !concepts::HasCodec<T>;
 
 /// @brief Types that use a deserialize method
 template <typename T, typename MemT, typename... AdditionalTypes>
 concept UseDeserialize = serializer::concepts::Deserializable<T, MemT> &&
-                         !mtf::contains_v<T, AdditionalTypes...>;
+                         !mtf::contains_v<T, AdditionalTypes...> &&
+                         !concepts::HasCodec<T>;
 
 /// @brief Container types that are contiguous and stored a trivial type
 template <typename T, typename MemT>
 concept ContiguousTrivial =
     std::contiguous_iterator<typename mtf::clean_t<T>::iterator> &&
     concepts::Trivial<mtf::remove_const_t<mtf::iter_value_t<mtf::clean_t<T>>>> &&
+    !concepts::HasCodec<mtf::iter_value_t<mtf::clean_t<T>>> &&
     !concepts::Serializable<
         mtf::remove_const_t<mtf::iter_value_t<mtf::clean_t<T>>>, MemT>;
 
@@ -66,6 +136,7 @@ template <typename T, typename MemT>
 concept TrivialySerializableStaticArray =
     !std::is_array_v<std::remove_extent_t<mtf::clean_t<T>>> &&
     concepts::Trivial<std::remove_extent_t<mtf::clean_t<T>>> &&
+    !concepts::HasCodec<std::remove_extent_t<mtf::clean_t<T>>> &&
     !concepts::Serializable<std::remove_extent_t<mtf::clean_t<T>>, MemT>;
 
 /// @brief Trivialy deserializable static arrays
@@ -73,6 +144,7 @@ template <typename T, typename MemT>
 concept TrivialyDeserializableStaticArray =
     !std::is_array_v<std::remove_extent_t<mtf::clean_t<T>>> &&
     concepts::Trivial<std::remove_extent_t<mtf::clean_t<T>>> &&
+    !concepts::HasCodec<std::remove_extent_t<mtf::clean_t<T>>> &&
     !concepts::Deserializable<std::remove_extent_t<mtf::clean_t<T>>, MemT>;
 
 } // end namespace concepts
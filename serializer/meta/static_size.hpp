@@ -0,0 +1,129 @@
+#ifndef SERIALIZER_STATIC_SIZE_H
+#define SERIALIZER_STATIC_SIZE_H
+#include "../tools/type_table.hpp"
+#include "concepts.hpp"
+#include "type_check.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// @brief namespace serializer
+namespace serializer {
+
+/// @brief namespace meta-functions
+namespace mtf {
+
+/// @brief Value of static_serialized_size_v for the types which serialized size
+///        depends on their value (strings, containers, pointers, ...).
+inline constexpr size_t dynamic_size = size_t(-1);
+
+/// @brief Implementation of static_serialized_size_v.
+namespace static_size_impl {
+
+/// @brief Memory used to detect the custom serialize functions.
+using memory_type = std::array<std::byte, 1>;
+
+template <typename T> constexpr size_t staticSize();
+
+/// @brief Size of the id serialized by the methods of T before its members.
+template <typename T> constexpr size_t idSize() {
+    using Type = clean_t<T>;
+
+    if constexpr (requires { typename Type::polymorphic_type_table; }) {
+        using Table = typename Type::polymorphic_type_table;
+        return tools::has_type_v<Type, Table> ? sizeof(typename Table::id_type)
+                                              : 0;
+    } else {
+        return 0;
+    }
+}
+
+/// @brief Sum of the sizes of the elements of a tuple.
+template <typename Tuple, size_t... Idx>
+constexpr size_t sumSizes(std::index_sequence<Idx...>) {
+    constexpr std::array<size_t, sizeof...(Idx)> sizes = {
+        staticSize<std::tuple_element_t<Idx, Tuple>>()...};
+    size_t result = 0;
+    for (size_t size : sizes) {
+        if (size == dynamic_size) {
+            return dynamic_size;
+        }
+        result += size;
+    }
+    return result;
+}
+
+/// @brief Compute the serialized size of T (follow the serializer rules).
+template <typename T> constexpr size_t staticSize() {
+    using Type = clean_t<T>;
+
+    if constexpr (requires(Type &obj) { obj.serializedMembers(); }) {
+        using Members = decltype(std::declval<Type &>().serializedMembers());
+        constexpr size_t nb_members = std::tuple_size_v<Members>;
+        constexpr size_t size =
+            sumSizes<Members>(std::make_index_sequence<nb_members>());
+        if constexpr (size == dynamic_size) {
+            return dynamic_size;
+        } else if constexpr (requires { requires Type::serialized_with_index; }) {
+            // number of members and offset table (see serializeWithIndex)
+            return sizeof(uint32_t) * (nb_members + 1) + size;
+        } else {
+            return idSize<Type>() + size;
+        }
+    } else if constexpr (concepts::Serializable<Type, memory_type> ||
+                         concepts::HasCodec<Type>) {
+        return dynamic_size; // custom serialize function
+    } else if constexpr (concepts::Trivial<Type>) {
+        return sizeof(Type);
+    } else if constexpr (concepts::StaticArray<Type>) {
+        constexpr size_t size = staticSize<std::remove_extent_t<Type>>();
+        return size == dynamic_size ? dynamic_size
+                                    : size * std::extent_v<Type>;
+    } else if constexpr (concepts::Array<Type>) {
+        constexpr size_t size = staticSize<typename Type::value_type>();
+        return size == dynamic_size
+                   ? dynamic_size
+                   : sizeof(size_t) + size * std::tuple_size_v<Type>;
+    } else if constexpr (concepts::TupleLike<Type>) {
+        return sumSizes<Type>(
+            std::make_index_sequence<std::tuple_size_v<Type>>());
+    } else {
+        return dynamic_size;
+    }
+}
+
+} // end namespace static_size_impl
+
+/// @brief Size of the id that the methods of T serialize before its members
+///        (the SERIALIZE_POLYMORPHIC types write the id of their type table
+///        whatever the serializer).
+template <typename T>
+constexpr size_t polymorphic_id_size_v = static_size_impl::idSize<T>();
+
+/// @brief Number of bytes of the serialized T if it doesn't depend on the
+///        value, dynamic_size otherwise. The size is derived from the
+///        SERIALIZE members (the types that define a custom serialize function
+///        are dynamic, the SERIALIZE_INDEXED ones include their offset table
+///        and the SERIALIZE_POLYMORPHIC ones their id) and corresponds to the
+///        layout of the default serializer (no other ids, no compact memory).
+template <typename T>
+constexpr size_t static_serialized_size_v =
+    static_size_impl::staticSize<T>();
+
+} // end namespace mtf
+
+/// @brief namespace concepts
+namespace concepts {
+
+/// @brief Types which serialized size is known at compile time.
+template <typename T>
+concept FixedSize = mtf::static_serialized_size_v<T> != mtf::dynamic_size;
+
+} // end namespace concepts
+
+} // end namespace serializer
+
+#endif
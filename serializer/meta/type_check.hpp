@@ -2,8 +2,18 @@
 #define SERIALIZER_TYPE_CHECK_H
 #include "../tools/bytes.hpp"
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <variant>
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_mdspan)
+#include <mdspan>
+#endif
 
 /// @brief serializer meta-functions namespace
 namespace serializer::mtf {
@@ -23,6 +33,51 @@ constexpr bool is_concrete_ptr_v =
 template <typename T>
 constexpr bool is_string_v = std::is_same_v<clean_t<T>, std::string>;
 
+/// @brief Check if a type T is a string view / const string view.
+template <typename T>
+constexpr bool is_string_view_v = std::is_same_v<clean_t<T>, std::string_view>;
+
+/* spans **********************************************************************/
+
+/// @brief Checks if a type S is a std::span
+template <typename S> struct is_span : std::false_type {};
+
+template <typename T, size_t Extent>
+struct is_span<std::span<T, Extent>> : std::true_type {};
+
+template <typename S> constexpr bool is_span_v = is_span<clean_t<S>>::value;
+
+/// @brief Checks if a type S is a std::mdspan (always false when the standard
+///        library doesn't provide mdspan).
+template <typename S> struct is_mdspan : std::false_type {};
+
+#if defined(__cpp_lib_mdspan)
+template <typename T, typename E, typename L, typename A>
+struct is_mdspan<std::mdspan<T, E, L, A>> : std::true_type {};
+#endif
+
+template <typename S>
+constexpr bool is_mdspan_v = is_mdspan<clean_t<S>>::value;
+
+/* optionals & variants *******************************************************/
+
+/// @brief Checks if a type O is a std::optional
+template <typename O> struct is_optional : std::false_type {};
+
+template <typename T> struct is_optional<std::optional<T>> : std::true_type {};
+
+template <typename O>
+constexpr bool is_optional_v = is_optional<clean_t<O>>::value;
+
+/// @brief Checks if a type V is a std::variant
+template <typename V> struct is_variant : std::false_type {};
+
+template <typename... Ts>
+struct is_variant<std::variant<Ts...>> : std::true_type {};
+
+template <typename V>
+constexpr bool is_variant_v = is_variant<clean_t<V>>::value;
+
 /* shared pointers ************************************************************/
 
 /// @brief Checks if a type SP is a shared_ptr
@@ -61,13 +116,28 @@ constexpr bool is_std_array_v = is_std_array<clean_t<T>>::value;
 /// @brief True if T is a serializer Bytes
 template <typename T> struct is_serializer_bytes : std::false_type {};
 
-template <typename T>
-struct is_serializer_bytes<serializer::tools::Bytes<T>> : std::true_type {};
+template <typename T, size_t N>
+struct is_serializer_bytes<serializer::tools::Bytes<T, N>> : std::true_type {};
 
 /// @brief True if T is a serializer Bytes
 template <typename T>
 constexpr bool is_serializer_bytes_v = is_serializer_bytes<clean_t<T>>::value;
 
+/// @brief Get the byte type of a memory buffer: `MemT::byte_type` when it is
+///        defined, the type returned by `operator[]` otherwise.
+template <typename MemT> struct byte_type {
+    using type = std::remove_cvref_t<decltype(std::declval<MemT &>()[0])>;
+};
+
+template <typename MemT>
+    requires requires { typename clean_t<MemT>::byte_type; }
+struct byte_type<MemT> {
+    using type = typename clean_t<MemT>::byte_type;
+};
+
+/// @brief Get the byte type of a memory buffer.
+template <typename MemT> using byte_type_t = typename byte_type<MemT>::type;
+
 /// @brief get the element type
 template <typename T>
 using element_type_t = typename mtf::clean_t<T>::element_type;
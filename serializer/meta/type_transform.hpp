@@ -3,6 +3,7 @@
 #include "concepts.hpp"
 #include <array>
 #include <cstddef>
+#include <iterator>
 #include <type_traits>
 
 /// @brief serializer meta-functions namespace
@@ -10,9 +11,12 @@ namespace serializer::mtf {
 
 /// @brief Allow easy access to the type of the elements_ in a members_.
 ///        We don't use value_type directly in case of a not well implemented
-///        members_. Though, we assume that the iterator respects the standard.
+///        members_. Though, we assume that the iterator respects the standard
+///        (std::iterator_traits also handles the pointers used as iterators,
+///        ex: std::string_view).
 template <typename T> struct iter_value {
-    using type = typename clean_t<T>::iterator::value_type;
+    using iterator = typename clean_t<T>::iterator;
+    using type = typename std::iterator_traits<iterator>::value_type;
 };
 
 /// @brief Specific case for std::array (it is iterable using pointers and not
@@ -1,8 +1,21 @@
 #ifndef SERIALIZER_SERIALIZE_H
 #define SERIALIZER_SERIALIZE_H
 #include "meta/concepts.hpp"
+#include "meta/static_size.hpp"
 #include "serializer/serializer.hpp"
+#include "exceptions/corrupted_data.hpp"
 #include "tools/context.hpp"
+#include "tools/crc32c.hpp"
+#include "tools/endian.hpp"
+#include "tools/measure.hpp"
+#include "tools/unchecked.hpp"
+#include "tools/verified.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <functional>
 
 /// @brief serializer namespace
 namespace serializer {
@@ -12,6 +25,7 @@ namespace serializer {
 /******************************************************************************/
 
 /// @brief Serialize the arguments into the memory buffer at the given position.
+///        Consecutive trivial arguments are packed into a single append.
 /// @tparam Ser Serializer type.
 /// @param mem  Buffer in which the serialized data will be stored.
 /// @param pos  Start position in the buffer for serializing the data.
@@ -23,17 +37,14 @@ inline constexpr size_t serialize(auto &mem, size_t pos, auto &&...args) {
     [[maybe_unused]] bool first_level = pos == 0;
 
     Ser serializer(mem, pos);
-    (
-        [&serializer, &args] {
-            if constexpr (SerializerFunction(args, serializer)) {
-                args(tools::Context<tools::Phases::Serialization,
-                                    decltype(serializer)>(serializer));
-            } else {
-                serializer.serialize_(args);
-            }
-        }(),
-        ...);
-    if constexpr (!mtf::is_serializer_bytes_v<mem_t> &&
+    if constexpr (concepts::TracksMembers<mem_t>) {
+        mem.enter(pos);
+    }
+    tools::serializeArgs<0>(serializer, std::forward_as_tuple(args...));
+    if constexpr (concepts::TracksMembers<mem_t>) {
+        mem.leave();
+    }
+    if constexpr (!concepts::Appendable<mem_t> &&
                   concepts::Resizeable<mem_t>) {
         if (first_level) [[unlikely]] {
             mem.resize(serializer.pos);
@@ -43,7 +54,7 @@ inline constexpr size_t serialize(auto &mem, size_t pos, auto &&...args) {
 }
 
 /// @brief Deserialize the arguments from the memory buffer at the given
-///        position.
+///        position. Consecutive trivial arguments are read at once.
 /// @tparam Ser Serializer type.
 /// @param mem  Buffer in which the serialized data is be stored.
 /// @param pos  Start position in the buffer for deserializing the data.
@@ -52,19 +63,172 @@ inline constexpr size_t serialize(auto &mem, size_t pos, auto &&...args) {
 template <typename Ser>
 inline constexpr size_t deserialize(auto &mem, size_t pos, auto &&...args) {
     Ser serializer(mem, pos);
-    (
-        [&serializer, &args] {
-            if constexpr (SerializerFunction(args, serializer)) {
-                args(tools::Context<tools::Phases::Deserialization,
-                                    decltype(serializer)>(serializer));
-            } else {
-                serializer.deserialize_(args);
-            }
-        }(),
-        ...);
+    if constexpr (concepts::TracksMembers<decltype(mem)>) {
+        mem.enter(pos);
+    }
+    tools::deserializeArgs<0>(serializer, std::forward_as_tuple(args...));
+    if constexpr (concepts::TracksMembers<decltype(mem)>) {
+        mem.leave();
+    }
+    return serializer.pos;
+}
+
+/******************************************************************************/
+/*                              serialized size                               */
+/******************************************************************************/
+
+/// @brief Compute the exact number of bytes required to serialize the
+///        arguments. Nothing is written, the serializer only advances the
+///        position. The result can be used to allocate the buffer once before
+///        serializing.
+/// @tparam Ser Serializer type (its memory type should be a tools::Measure).
+/// @param args Values to measure.
+/// @return Number of bytes required to serialize args.
+template <typename Ser = Serializer<tools::Measure<std::byte>>>
+inline constexpr size_t serializedSize(auto const &...args) {
+    std::remove_reference_t<typename Ser::mem_type> mem;
+    return serialize<Ser>(mem, 0, args...);
+}
+
+/// @brief Serialize the arguments with a single allocation. The exact size is
+///        computed first (serializedSize), the memory is resized once and the
+///        data is then written without any bounds check.
+/// @tparam Ser Serializer type which type table and additional types are used
+///             (its memory type is replaced by a tools::MeasureOf for the size
+///             and by a tools::Unchecked memory for the data).
+/// @param mem  Buffer in which the serialized data will be stored.
+/// @param pos  Start position in the buffer for serializing the data.
+/// @param args Values to serialize
+/// @return Position of the next element in the buffer.
+/// @throw std::out_of_range when the buffer cannot be resized and is too
+///        small.
+template <typename Ser = Serializer<tools::Measure<std::byte>>>
+inline constexpr size_t serializeExact(auto &mem, size_t pos,
+                                       auto const &...args) {
+    using mem_t = std::remove_reference_t<decltype(mem)>;
+    using MeasureSer =
+        typename Ser::template rebind_t<tools::MeasureOf<mem_t>>;
+    using WriteSer = typename Ser::template rebind_t<tools::Unchecked<mem_t>>;
+    size_t end = pos + serializedSize<MeasureSer>(args...);
+
+    if constexpr (concepts::Resizeable<mem_t>) {
+        mem.resize(end);
+    } else if (mem.size() < end) {
+        throw std::out_of_range("error: the serialization array is too small.");
+    }
+    tools::Unchecked<mem_t> unchecked(mem);
+    return serialize<WriteSer>(unchecked, pos, args...);
+}
+
+/******************************************************************************/
+/*                                 fixed size                                 */
+/******************************************************************************/
+
+/// @brief Array that can store the serialized arguments which size is known at
+///        compile time (see mtf::static_serialized_size_v).
+template <concepts::FixedSize... Types>
+using fixed_bytes_t =
+    std::array<std::byte, (mtf::static_serialized_size_v<Types> + ... + 0)>;
+
+/// @brief Serialize arguments which size is known at compile time into a
+///        fixed size array. The capacity is checked at compile time, so the
+///        data is written without any bounds check and the offsets of the
+///        members are constants.
+/// @param mem  Array in which the serialized data will be stored.
+/// @param args Values to serialize.
+/// @return Number of serialized bytes.
+template <typename T, size_t N>
+inline constexpr size_t
+serializeFixed(std::array<T, N> &mem, concepts::FixedSize auto const &...args) {
+    constexpr size_t size =
+        (mtf::static_serialized_size_v<decltype(args)> + ... + 0);
+    static_assert(size <= N, "The array is too small.");
+    tools::Unchecked<std::array<T, N>> unchecked(mem);
+    serialize<Serializer<tools::Unchecked<std::array<T, N>>>>(unchecked, 0,
+                                                              args...);
+    return size;
+}
+
+/// @brief Deserialize arguments which size is known at compile time from a
+///        fixed size array (the size is checked at compile time).
+/// @param mem  Array that contains the serialized data.
+/// @param args references to the variables that are deserialized.
+/// @return Number of deserialized bytes.
+template <typename T, size_t N>
+inline constexpr size_t deserializeFixed(std::array<T, N> const &mem,
+                                         concepts::FixedSize auto &...args) {
+    constexpr size_t size =
+        (mtf::static_serialized_size_v<decltype(args)> + ... + 0);
+    static_assert(size <= N, "The array is too small.");
+    deserialize<Serializer<std::array<T, N> const>>(mem, 0, args...);
+    return size;
+}
+
+/******************************************************************************/
+/*                                  checksum                                  */
+/******************************************************************************/
+
+/// @brief Serialize the arguments followed by the CRC32C of the serialized
+///        data (4 bytes, little endian).
+/// @param mem  Buffer in which the serialized data will be stored.
+/// @param pos  Start position in the buffer for serializing the data.
+/// @param args Values to serialize
+/// @return Position of the next element in the buffer.
+inline size_t serializeWithChecksum(auto &mem, size_t pos,
+                                    auto const &...args) {
+    using mem_t = std::remove_reference_t<decltype(mem)>;
+    using byte_type = mtf::byte_type_t<mem_t>;
+    Serializer<mem_t> serializer(mem, serialize<Serializer<mem_t>>(
+                                          mem, pos, args...));
+    uint32_t crc = tools::crc32c(mem.data() + pos, serializer.pos - pos);
+
+    if constexpr (std::endian::native == std::endian::big) {
+        crc = tools::byteswap(crc);
+    }
+    serializer.append(std::bit_cast<const byte_type *>(&crc), sizeof(crc));
+    if constexpr (!concepts::Appendable<mem_t> &&
+                  concepts::Resizeable<mem_t>) {
+        mem.resize(serializer.pos);
+    }
     return serializer.pos;
 }
 
+/// @brief Deserialize data serialized with serializeWithChecksum. The data
+///        goes from pos to the end of the buffer. The checksum is verified
+///        before anything is deserialized and the data is then deserialized
+///        with bounds checks (tools::Verified).
+/// @param mem  Buffer that contains the serialized data and the checksum.
+/// @param pos  Start position in the buffer for deserializing the data.
+/// @param args references to the variables that are deserialized.
+/// @return Position of the end of the data (after the checksum).
+/// @throw exceptions::CorruptedDataError if the checksum doesn't match or if
+///        the data is invalid.
+inline size_t deserializeVerified(auto &mem, size_t pos, auto &&...args) {
+    using mem_t = std::remove_reference_t<decltype(mem)>;
+    size_t size = mem.size();
+    uint32_t crc;
+
+    if (pos > size || size - pos < sizeof(crc)) [[unlikely]] {
+        throw exceptions::CorruptedDataError("error: the checksum is missing.");
+    }
+    size_t end = size - sizeof(crc);
+    std::memcpy(&crc, mem.data() + end, sizeof(crc));
+    if constexpr (std::endian::native == std::endian::big) {
+        crc = tools::byteswap(crc);
+    }
+    if (tools::crc32c(mem.data() + pos, end - pos) != crc) [[unlikely]] {
+        throw exceptions::CorruptedDataError("error: invalid checksum.");
+    }
+    tools::Verified<mem_t> verified(mem, end);
+    size_t next = deserialize<Serializer<tools::Verified<mem_t>>>(
+        verified, pos, args...);
+    if (next != end) [[unlikely]] {
+        throw exceptions::CorruptedDataError(
+            "error: unexpected data before the checksum.");
+    }
+    return size;
+}
+
 /******************************************************************************/
 /*                      serialize / deserialize with id                       */
 /******************************************************************************/
@@ -104,6 +268,115 @@ constexpr inline size_t deserializeWithId(auto &mem, size_t pos,
     }
 }
 
+/******************************************************************************/
+/*                     serialize / deserialize with index                     */
+/******************************************************************************/
+
+/// @brief Serialize the members after a table of their offsets, so a reader can
+///        access any member without parsing the previous ones, and can skip
+///        the members it doesn't know. The layout is:
+///        [id][number of members (uint32)][end of each member (uint32,
+///        relative to the first member)][members].
+///        The table is written once all the members are serialized, so the
+///        memory must give access to the data (the table is not written when
+///        the memory only measures the size).
+/// @tparam Ser Serializer type.
+/// @tparam T Type serialize (used for the id).
+/// @param mem Buffer of bytes that will contain the serialized data.
+/// @param pos Position in mem.
+/// @param args Elements that are serialized.
+/// @return Position of the next element in the buffer.
+/// @throw std::out_of_range if a member ends after 4GB.
+template <typename Ser, typename T>
+constexpr inline size_t serializeWithIndex(auto &mem, size_t pos,
+                                           auto &&...args) {
+    using mem_t = std::remove_reference_t<decltype(mem)>;
+    static_assert(!concepts::Fetchable<mem_t> &&
+                      (concepts::DataAccessible<mem_t> ||
+                       concepts::MeasuresOnly<mem_t>),
+                  "The offsets are written after the members, so the indexed "
+                  "objects require a memory accessible through data().");
+    constexpr uint32_t nb_members = sizeof...(args);
+    [[maybe_unused]] bool first_level = pos == 0;
+    Ser serializer(mem, pos);
+    uint32_t ends[nb_members + 1] = {0};
+
+    if constexpr (tools::has_type_v<T, typename Ser::type_table>) {
+        serializer.serialize_(tools::getId<T>(typename Ser::type_table()));
+    }
+    serializer.appendTrivial(nb_members);
+    size_t table = serializer.pos;
+    for (size_t i = 0; i < nb_members; ++i) {
+        serializer.appendTrivial(uint32_t(0));
+    }
+    size_t payload = serializer.pos;
+    size_t idx = 0;
+    ([&](auto &&arg) {
+        tools::serializeArgs<0>(serializer, std::forward_as_tuple(arg));
+        if (serializer.pos - payload > UINT32_MAX) [[unlikely]] {
+            throw std::out_of_range(
+                "error: the indexed objects are limited to 4GB.");
+        }
+        ends[idx++] = uint32_t(serializer.pos - payload);
+    }(args), ...);
+
+    if constexpr (concepts::DataAccessible<mem_t>) {
+        for (size_t i = 0; i < nb_members; ++i) {
+            uint32_t end = ends[i];
+            if constexpr (Ser::swap_bytes) {
+                end = tools::byteswap(end);
+            }
+            std::memcpy(mem.data() + table + i * sizeof(end), &end,
+                        sizeof(end));
+        }
+    }
+    if constexpr (!concepts::Appendable<mem_t> &&
+                  concepts::Resizeable<mem_t>) {
+        if (first_level) [[unlikely]] {
+            mem.resize(serializer.pos);
+        }
+    }
+    return serializer.pos;
+}
+
+/// @brief Deserialize the members serialized with serializeWithIndex. Each
+///        member is deserialized at its offset. The additional members of the
+///        data are skipped, and the members that are missing in the data are
+///        not modified (schema evolution).
+/// @tparam Ser Serializer type.
+/// @tparam T Type serialize (used for the id).
+/// @param mem Buffer of bytes that contains the serialized data.
+/// @param pos Position in mem.
+/// @param args Elements that are deserialized.
+/// @return Position of the next element in the buffer.
+template <typename Ser, typename T>
+constexpr inline size_t deserializeWithIndex(auto &mem, size_t pos,
+                                             auto &&...args) {
+    Ser serializer(mem, pos);
+
+    if constexpr (tools::has_type_v<T, typename Ser::type_table>) {
+        serializer.deserialize_(tools::getId<T>(typename Ser::type_table()));
+    }
+    uint32_t nb_members = serializer.template deserializeTrivial<uint32_t>();
+    size_t table = serializer.pos;
+    size_t payload = table + size_t(nb_members) * sizeof(uint32_t);
+    uint32_t end = 0, idx = 0;
+
+    serializer.checkBounds(payload - table);
+    ([&](auto &&arg) {
+        if (idx++ < nb_members) {
+            Ser member(mem, payload + end);
+            tools::deserializeArgs<0>(member, std::forward_as_tuple(arg));
+            end = serializer.template deserializeTrivial<uint32_t>();
+        }
+    }(args), ...);
+    if (nb_members > sizeof...(args)) {
+        serializer.pos = table + (nb_members - 1) * sizeof(uint32_t);
+        end = serializer.template deserializeTrivial<uint32_t>();
+    }
+    return payload + end;
+}
+
 /******************************************************************************/
 /*                       serialize / deserialize struct                       */
 /******************************************************************************/
@@ -120,7 +393,11 @@ template <typename T>
 inline constexpr size_t serializeStruct(auto &mem, size_t pos, T const *obj) {
     constexpr size_t nb_bytes = sizeof(*obj);
     Serializer<decltype(mem)> serializer(mem, pos);
-    using byte_type = std::remove_cvref_t<decltype(mem[0])>;
+    static_assert(!decltype(serializer)::swap_bytes,
+                  "SERIALIZE_STRUCT copies the host bytes and cannot be used "
+                  "with a memory which byte order differs from the host one "
+                  "(use SERIALIZE with the members).");
+    using byte_type = mtf::byte_type_t<decltype(mem)>;
     serializer.append(std::bit_cast<const byte_type *>(obj), nb_bytes);
     return serializer.pos;
 }
@@ -133,8 +410,67 @@ inline constexpr size_t serializeStruct(auto &mem, size_t pos, T const *obj) {
 /// @return Position of the next element in the buffer.
 template <typename T>
 inline constexpr size_t deserializeStruct(auto &mem, size_t pos, T *obj) {
-    *obj = *std::bit_cast<const decltype(obj)>(mem.data() + pos);
-    return pos + sizeof(*obj);
+    Serializer<decltype(mem)> serializer(mem, pos);
+    static_assert(!decltype(serializer)::swap_bytes,
+                  "SERIALIZE_STRUCT copies the host bytes and cannot be used "
+                  "with a memory which byte order differs from the host one "
+                  "(use SERIALIZE with the members).");
+    serializer.read(obj, sizeof(*obj));
+    return serializer.pos;
+}
+
+/******************************************************************************/
+/*                                  columns                                   */
+/******************************************************************************/
+
+/// @brief Deserialize the member I of the elements of a container serialized
+///        with SER_COLUMNS without deserializing the other members. The
+///        previous trivial columns are skipped in O(1), the other ones are
+///        deserialized into a temporary.
+/// @tparam Ser Serializer type.
+/// @tparam T Type of the elements (SERIALIZE).
+/// @tparam I Index of the member.
+/// @param mem Buffer of bytes that contains the serialized data.
+/// @param pos Position of the container in mem.
+/// @param column Resizeable container that receives the values of the member.
+/// @return Position of the end of the column.
+template <typename Ser, typename T, size_t I>
+constexpr inline size_t deserializeColumn(auto &mem, size_t pos,
+                                          auto &column) {
+    using Members = decltype(std::declval<T &>().serializedMembers());
+    static_assert(I < std::tuple_size_v<Members>, "Invalid member index.");
+    using M = mtf::clean_t<std::tuple_element_t<I, Members>>;
+    Ser serializer(mem, pos);
+    size_t size = serializer.template deserializeSize<size_t>();
+
+    // skip the previous columns
+    [&]<size_t... Js>(std::index_sequence<Js...>) {
+        ([&] {
+            using P = mtf::clean_t<std::tuple_element_t<Js, Members>>;
+            if constexpr (Ser::template is_trivial_column_v<P>) {
+                serializer.checkBounds(size * sizeof(P));
+                serializer.pos += size * sizeof(P);
+            } else {
+                static_assert(std::is_default_constructible_v<P>,
+                              "The column cannot be skipped.");
+                P value{};
+                for (size_t i = 0; i < size; ++i) {
+                    serializer.deserialize_(value);
+                }
+            }
+        }(), ...);
+    }(std::make_index_sequence<I>());
+
+    column.resize(size);
+    if constexpr (Ser::template is_trivial_column_v<M> &&
+                  std::contiguous_iterator<decltype(std::begin(column))>) {
+        serializer.readArray(std::to_address(std::begin(column)), size);
+    } else {
+        for (auto &value : column) {
+            serializer.deserialize_(value);
+        }
+    }
+    return serializer.pos;
 }
 
 /******************************************************************************/
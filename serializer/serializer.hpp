@@ -4,11 +4,30 @@
 #include "tools/type_table.hpp"
 #include "tools/super.hpp"
 #include "tools/bytes.hpp"
+#include "tools/bytes_pool.hpp"
+#include "tools/measure.hpp"
+#include "tools/unchecked.hpp"
+#include "tools/verified.hpp"
+#include "tools/tracked.hpp"
+#include "tools/reuse.hpp"
+#include "tools/interned.hpp"
+#include "tools/arena.hpp"
+#include "tools/compact.hpp"
+#include "tools/crc32c.hpp"
+#include "tools/endian.hpp"
+#include "tools/parallel.hpp"
+#include "tools/instrumentation.hpp"
 #include "tools/context.hpp"
 #include "tools/dynamic_array.hpp"
+#include "tools/numeric_codecs.hpp"
+#include "tools/columnar.hpp"
 #include "serializer/serialize.hpp"
 #include "serializer/serializer.hpp"
 #include "serialize.hpp"
+#include "tools/batch.hpp"
+#include "tools/delta.hpp"
+#include "tools/view.hpp"
+#include "tools/incremental.hpp"
 
 /// Useful alias:
 
@@ -18,6 +37,19 @@ namespace serializer {
 /// @breif alias for bytes
 using Bytes = serializer::tools::Bytes<std::byte>;
 
+/// @breif alias for the bytes that store up to N bytes without allocating
+template <size_t N> using SmallBytes = serializer::tools::Bytes<std::byte, N>;
+
+/// @breif alias for the bytes pool
+using BytesPool = serializer::tools::BytesPool<std::byte>;
+
+/// @breif alias for measure
+using Measure = serializer::tools::Measure<std::byte>;
+
+/// @breif alias for the views on the serialized objects
+template <typename T, typename Ser = Serializer<Bytes const>>
+using View = serializer::tools::View<T, Ser>;
+
 }
 
 #endif
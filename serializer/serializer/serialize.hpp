@@ -3,9 +3,29 @@
 
 namespace serializer {
 
+/// @brief Static extension point used to add the support of a type T. The
+///        specializations provide static serialize and deserialize functions
+///        that take the serializer (any memory buffer) and the element:
+///        @code
+///        template <> struct serializer::Codec<Unknown> {
+///            static constexpr void serialize(auto &ser, Unknown const &u) {
+///                ser.serialize_(u.x());
+///            }
+///            static constexpr void deserialize(auto &ser, Unknown &u) {...}
+///        };
+///        @endcode
+///        The functions are resolved at compile time, so they are inlined
+///        like the builtin types (unlike the virtual functions of Serialize).
+///        The codec has the priority over the builtin rules and the serialize
+///        methods of T. The specialization must be visible where T is
+///        serialized.
+/// @param T Type for which we want to add the serialize behavior for.
+template <typename T> struct Codec;
+
 /// @brief Used to create a serialize behavior for a specific type. This class
 ///        is used when we want to create a custom serializer that add support
-///        for external types.
+///        for external types (see Codec for an extension point without
+///        virtual calls).
 /// @param T Type for which we want to add the serialize behavior for.
 template <typename T> struct Serialize {
     constexpr virtual void serialize(T const &) = 0;
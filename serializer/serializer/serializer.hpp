@@ -1,20 +1,36 @@
 #ifndef SERIALIZER_SERIALIZER_SERIALIZER_HPP
 #define SERIALIZER_SERIALIZER_SERIALIZER_HPP
+#include "../exceptions/corrupted_data.hpp"
 #include "../exceptions/unsupported_type.hpp"
 #include "../meta/serializer_meta.hpp"
 #include "../meta/type_check.hpp"
 #include "../meta/type_transform.hpp"
+#include "../tools/compact.hpp"
 #include "../tools/dynamic_array.hpp"
+#include "../tools/endian.hpp"
+#include "../tools/instrumentation.hpp"
+#include "../tools/measure.hpp"
+#include "../tools/numeric_codecs.hpp"
+#include "../tools/parallel.hpp"
 #include "../tools/tools.hpp"
+#include "../tools/tracked.hpp"
 #include "../tools/type_table.hpp"
+#include "../tools/unchecked.hpp"
 #include "serialize.hpp"
 #include <algorithm>
 #include <bit>
+#include <cstdint>
 #include <cstring>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <variant>
+#include <vector>
 
 /// @brief namespace serializer
 namespace serializer {
@@ -34,8 +50,54 @@ struct Serializer : Serialize<AdditionalTypes>... {
     using type_table = TypeTable;
     using id_type = typename TypeTable::id_type;
     using mem_type = MemT; ///< alias to the type of the momory buffer
-    using byte_type =
-        std::remove_cvref_t<decltype(mem[0])>; ///< alias to the byte type
+    using byte_type = mtf::byte_type_t<MemT>; ///< alias to the byte type
+
+    /// @brief Serializer with the same type table and additional types that
+    ///        uses another memory type.
+    template <typename OtherMemT>
+    using rebind_t = Serializer<OtherMemT, TypeTable, AdditionalTypes...>;
+
+    /// @brief True if T is an integer encoded with a varint (compact memory).
+    template <typename T>
+    static constexpr bool is_compact_integer_v =
+        concepts::CompactIntegers<MemT> &&
+        std::is_integral_v<mtf::clean_t<T>> &&
+        !std::is_same_v<mtf::clean_t<T>, bool> && (sizeof(T) > 1);
+
+    /// @brief True if T is serialized by a custom function (additional type
+    ///        of the serializer or serializer::Codec).
+    template <typename T>
+    static constexpr bool is_custom_v =
+        mtf::contains_v<mtf::clean_t<T>, AdditionalTypes...> ||
+        concepts::HasCodec<T>;
+
+    /// @brief True if T is serialized with a plain copy of its bytes (such
+    ///        values can be packed together).
+    template <typename T>
+    static constexpr bool is_packable_v =
+        concepts::Trivial<T> && !is_compact_integer_v<T> &&
+        !concepts::Serializable<T, MemT> &&
+        !concepts::Deserializable<T, MemT> && !is_custom_v<T> &&
+        !tools::has_type_v<T, TypeTable> && !concepts::TracksMembers<MemT>;
+
+    /// @brief True if the scalar values are byte-swapped (the byte order of
+    ///        the memory is fixed and differs from the host one).
+    static constexpr bool swap_bytes = [] {
+        if constexpr (concepts::FixedByteOrder<MemT>) {
+            return mtf::clean_t<MemT>::byte_order != std::endian::native;
+        } else {
+            return false;
+        }
+    }();
+
+    /// @brief True if T is serialized by its serialize method with a plain
+    ///        copy of its bytes (SERIALIZE_STRUCT or is_bitwise_serializable),
+    ///        so the arrays of T can be copied in bulk. Always false when the
+    ///        bytes are swapped (the raw copy would keep the host order).
+    template <typename T>
+    static constexpr bool is_bitwise_v =
+        !swap_bytes && concepts::BitwiseSerializable<T> && !is_custom_v<T> &&
+        !tools::has_type_v<mtf::clean_t<T>, TypeTable>;
 
     /* Constructor ************************************************************/
 
@@ -51,7 +113,7 @@ struct Serializer : Serialize<AdditionalTypes>... {
     /// @param nbBytes Size of the buffer.
     inline constexpr void append(const byte_type *bytes, size_t nbBytes) {
         if constexpr (!std::is_const_v<MemT>) {
-            if constexpr (mtf::is_serializer_bytes_v<mtf::clean_t<mem_type>>) {
+            if constexpr (concepts::Appendable<mem_type>) {
                 mem.append(pos, bytes, nbBytes);
                 pos += nbBytes;
             } else {
@@ -76,34 +138,301 @@ struct Serializer : Serialize<AdditionalTypes>... {
         append(std::bit_cast<const byte_type *>(&elt), sizeof(elt));
     }
 
+    /// @brief Append a block of bytes that belongs to the serialized object
+    ///        (arrays and strings). The memories that gather the blocks
+    ///        (tools::ScatterGather) can reference it instead of copying it.
+    /// @param bytes Buffer of bytes.
+    /// @param nbBytes Size of the buffer.
+    inline constexpr void appendBlock(const byte_type *bytes, size_t nbBytes) {
+        if constexpr (!std::is_const_v<MemT> &&
+                      concepts::ReferencesBlocks<mem_type>) {
+            mem.appendExternal(pos, bytes, nbBytes);
+            pos += nbBytes;
+        } else {
+            append(bytes, nbBytes);
+        }
+    }
+
+    /// @brief Append several trivial values with only one append (one
+    ///        capacity check for all the values).
+    /// @param elts Values to append.
+    inline constexpr void appendPacked(auto const &...elts) {
+        constexpr size_t nbBytes = (sizeof(elts) + ...);
+        byte_type bytes[nbBytes];
+        size_t offset = 0;
+
+        (
+            [&] {
+                if constexpr (swap_bytes) {
+                    auto swapped = tools::byteswap(elts);
+                    std::memcpy(bytes + offset, &swapped, sizeof(elts));
+                } else {
+                    std::memcpy(bytes + offset, &elts, sizeof(elts));
+                }
+                offset += sizeof(elts);
+            }(),
+            ...);
+        append(bytes, nbBytes);
+    }
+
+    /// @brief Check that the next nbBytes bytes are in the memory (only when
+    ///        the memory is bounds checked, see tools::Verified).
+    /// @param nbBytes Number of bytes that are read.
+    /// @throw exceptions::CorruptedDataError if the data is truncated.
+    inline constexpr void checkBounds([[maybe_unused]] size_t nbBytes) {
+        if constexpr (concepts::BoundsChecked<mem_type>) {
+            if (pos > mem.size() || nbBytes > mem.size() - pos) [[unlikely]] {
+                throw exceptions::CorruptedDataError(
+                    "error: the serialized data is truncated.");
+            }
+        }
+    }
+
+    /// @brief Give access to the next nbBytes bytes of the memory (pos is not
+    ///        changed).
+    /// @param nbBytes Number of bytes that are read.
+    /// @return Pointer to the bytes at pos.
+    inline constexpr const byte_type *fetch(size_t nbBytes) {
+        checkBounds(nbBytes);
+        if constexpr (concepts::Fetchable<mem_type>) {
+            return mem.fetch(pos, nbBytes);
+        } else {
+            return mem.data() + pos;
+        }
+    }
+
+    /// @brief Copy the next nbBytes bytes of the memory into dest (pos is
+    ///        advanced). This is used for bulk reads so the fetchable memories
+    ///        can copy the data directly from their source.
+    /// @param dest Destination buffer.
+    /// @param nbBytes Number of bytes to copy.
+    inline constexpr void read(void *dest, size_t nbBytes) {
+        checkBounds(nbBytes);
+        if constexpr (concepts::Fetchable<mem_type>) {
+            mem.read(pos, static_cast<byte_type *>(dest), nbBytes);
+        } else {
+            std::memcpy(dest, mem.data() + pos, nbBytes);
+        }
+        pos += nbBytes;
+    }
+
+    /// @brief Read several trivial values stored consecutively.
+    /// @param elts Values to read.
+    inline constexpr void deserializePacked(auto &&...elts) {
+        constexpr size_t nbBytes = (sizeof(elts) + ...);
+        auto bytes = fetch(nbBytes);
+        size_t offset = 0;
+
+        (
+            [&] {
+                std::memcpy(&elts, bytes + offset, sizeof(elts));
+                if constexpr (swap_bytes) {
+                    elts = tools::byteswap(elts);
+                }
+                offset += sizeof(elts);
+            }(),
+            ...);
+        pos += offset;
+    }
+
+    /// @brief Append a trivial value (byte-swapped if required).
+    /// @param elt Value to append.
+    inline constexpr void appendTrivial(auto const &elt) {
+        if constexpr (swap_bytes) {
+            auto swapped = tools::byteswap(elt);
+            append(std::bit_cast<const byte_type *>(&swapped), sizeof(elt));
+        } else {
+            append(std::bit_cast<const byte_type *>(&elt), sizeof(elt));
+        }
+    }
+
+    /// @brief Deserialize a trivial value (byte-swapped if required).
+    /// @tparam T Type of the value.
+    /// @return Deserialized value.
+    template <typename T> inline constexpr T deserializeTrivial() {
+        T elt = *std::bit_cast<const T *>(fetch(sizeof(T)));
+        pos += sizeof(T);
+        if constexpr (swap_bytes) {
+            return tools::byteswap(elt);
+        } else {
+            return elt;
+        }
+    }
+
+    /// @brief Append an array of trivial values. When the bytes are swapped,
+    ///        the values are swapped in bulk into a small buffer which is then
+    ///        appended.
+    /// @param elts Values to append.
+    /// @param size Number of values.
+    template <typename T>
+    inline constexpr void appendArray(T const *elts, size_t size) {
+        if constexpr (swap_bytes && sizeof(T) > 1) {
+            constexpr size_t chunk =
+                std::max(size_t(4096) / sizeof(T), size_t(1));
+            T buffer[chunk];
+            for (size_t i = 0; i < size; i += chunk) {
+                size_t count = std::min(chunk, size - i);
+                tools::byteswapArray(elts + i, buffer, count);
+                append(std::bit_cast<const byte_type *>(&buffer[0]),
+                       count * sizeof(T));
+            }
+        } else {
+            appendBlock(std::bit_cast<const byte_type *>(elts),
+                        size * sizeof(T));
+        }
+    }
+
+    /// @brief Read an array of trivial values (swapped in place if required).
+    /// @param elts Destination of the values.
+    /// @param size Number of values.
+    template <typename T> inline constexpr void readArray(T *elts, size_t size) {
+        read(elts, size * sizeof(T));
+        if constexpr (swap_bytes && sizeof(T) > 1) {
+            tools::byteswapArray(elts, elts, size);
+        }
+    }
+
+    /// @brief Append an array of bitwise serializable objects with one copy
+    ///        (only when the bytes are not swapped, see is_bitwise_v).
+    /// @param elts Objects to append.
+    /// @param size Number of objects.
+    template <typename T>
+    inline constexpr void appendBitwise(T const *elts, size_t size) {
+        static_assert(!swap_bytes, "The bitwise copy keeps the host order.");
+        appendBlock(std::bit_cast<const byte_type *>(elts), size * sizeof(T));
+    }
+
+    /// @brief Returns the allocator used for the objects created during the
+    ///        deserialization (the arena of the memory if it has one).
+    inline constexpr decltype(auto) allocator() {
+        if constexpr (concepts::HasArena<mem_type>) {
+            return mem.arena();
+        } else {
+            return tools::NewAllocator();
+        }
+    }
+
+    /// @brief Append an unsigned integer encoded with a LEB128 varint.
+    /// @param value Value to append.
+    inline constexpr void appendVarint(uint64_t value) {
+        byte_type bytes[tools::varint_max_size];
+        append(bytes, tools::varintEncode(value, bytes));
+    }
+
+    /// @brief Read an unsigned integer encoded with a LEB128 varint.
+    /// @return Deserialized value.
+    /// @throw std::runtime_error if the varint is too long.
+    inline constexpr uint64_t deserializeVarint() {
+        uint64_t value = 0;
+        for (size_t shift = 0; shift < 64; shift += 7) {
+            auto byte = uint8_t(*fetch(1));
+            ++pos;
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw std::runtime_error("error: invalid varint.");
+    }
+
+    /// @brief Helper function for serializing the size of containers (the
+    ///        size is a varint when the memory is compact).
+    /// @param size Size to serialize.
+    template <typename T> inline constexpr void appendSize(T size) {
+        if constexpr (concepts::CompactSizes<mem_type>) {
+            appendVarint(uint64_t(size));
+        } else {
+            appendTrivial(size);
+        }
+    }
+
     /// @brief Helper function for deserializing the size of containers.
     /// @tparam Type of the size
     /// @return Deserialized size.
     template <typename T> inline constexpr T deserializeSize() {
-        auto size = *std::bit_cast<const T *>(mem.data() + pos);
-        pos += sizeof(T);
+        T size;
+        if constexpr (concepts::CompactSizes<mem_type>) {
+            size = T(deserializeVarint());
+        } else {
+            size = deserializeTrivial<T>();
+        }
+        // each element takes at least one byte
+        checkBounds(size_t(size));
         return size;
     }
 
-    /// @brief Deserialize an identifier.
+    /// @brief Serialize a reference to an object that has already been
+    ///        serialized (tracked memory only). The object is added to the
+    ///        tracked objects otherwise.
+    /// @tparam T Type of the pointer (the shared and raw pointers on the same
+    ///           object are tracked separately).
+    /// @param ptr Address of the object.
+    /// @return True if the reference has been serialized.
+    template <typename T>
+    inline constexpr bool appendReference(void const *ptr) {
+        auto [index, inserted] = mem.objects().insert(
+            ptr, &tools::tracked_type_key<mtf::clean_t<T>>);
+        if (inserted) {
+            return false;
+        }
+        append('r');
+        appendSize(index);
+        return true;
+    }
+
+    /// @brief Deserialize the index of a reference (tracked memory only).
+    /// @return Index of the referenced object.
+    inline constexpr size_t deserializeReference() {
+        if constexpr (concepts::CompactSizes<mem_type>) {
+            return size_t(deserializeVarint());
+        } else {
+            return deserializeTrivial<size_t>();
+        }
+    }
+
+    /// @brief Deserialize an identifier (pos is not changed).
     /// @param elt Element that is deserialized.
     /// @return id
     inline constexpr id_type deserializeId() {
-        auto id = *std::bit_cast<const id_type *>(mem.data() + pos);
-        return id;
+        if constexpr (is_compact_integer_v<id_type>) {
+            size_t start = pos;
+            auto id = id_type(deserializeVarint());
+            pos = start;
+            return id;
+        } else {
+            size_t start = pos;
+            auto id = deserializeTrivial<id_type>();
+            pos = start;
+            return id;
+        }
     }
 
     /* types with ids *********************************************************/
 
-    /// @brief Serialize a generic type registed in the type table
+    /// @brief Serialize a generic type registed in the type table. The
+    ///        pointers to the polymorphic types that don't declare serialize
+    ///        methods are dispatched with the type table (see
+    ///        serializeDynamic).
     /// @param elt Element serialized.
     template <typename T>
         requires(tools::has_type_v<T, TypeTable>)
     inline constexpr void serialize_(T &&elt) {
-        if constexpr (requires { elt->serialize(mem, pos); }) {
-            pos = elt->serialize(mem, pos);
-        } else if constexpr (requires { elt.serialize(mem, pos); }) {
-            pos = elt.serialize(mem, pos);
+        auto serializeElt = [&] {
+            if constexpr (requires { elt->serialize(mem, pos); }) {
+                pos = elt->serialize(mem, pos);
+            } else if constexpr (requires { elt.serialize(mem, pos); }) {
+                pos = elt.serialize(mem, pos);
+            } else if constexpr (concepts::Pointer<T> ||
+                                 concepts::SmartPtr<T>) {
+                serializeDynamic(elt);
+            }
+        };
+        if constexpr (concepts::Instrumented<MemT>) {
+            using enum tools::Phases;
+            mem.instrumentation().template recordId<Serialization>(
+                tools::dynamicId(elt, TypeTable()), pos, serializeElt);
+        } else {
+            serializeElt();
         }
     }
 
@@ -113,14 +442,74 @@ struct Serializer : Serialize<AdditionalTypes>... {
         requires(tools::has_type_v<T, TypeTable>)
     inline constexpr void deserialize_(T &&elt) {
         auto id = deserializeId();
-        tools::createId<TypeTable>(id, elt);
-        if constexpr (requires { elt.deserialize(mem, pos); }) {
-            pos = elt.deserialize(mem, pos);
-        } else if constexpr (requires { elt->deserialize(mem, pos); }) {
-            pos = elt->deserialize(mem, pos);
+        auto deserializeElt = [&] {
+            if constexpr (concepts::ReusesObjects<mem_type>) {
+                if (!tools::pointsToId(id, TypeTable(), elt)) {
+                    tools::createId<TypeTable>(id, elt, allocator());
+                }
+            } else {
+                tools::createId<TypeTable>(id, elt, allocator());
+            }
+            if constexpr (requires { elt.deserialize(mem, pos); }) {
+                pos = elt.deserialize(mem, pos);
+            } else if constexpr (requires { elt->deserialize(mem, pos); }) {
+                pos = elt->deserialize(mem, pos);
+            } else if constexpr (concepts::Pointer<T> ||
+                                 concepts::SmartPtr<T>) {
+                deserializeDynamic(id, elt);
+            }
+        };
+        if constexpr (concepts::Instrumented<MemT>) {
+            using enum tools::Phases;
+            mem.instrumentation().template recordId<Deserialization>(
+                size_t(id), pos, deserializeElt);
+        } else {
+            deserializeElt();
         }
     }
 
+    /// @brief Serialize a pointer to a polymorphic type with the serialize
+    ///        method of its dynamic type: the id of the dynamic type is found
+    ///        in the type table and the object is cast to its concrete type,
+    ///        so the (template) serialize method of the concrete type is
+    ///        called without a virtual call (see SERIALIZE_POLYMORPHIC).
+    /// @param elt Pointer or smart pointer to serialize.
+    /// @throw std::logic_error if the dynamic type is not in the type table.
+    inline constexpr void serializeDynamic(auto const &elt) {
+        using Base = std::remove_reference_t<decltype(*elt)>;
+        size_t id = tools::dynamicId(elt, TypeTable());
+        if (id == size_t(-1)) [[unlikely]] {
+            throw std::logic_error("error: the dynamic type of the pointer is "
+                                   "not in the type table.");
+        }
+        Base const *ptr = &*elt;
+        tools::applyId(id, TypeTable(), [&]<typename U>() {
+            if constexpr (std::is_base_of_v<Base, U> &&
+                          requires(U const &obj) { obj.serialize(mem, pos); }) {
+                pos = static_cast<U const *>(ptr)->serialize(mem, pos);
+            } else {
+                throw exceptions::UnsupportedTypeError<U>();
+            }
+        });
+    }
+
+    /// @brief Deserialize a pointer to a polymorphic type with the deserialize
+    ///        method of the type that has the given id (see serializeDynamic).
+    /// @param id Identifier of the dynamic type of the object.
+    /// @param elt Pointer or smart pointer created with the id.
+    inline constexpr void deserializeDynamic(auto id, auto &elt) {
+        using Base = std::remove_reference_t<decltype(*elt)>;
+        Base *ptr = &*elt;
+        tools::applyId(id, TypeTable(), [&]<typename U>() {
+            if constexpr (std::is_base_of_v<Base, U> &&
+                          requires(U &obj) { obj.deserialize(mem, pos); }) {
+                pos = static_cast<U *>(ptr)->deserialize(mem, pos);
+            } else {
+                throw exceptions::UnsupportedTypeError<U>();
+            }
+        });
+    }
+
     /* no automatic serialization types (custom convertor) ********************/
 
     /// @brief Fallback functions for non serializable types. Here either we use
@@ -138,6 +527,8 @@ struct Serializer : Serialize<AdditionalTypes>... {
             // we need a static cast because of implicit constructors (ex:
             // pointer to shared_ptr)
             static_cast<Serialize<mtf::clean_t<T>> *>(this)->serialize(elt);
+        } else if constexpr (concepts::HasCodec<T>) {
+            Codec<mtf::clean_t<T>>::serialize(*this, elt);
         } else {
             throw serializer::exceptions::UnsupportedTypeError<
                 mtf::clean_t<T>>();
@@ -160,6 +551,8 @@ struct Serializer : Serialize<AdditionalTypes>... {
             // we need a static cast because of implicit constructors (ex:
             // pointer to shared_ptr)
             static_cast<Serialize<mtf::clean_t<T>> *>(this)->deserialize(elt);
+        } else if constexpr (concepts::HasCodec<T>) {
+            Codec<mtf::clean_t<T>>::deserialize(*this, elt);
         } else {
             throw serializer::exceptions::UnsupportedTypeError<
                 mtf::clean_t<T>>();
@@ -193,18 +586,34 @@ struct Serializer : Serialize<AdditionalTypes>... {
     /// @brief Serialize function for the trivial types.
     /// @param elt Element that is serialized.
     template <serializer::concepts::Trivial T>
-        requires(!concepts::Serializable<T, MemT>)
+        requires(!concepts::Serializable<T, MemT> && !is_custom_v<T>)
     inline constexpr void serialize_(T &&elt) {
-        append(std::bit_cast<const byte_type *>(&elt), sizeof(elt));
+        if constexpr (is_compact_integer_v<T>) {
+            if constexpr (std::is_signed_v<mtf::clean_t<T>>) {
+                appendVarint(tools::zigzagEncode(int64_t(elt)));
+            } else {
+                appendVarint(uint64_t(elt));
+            }
+        } else {
+            appendTrivial(elt);
+        }
     }
 
     /// @brief Deserialize function for the trivial types.
     /// @param elt Element that is deserialized.
     template <serializer::concepts::Trivial T>
-        requires(!concepts::Deserializable<T, MemT>)
+        requires(!concepts::Deserializable<T, MemT> && !is_custom_v<T>)
     inline constexpr void deserialize_(T &&elt) {
-        elt = *std::bit_cast<const mtf::clean_t<T> *>(mem.data() + pos);
-        pos += sizeof(T);
+        using Type = mtf::clean_t<T>;
+        if constexpr (is_compact_integer_v<T>) {
+            if constexpr (std::is_signed_v<Type>) {
+                elt = Type(tools::zigzagDecode(deserializeVarint()));
+            } else {
+                elt = Type(deserializeVarint());
+            }
+        } else {
+            elt = deserializeTrivial<Type>();
+        }
     }
 
     /* pointers ***************************************************************/
@@ -213,13 +622,17 @@ struct Serializer : Serialize<AdditionalTypes>... {
     ///        The pointer should be valid (nullptr or value).
     /// @param elt Element that is serialized.
     template <serializer::concepts::Pointer T>
-        requires(!mtf::contains_v<T, AdditionalTypes...> &&
-                 !tools::has_type_v<T, TypeTable>)
+        requires(!is_custom_v<T> && !tools::has_type_v<T, TypeTable>)
     inline constexpr void serialize_(T &&elt) {
         if (elt == nullptr) {
             append('n');
             return;
         }
+        if constexpr (concepts::TracksObjects<mem_type>) {
+            if (appendReference<T>(elt)) {
+                return;
+            }
+        }
         append('v');
         if constexpr (requires { elt->serialize(mem, pos); }) {
             pos = elt->serialize(mem, pos);
@@ -230,15 +643,15 @@ struct Serializer : Serialize<AdditionalTypes>... {
 
     /// @brief Deserialize function for the pointer types. If the pointer is not
     ///        null, a dynamic allocation is done. This memory should be handled
-    ///        by the user.
+    ///        by the user (or by the arena of the memory).
     /// @param elt Element that is deserialized.
     template <serializer::concepts::ConcretePtr T>
-        requires(!mtf::contains_v<T, AdditionalTypes...> &&
-                 !tools::has_type_v<T, TypeTable>)
+        requires(!is_custom_v<T> && !tools::has_type_v<T, TypeTable>)
     inline constexpr void deserialize_(T &&elt) {
-        bool ptrValid = char(mem[pos++]) == 'v';
+        char tag = char(*fetch(1));
+        ++pos;
 
-        if (!ptrValid) {
+        if (tag == 'n') {
             elt = nullptr;
             return;
         }
@@ -246,8 +659,20 @@ struct Serializer : Serialize<AdditionalTypes>... {
                           std::remove_pointer_t<std::remove_cvref_t<T>>>,
                       "The pointer types should be default constructible.");
         using Type = typename std::remove_pointer_t<std::remove_reference_t<T>>;
+        if constexpr (concepts::TracksObjects<mem_type>) {
+            if (tag == 'r') {
+                elt = static_cast<Type *>(
+                    mem.objects().get(deserializeReference()).get());
+                return;
+            }
+        }
         if (elt == nullptr) {
-            elt = new Type();
+            elt = allocator().template create<Type>();
+        }
+        if constexpr (concepts::TracksObjects<mem_type>) {
+            // the raw pointers don't own the object (aliasing constructor)
+            mem.objects().add(std::shared_ptr<void>(std::shared_ptr<void>(),
+                                                    static_cast<void *>(elt)));
         }
         if constexpr (requires { elt->deserialize(mem, pos); }) {
             pos = elt->deserialize(mem, pos);
@@ -262,14 +687,19 @@ struct Serializer : Serialize<AdditionalTypes>... {
     ///        The pointer should be valid (nullptr or value).
     /// @param elt Element that is serialized.
     template <serializer::concepts::SmartPtr T>
-        requires(!mtf::contains_v<T, AdditionalTypes...> &&
-                 !tools::has_type_v<T, TypeTable>)
+        requires(!is_custom_v<T> && !tools::has_type_v<T, TypeTable>)
     inline constexpr void serialize_(T &&elt) {
         using ST = mtf::element_type_t<T>;
         if (elt != nullptr) {
+            if constexpr (concepts::TracksObjects<mem_type> &&
+                          mtf::is_shared_v<T>) {
+                if (appendReference<T>(elt.get())) {
+                    return;
+                }
+            }
             append('v');
             if constexpr (concepts::Serializable<ST, MemT>) {
-                elt->serialize(mem, pos);
+                pos = elt->serialize(mem, pos);
             } else {
                 serialize_(*elt);
             }
@@ -282,24 +712,48 @@ struct Serializer : Serialize<AdditionalTypes>... {
     ///        pointer is allocated if required.
     /// @param elt Element that is deserialized.
     template <serializer::concepts::ConcreteSmartPtr T>
-        requires(!mtf::contains_v<T, AdditionalTypes...> &&
-                 !tools::has_type_v<T, TypeTable>)
+        requires(!is_custom_v<T> && !tools::has_type_v<T, TypeTable>)
     inline constexpr void deserialize_(T &&elt) {
-        bool ptrValid = char(mem[pos++]) == 'v';
+        using ST = mtf::element_type_t<T>;
+        char tag = char(*fetch(1));
+        ++pos;
 
-        if (!ptrValid) {
+        if (tag == 'n') {
             elt = nullptr;
             return;
         }
         static_assert(mtf::is_default_constructible_v<T>,
                       "The pointer types should be default constructible.");
         if constexpr (serializer::mtf::is_shared_v<T>) {
-            elt = std::make_shared<mtf::element_type_t<T>>();
+            if constexpr (concepts::TracksObjects<mem_type>) {
+                if (tag == 'r') {
+                    elt = std::static_pointer_cast<ST>(
+                        mem.objects().get(deserializeReference()));
+                    return;
+                }
+            }
+            if constexpr (concepts::ReusesObjects<mem_type> &&
+                          !concepts::TracksObjects<mem_type>) {
+                if (!tools::pointsTo<ST>(elt) || elt.use_count() > 1) {
+                    elt = allocator().template makeShared<ST>();
+                }
+            } else {
+                elt = allocator().template makeShared<ST>();
+            }
+            if constexpr (concepts::TracksObjects<mem_type>) {
+                mem.objects().add(elt);
+            }
         } else if constexpr (serializer::mtf::is_unique_v<T>) {
-            elt = std::make_unique<mtf::element_type_t<T>>();
+            if constexpr (concepts::ReusesObjects<mem_type>) {
+                if (!tools::pointsTo<ST>(elt)) {
+                    elt = std::make_unique<ST>();
+                }
+            } else {
+                elt = std::make_unique<ST>();
+            }
         }
-        if constexpr (concepts::Deserializable<T, MemT>) {
-            elt->deserialize(mem, pos);
+        if constexpr (concepts::Deserializable<ST, MemT>) {
+            pos = elt->deserialize(mem, pos);
         } else {
             deserialize_(*elt);
         }
@@ -319,6 +773,7 @@ struct Serializer : Serialize<AdditionalTypes>... {
     /// @brief Serialize function for tuples (std::tuple and std::pair).
     /// @param elt Element that is serialized.
     template <serializer::concepts::TupleLike T>
+        requires(!concepts::HasCodec<T>)
     inline constexpr void serialize_(T &&elt) {
         serializeTuple(
             elt,
@@ -335,32 +790,146 @@ struct Serializer : Serialize<AdditionalTypes>... {
     /// @brief Deserialize function tuples (std::tuple and std::pair).
     /// @param elt Element that is deserialized.
     template <serializer::concepts::TupleLike T>
+        requires(!concepts::HasCodec<T>)
     inline constexpr void deserialize_(T &&elt) {
         deserializeTuple(
             elt,
             std::make_index_sequence<std::tuple_size_v<mtf::clean_t<T>>>());
     }
 
+    /* optionals **************************************************************/
+
+    /// @brief Serialize function for std::optional: a one byte flag followed
+    ///        by the value if there is one.
+    /// @param elt Element that is serialized.
+    template <serializer::concepts::Optional T>
+        requires(!concepts::HasCodec<T>)
+    inline constexpr void serialize_(T &&elt) {
+        appendTrivial(uint8_t(elt.has_value()));
+        if (elt.has_value()) {
+            serialize_(*elt);
+        }
+    }
+
+    /// @brief Deserialize function for std::optional. The value is constructed
+    ///        in place (the current value is reused if there is one).
+    /// @param elt Element that is deserialized.
+    /// @throw exceptions::CorruptedDataError if the flag is invalid.
+    template <serializer::concepts::Optional T>
+        requires(!concepts::HasCodec<T>)
+    inline constexpr void deserialize_(T &&elt) {
+        auto flag = deserializeTrivial<uint8_t>();
+        if (flag > 1) [[unlikely]] {
+            throw exceptions::CorruptedDataError(
+                "error: invalid optional flag " + std::to_string(flag) + ".");
+        }
+        if (flag == 0) {
+            elt.reset();
+            return;
+        }
+        if (!elt.has_value()) {
+            elt.emplace();
+        }
+        deserialize_(*elt);
+    }
+
+    /* variants ***************************************************************/
+
+    /// @brief Type of the index stored before the active alternative (the
+    ///        smallest unsigned integer that can hold the index).
+    template <typename V>
+    using variant_index_t =
+        std::conditional_t<(std::variant_size_v<V> <= 0xff), uint8_t,
+                           uint16_t>;
+
+    /// @brief Serialize function for std::variant: the index of the active
+    ///        alternative followed by its value (std::monostate takes no
+    ///        space).
+    /// @param elt Element that is serialized.
+    /// @throw std::bad_variant_access if the variant is valueless.
+    template <serializer::concepts::Variant T>
+        requires(!concepts::HasCodec<T>)
+    inline constexpr void serialize_(T &&elt) {
+        using V = mtf::clean_t<T>;
+        if (elt.valueless_by_exception()) [[unlikely]] {
+            throw std::bad_variant_access();
+        }
+        appendTrivial(variant_index_t<V>(elt.index()));
+        std::visit(
+            [this]<typename A>(A const &alt) {
+                if constexpr (!std::is_same_v<A, std::monostate>) {
+                    serialize_(alt);
+                }
+            },
+            elt);
+    }
+
+    /// @brief Deserialize the alternative I of a variant (constructed in place
+    ///        unless it is already the active one).
+    /// @param elt Variant that is deserialized.
+    template <size_t I, typename V>
+    inline constexpr void deserializeAlternative(V &elt) {
+        using A = std::variant_alternative_t<I, V>;
+        static_assert(std::is_default_constructible_v<A>,
+                      "The variant alternatives must be default constructible "
+                      "to be deserialized.");
+        if (elt.index() != I) {
+            elt.template emplace<I>();
+        }
+        if constexpr (!std::is_same_v<A, std::monostate>) {
+            deserialize_(std::get<I>(elt));
+        }
+    }
+
+    /// @brief Helper function for deserializing variants (the comparisons on
+    ///        the index are generated at compile time, so the compiler can
+    ///        turn them into a jump table).
+    /// @param elt Variant that is deserialized.
+    /// @param index Index of the active alternative.
+    template <typename V, size_t... Idx>
+    inline constexpr void deserializeVariant(V &elt, size_t index,
+                                             std::index_sequence<Idx...>) {
+        (void)((index == Idx &&
+                (deserializeAlternative<Idx>(elt), true)) ||
+               ...);
+    }
+
+    /// @brief Deserialize function for std::variant.
+    /// @param elt Element that is deserialized.
+    /// @throw exceptions::CorruptedDataError if the index is invalid.
+    template <serializer::concepts::Variant T>
+        requires(!concepts::HasCodec<T>)
+    inline constexpr void deserialize_(T &&elt) {
+        using V = mtf::clean_t<T>;
+        constexpr size_t size = std::variant_size_v<V>;
+        size_t index = deserializeTrivial<variant_index_t<V>>();
+        if (index >= size) [[unlikely]] {
+            throw exceptions::CorruptedDataError(
+                "error: invalid variant index " + std::to_string(index) +
+                " (" + std::to_string(size) + " alternatives).");
+        }
+        deserializeVariant(elt, index, std::make_index_sequence<size>());
+    }
+
     /* enums ******************************************************************/
 
     /// @brief Serialize function for the enum types. The underlying type is
     ///        used to store the data.
     /// @param elt Element that is serialized.
     template <serializer::concepts::Enum T>
-        requires(!concepts::Trivial<T>)
+        requires(!concepts::Trivial<T> && !concepts::HasCodec<T>)
     inline constexpr void serialize_(T &&elt) {
-        append(std::bit_cast<const byte_type *>(&elt), sizeof(elt));
+        appendTrivial(elt);
     }
 
     /// @brief Deserialize function for enum types. The data is stored using the
     ///        underlying type.
     /// @param elt Element that is deserialized.
     template <serializer::concepts::Enum T>
-        requires(!concepts::Trivial<T>)
+        requires(!concepts::Trivial<T> && !concepts::HasCodec<T>)
     inline constexpr void deserialize_(T &&elt) {
         using Type = std::underlying_type_t<mtf::clean_t<T>>;
-        elt = (mtf::clean_t<T>)*std::bit_cast<const Type *>(mem.data() + pos);
-        pos += sizeof(Type);
+        elt = (mtf::clean_t<T>)deserializeTrivial<Type>();
     }
 
     /* strings ****************************************************************/
@@ -368,22 +937,59 @@ struct Serializer : Serialize<AdditionalTypes>... {
     /// @brief Serialize function for strings.
     /// @param elt Element that is serialized.
     template <serializer::concepts::String T>
+        requires(!concepts::HasCodec<T> && !concepts::InternsStrings<MemT>)
     inline constexpr void serialize_(T &&elt) {
         using size_type = typename mtf::clean_t<T>::size_type;
-        size_type size = elt.size();
-        append(std::bit_cast<const byte_type *>(&size), sizeof(size));
-        append(std::bit_cast<const byte_type *>(elt.data()), elt.size());
+        appendSize(size_type(elt.size()));
+        appendBlock(std::bit_cast<const byte_type *>(elt.data()), elt.size());
     }
 
     /// @brief Deserialize function for strings.
     /// @param elt Element that is deserialized.
     template <serializer::concepts::String T>
+        requires(!concepts::HasCodec<T> && !concepts::InternsStrings<MemT>)
     inline constexpr void deserialize_(T &&str) {
         using size_type = typename mtf::clean_t<T>::size_type;
         size_type size = deserializeSize<size_type>();
         str.resize(size);
-        std::memcpy(str.data(), mem.data() + pos, size);
-        pos += size;
+        read(str.data(), size);
+    }
+
+    /// @brief Serialize function for the strings and the string views of the
+    ///        interned memories: the first occurrence of a string is written
+    ///        as 0 followed by the string, the next ones as the index + 1 of
+    ///        the string in the dictionary.
+    /// @param elt Element that is serialized.
+    template <serializer::concepts::InternableString T>
+        requires(!concepts::HasCodec<T> && concepts::InternsStrings<MemT>)
+    inline constexpr void serialize_(T &&elt) {
+        auto [index, inserted] = mem.strings().insert(std::string_view(elt));
+        if (!inserted) {
+            appendVarint(uint64_t(index + 1));
+            return;
+        }
+        appendVarint(0);
+        appendSize(size_t(elt.size()));
+        appendBlock(std::bit_cast<const byte_type *>(elt.data()), elt.size());
+    }
+
+    /// @brief Deserialize function for the strings and the string views of the
+    ///        interned memories. The string views refer to the dictionary
+    ///        entries.
+    /// @param elt Element that is deserialized.
+    template <serializer::concepts::InternableString T>
+        requires(!concepts::HasCodec<T> && concepts::InternsStrings<MemT>)
+    inline constexpr void deserialize_(T &&elt) {
+        size_t ref = size_t(deserializeVarint());
+        if (ref > 0) {
+            elt = mem.strings().get(ref - 1);
+            return;
+        }
+        std::string str;
+        size_t size = deserializeSize<size_t>();
+        str.resize(size);
+        read(str.data(), size);
+        elt = mem.strings().add(std::move(str));
     }
 
     /* iterable containers ****************************************************/
@@ -391,31 +997,97 @@ struct Serializer : Serialize<AdditionalTypes>... {
     /// @brief Serialize function for containers. They must be iterable.
     /// @param elt Element that is serialized.
     template <serializer::concepts::Container T>
-        requires(!concepts::Trivial<T> && !concepts::Serializable<T, MemT>)
+        requires(!concepts::Trivial<T> && !concepts::Serializable<T, MemT> &&
+                 !concepts::HasCodec<T> &&
+                 !(concepts::InternsStrings<MemT> && mtf::is_string_view_v<T>))
     inline constexpr void serialize_(T &&elts) {
-        using ValueType =
-            mtf::remove_const_t<mtf::iter_value_t<mtf::clean_t<T>>>;
-
         // append the size
-        auto size = elts.size();
-        append(std::bit_cast<const byte_type *>(&size), sizeof(size));
+        appendSize(elts.size());
 
         // if the type is trivial, the memory is serialized directly
-        if constexpr (concepts::ContiguousTrivial<T, MemT>) {
-            append(
-                std::bit_cast<const byte_type *>(std::to_address(elts.begin())),
-                sizeof(ValueType) * std::size(elts));
+        if constexpr (concepts::ContiguousTrivial<T, MemT> &&
+                      !is_custom_v<mtf::iter_value_t<T>>) {
+            appendArray(std::to_address(elts.begin()), std::size(elts));
+        } else if constexpr (std::contiguous_iterator<
+                                 decltype(std::begin(elts))> &&
+                             is_bitwise_v<mtf::iter_value_t<T>>) {
+            appendBitwise(std::to_address(elts.begin()), std::size(elts));
         } else {
+            // the tracked objects must be serialized in order
+            if constexpr (concepts::ParallelContainers<MemT> &&
+                          !concepts::TracksObjects<MemT> &&
+                          !concepts::InternsStrings<MemT> &&
+                          std::random_access_iterator<
+                              decltype(std::begin(elts))>) {
+                if (mem.parallel(std::size(elts))) {
+                    serializeParallel(elts);
+                    return;
+                }
+            }
             for (auto &elt : elts) {
                 serialize_(elt);
             }
         }
     }
 
+    /// @brief Serialize the elements of a random access container with several
+    ///        threads (tools::Parallel). The sizes of the elements are measured
+    ///        first, then each element is written at its offset in the memory
+    ///        (the measure and the writes keep the format of the memory, so
+    ///        the output is the same as the sequential one, the nested
+    ///        containers are serialized sequentially).
+    /// @param elts Elements that are serialized.
+    inline void serializeParallel(auto const &elts) {
+        using OutputMemT = std::remove_reference_t<MemT>;
+        using MeasureSer = rebind_t<tools::MeasureOf<OutputMemT>>;
+        using WriteSer = rebind_t<tools::Unchecked<OutputMemT>>;
+        static_assert(!concepts::Fetchable<OutputMemT> &&
+                          (concepts::Resizeable<OutputMemT> ||
+                           !concepts::Appendable<OutputMemT>),
+                      "The parallel serialization requires a memory that is "
+                      "accessible through data().");
+        size_t size = std::size(elts);
+        std::vector<size_t> offsets(size + 1, 0);
+        auto first = std::begin(elts);
+
+        // measure the elements and compute their offsets
+        tools::parallelFor(mem.nbThreads(), size, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                tools::MeasureOf<OutputMemT> measure;
+                MeasureSer serializer(measure);
+                serializer.serialize_(first[i]);
+                offsets[i + 1] = serializer.pos;
+            }
+        });
+        std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+        // allocate the memory once
+        size_t end = pos + offsets[size];
+        if constexpr (concepts::Resizeable<OutputMemT>) {
+            if (concepts::Appendable<OutputMemT> || mem.size() < end) {
+                mem.resize(end);
+            }
+        } else if (mem.size() < end) {
+            throw std::out_of_range(
+                "error: the serialization array is too small.");
+        }
+
+        // write the elements in their slots
+        tools::Unchecked<OutputMemT> unchecked(mem);
+        tools::parallelFor(mem.nbThreads(), size, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                WriteSer serializer(unchecked, pos + offsets[i]);
+                serializer.serialize_(first[i]);
+            }
+        });
+        pos = end;
+    }
+
     /// @brief Deserialize function for containers..
     /// @param elt Element that is deserialized.
     template <serializer::concepts::Container T>
-        requires(!concepts::Trivial<T> && !concepts::Deserializable<T, MemT>)
+        requires(!concepts::Trivial<T> && !concepts::Deserializable<T, MemT> &&
+                 !concepts::View<T> && !concepts::HasCodec<T>)
     inline constexpr void deserialize_(T &&elts) {
         using size_type = decltype(std::size(std::declval<T>()));
         using ValueType =
@@ -427,13 +1099,17 @@ struct Serializer : Serialize<AdditionalTypes>... {
             elts.resize(size);
         } else if constexpr (concepts::Clearable<T>) {
             elts.clear();
+            if constexpr (requires { elts.reserve(size); }) {
+                elts.reserve(size);
+            }
         }
 
-        if constexpr (concepts::ContiguousTrivial<T, MemT>) {
-            std::memcpy(
-                std::bit_cast<byte_type *>(std::to_address(elts.begin())),
-                mem.data() + pos, sizeof(ValueType) * size);
-            pos += sizeof(ValueType) * size;
+        if constexpr (concepts::ContiguousTrivial<T, MemT> &&
+                      !is_custom_v<ValueType>) {
+            readArray(std::to_address(elts.begin()), size);
+        } else if constexpr (std::contiguous_iterator<IterType> &&
+                             is_bitwise_v<ValueType>) {
+            read(std::to_address(elts.begin()), size * sizeof(ValueType));
         } else if constexpr (std::contiguous_iterator<IterType>) {
             for (auto &elt : elts) {
                 deserialize_(elt);
@@ -453,17 +1129,61 @@ struct Serializer : Serialize<AdditionalTypes>... {
         }
     }
 
+    /* views ******************************************************************/
+
+    /// @brief Deserialize function for views (std::string_view and std::span
+    ///        of trivial types). They use the same format as the strings and
+    ///        the containers, but the view points directly into the memory
+    ///        buffer (no allocation nor copy). The buffer must outlive the
+    ///        view and the elements must be aligned in the buffer (the format
+    ///        has no padding, so the position of the spans of elements larger
+    ///        than one byte depends on the previous members).
+    /// @param view Element that is deserialized.
+    /// @throw std::invalid_argument if the elements are not aligned.
+    template <serializer::concepts::View T>
+        requires(!concepts::HasCodec<T> &&
+                 !(concepts::InternsStrings<MemT> && mtf::is_string_view_v<T>))
+    inline constexpr void deserialize_(T &&view) {
+        using ViewType = mtf::clean_t<T>;
+        using ValueType = std::remove_cv_t<typename ViewType::value_type>;
+        using PtrType = decltype(view.data());
+        static_assert(concepts::Trivial<ValueType>,
+                      "Only the views on trivial types can be deserialized.");
+        static_assert(!concepts::Fetchable<mem_type>,
+                      "The views require a memory that is accessible through "
+                      "data().");
+        static_assert(!swap_bytes || sizeof(ValueType) == 1,
+                      "The views cannot be used when the bytes are swapped.");
+        if constexpr (mtf::is_span_v<T>) {
+            static_assert(ViewType::extent == std::dynamic_extent,
+                          "Only the spans with a dynamic extent can be "
+                          "deserialized.");
+        }
+        size_t size = deserializeSize<size_t>();
+        checkBounds(size * sizeof(ValueType));
+        auto addr = std::bit_cast<uintptr_t>(mem.data() + pos);
+        if (addr % alignof(ValueType) != 0) [[unlikely]] {
+            throw std::invalid_argument(
+                "error: the elements of the view are not aligned.");
+        }
+        view = ViewType(std::bit_cast<PtrType>(mem.data() + pos), size);
+        pos += size * sizeof(ValueType);
+    }
+
     /* static array ***********************************************************/
 
     /// @brief Serialize function for static arrays.
     /// @param elt Element that is serialized.
     template <serializer::concepts::StaticArray T>
+        requires(!concepts::HasCodec<T>)
     inline constexpr void serialize_(T &&elt) {
         size_t size = std::extent_v<mtf::clean_t<T>>;
 
-        if constexpr (concepts::TrivialySerializableStaticArray<T, MemT>) {
-            append(std::bit_cast<const byte_type *>(std::to_address(elt)),
-                   sizeof(elt[0]) * size);
+        if constexpr (concepts::TrivialySerializableStaticArray<T, MemT> &&
+                      !is_custom_v<std::remove_extent_t<mtf::clean_t<T>>>) {
+            appendArray(std::to_address(elt), size);
+        } else if constexpr (is_bitwise_v<std::remove_extent_t<T>>) {
+            appendBitwise(std::to_address(elt), size);
         } else {
             for (size_t i = 0; i < size; ++i) {
                 serialize_(elt[i]);
@@ -474,14 +1194,15 @@ struct Serializer : Serialize<AdditionalTypes>... {
     /// @brief Deserialize function for static arrays.
     /// @param elt Element that is deserialized.
     template <serializer::concepts::StaticArray T>
+        requires(!concepts::HasCodec<T>)
     inline constexpr void deserialize_(T &&elt) {
-        using ST = std::remove_extent_t<mtf::clean_t<T>>;
         size_t size = std::extent_v<mtf::clean_t<T>>;
 
-        if constexpr (concepts::TrivialyDeserializableStaticArray<T, MemT>) {
-            std::memcpy(std::to_address(elt), mem.data() + pos,
-                        sizeof(ST) * size);
-            pos += sizeof(ST) * size;
+        if constexpr (concepts::TrivialyDeserializableStaticArray<T, MemT> &&
+                      !is_custom_v<std::remove_extent_t<mtf::clean_t<T>>>) {
+            readArray(std::to_address(elt), size);
+        } else if constexpr (is_bitwise_v<std::remove_extent_t<T>>) {
+            read(std::to_address(elt), sizeof(elt));
         } else {
             for (size_t i = 0; i < size; ++i) {
                 deserialize_(elt[i]);
@@ -510,16 +1231,8 @@ struct Serializer : Serialize<AdditionalTypes>... {
                     elt.mem[i], tools::tuplePopFront(elt.dimensions)));
             }
         } else {
-            size_t size = tools::tupleProd<size_t>(elt.dimensions);
-            if constexpr (concepts::Trivial<ST> &&
-                          !concepts::Serializable<ST, MemT>) {
-                append(std::bit_cast<const byte_type *>(elt.mem),
-                       size * sizeof(ST));
-            } else {
-                for (size_t i = 0; i < size; ++i) {
-                    serialize_(elt.mem[i]);
-                }
-            }
+            serializeElements(elt.mem,
+                              tools::tupleProd<size_t>(elt.dimensions));
         }
     }
 
@@ -532,7 +1245,8 @@ struct Serializer : Serialize<AdditionalTypes>... {
     template <concepts::Pointer T, typename DT, typename... DTs>
     inline constexpr void deserialize_(tools::DynamicArray<T, DT, DTs...> elt) {
         using ST = std::remove_pointer_t<mtf::clean_t<T>>;
-        bool ptrValid = char(mem[pos++]) == 'v';
+        bool ptrValid = char(*fetch(1)) == 'v';
+        ++pos;
 
         if (!ptrValid) {
             elt.mem = nullptr;
@@ -541,8 +1255,9 @@ struct Serializer : Serialize<AdditionalTypes>... {
 
         if constexpr (std::is_pointer_v<ST>) {
             size_t size = (size_t)std::get<0>(elt.dimensions);
+            checkBounds(size);
             if (elt.mem == nullptr) {
-                elt.mem = new ST[size]();
+                elt.mem = allocator().template createArray<ST>(size);
             }
             for (size_t i = 0; i < size; ++i) {
                 deserialize_(tools::DynamicArray(
@@ -550,17 +1265,364 @@ struct Serializer : Serialize<AdditionalTypes>... {
             }
         } else {
             size_t size = tools::tupleProd<size_t>(elt.dimensions);
+            checkBounds(size);
             if (elt.mem == nullptr) {
-                elt.mem = new ST[size]();
+                elt.mem = allocator().template createArray<ST>(size);
+            }
+            deserializeElements(elt.mem, size);
+        }
+    }
+
+    /// @brief Serialize size elements stored contiguously (bulk copy when
+    ///        possible).
+    /// @param ptr Pointer to the first element.
+    /// @param size Number of elements.
+    template <typename ST>
+    inline constexpr void serializeElements(ST const *ptr, size_t size) {
+        if constexpr (concepts::Trivial<ST> && !is_custom_v<ST> &&
+                      !concepts::Serializable<ST, MemT>) {
+            appendArray(ptr, size);
+        } else if constexpr (is_bitwise_v<ST>) {
+            appendBitwise(ptr, size);
+        } else {
+            for (size_t i = 0; i < size; ++i) {
+                serialize_(ptr[i]);
+            }
+        }
+    }
+
+    /// @brief Deserialize size elements stored contiguously (bulk copy when
+    ///        possible).
+    /// @param ptr Pointer to the first element.
+    /// @param size Number of elements.
+    template <typename ST>
+    inline constexpr void deserializeElements(ST *ptr, size_t size) {
+        if constexpr (concepts::Trivial<ST> && !is_custom_v<ST> &&
+                      !concepts::Deserializable<ST, MemT>) {
+            readArray(ptr, size);
+        } else if constexpr (is_bitwise_v<ST>) {
+            read(ptr, size * sizeof(ST));
+        } else {
+            for (size_t i = 0; i < size; ++i) {
+                deserialize_(ptr[i]);
             }
-            if constexpr (concepts::Trivial<ST> &&
-                          !concepts::Deserializable<ST, MemT>) {
-                std::memcpy(elt.mem, mem.data() + pos, size * sizeof(ST));
-                pos += size * sizeof(ST);
+        }
+    }
+
+    /* contiguous array *******************************************************/
+
+    /// @brief Serialize function for the multi-dimensional arrays stored in
+    ///        one allocation (same format as a flat DynamicArray).
+    /// @param elt Element that is serialized.
+    template <concepts::Pointer T, typename... DTs>
+    inline constexpr void serialize_(tools::ContiguousArray<T, DTs...> elt) {
+        if (elt.mem == nullptr) {
+            append('n');
+            return;
+        }
+        append('v');
+        serializeElements(tools::firstElement(elt.mem),
+                          tools::tupleProd<size_t>(elt.dimensions));
+    }
+
+    /// @brief Deserialize function for the multi-dimensional arrays stored in
+    ///        one allocation. If the pointer is null, the elements and the
+    ///        tables of pointers are allocated (see tools::ContiguousArray).
+    /// @param elt Element that is deserialized.
+    template <concepts::Pointer T, typename... DTs>
+    inline constexpr void deserialize_(tools::ContiguousArray<T, DTs...> elt) {
+        using ET = std::remove_pointer_t<
+            decltype(tools::firstElement(std::declval<mtf::clean_t<T>>()))>;
+        bool ptrValid = char(*fetch(1)) == 'v';
+        ++pos;
+
+        if (!ptrValid) {
+            elt.mem = nullptr;
+            return;
+        }
+        size_t size = tools::tupleProd<size_t>(elt.dimensions);
+        checkBounds(size);
+        if (elt.mem == nullptr) {
+            std::array<size_t, sizeof...(DTs)> dims = std::apply(
+                [](auto const &...d) {
+                    return std::array<size_t, sizeof...(DTs)>{size_t(d)...};
+                },
+                elt.dimensions);
+            ET *block = allocator().template createArray<ET>(size);
+            elt.mem = tools::createLevels<mtf::clean_t<T>>(allocator(), block,
+                                                           dims);
+        }
+        deserializeElements(tools::firstElement(elt.mem), size);
+    }
+
+    /* encoded ****************************************************************/
+
+    /// @brief Serialize function for the members that use a numeric codec
+    ///        (see tools::Encoded).
+    /// @param elt Element that is serialized.
+    template <typename Codec, typename Data>
+    inline constexpr void serialize_(tools::Encoded<Codec, Data> elt) {
+        if constexpr (mtf::is_dynamic_array_v<Data>) {
+            using ST = std::remove_pointer_t<
+                mtf::clean_t<std::remove_reference_t<decltype(elt.data.mem)>>>;
+            static_assert(!std::is_pointer_v<ST>,
+                          "The codecs require one-dimensional arrays.");
+            if (elt.data.mem == nullptr) {
+                append('n');
+                return;
+            }
+            append('v');
+            elt.codec.encode(*this, static_cast<ST const *>(elt.data.mem),
+                             tools::tupleProd<size_t>(elt.data.dimensions));
+        } else {
+            static_assert(std::contiguous_iterator<decltype(std::begin(
+                              elt.data))>,
+                          "The codecs require contiguous containers.");
+            appendSize(std::size(elt.data));
+            elt.codec.encode(*this, std::data(elt.data), std::size(elt.data));
+        }
+    }
+
+    /// @brief Deserialize function for the members that use a numeric codec.
+    ///        With the bounds checked memories, the size of the containers is
+    ///        checked against the buffer (one byte per element), or against
+    ///        the maxSize of the codecs which elements can take less than one
+    ///        byte (see tools::SparseCodec).
+    /// @param elt Element that is deserialized.
+    /// @throw exceptions::CorruptedDataError if the size is invalid.
+    template <typename Codec, typename Data>
+    inline constexpr void deserialize_(tools::Encoded<Codec, Data> elt) {
+        if constexpr (mtf::is_dynamic_array_v<Data>) {
+            using ST = std::remove_pointer_t<
+                mtf::clean_t<std::remove_reference_t<decltype(elt.data.mem)>>>;
+            static_assert(!std::is_pointer_v<ST>,
+                          "The codecs require one-dimensional arrays.");
+            bool ptrValid = char(*fetch(1)) == 'v';
+            ++pos;
+            if (!ptrValid) {
+                elt.data.mem = nullptr;
+                return;
+            }
+            size_t size = tools::tupleProd<size_t>(elt.data.dimensions);
+            if (elt.data.mem == nullptr) {
+                elt.data.mem = allocator().template createArray<ST>(size);
+            }
+            elt.codec.decode(*this, elt.data.mem, size);
+        } else {
+            static_assert(concepts::ContiguousResizeable<Data>,
+                          "The codecs require contiguous containers.");
+            size_t size;
+            if constexpr (concepts::CompactSizes<mem_type>) {
+                size = size_t(deserializeVarint());
             } else {
-                for (size_t i = 0; i < size; ++i) {
-                    deserialize_(elt.mem[i]);
+                size = size_t(deserializeTrivial<
+                              decltype(std::size(elt.data))>());
+            }
+            if constexpr (requires { size_t(elt.codec.maxSize); }) {
+                if constexpr (concepts::BoundsChecked<mem_type>) {
+                    if (size > elt.codec.maxSize) [[unlikely]] {
+                        throw exceptions::CorruptedDataError(
+                            "error: the encoded container is too large.");
+                    }
                 }
+            } else {
+                checkBounds(size); // each element takes at least one byte
+            }
+            elt.data.resize(size);
+            elt.codec.decode(*this, std::data(elt.data), size);
+        }
+    }
+
+    /* strided array **********************************************************/
+
+    /// @brief Serialize function for the blocks of a row-major matrix (the
+    ///        rows are gathered, the elements outside of the block are not
+    ///        serialized).
+    /// @param elt Element that is serialized.
+    template <concepts::Pointer T, typename RT, typename CT, typename ST>
+    inline constexpr void serialize_(tools::StridedArray<T, RT, CT, ST> elt) {
+        if (elt.mem == nullptr) {
+            append('n');
+            return;
+        }
+        append('v');
+        size_t rows = size_t(elt.rows), cols = size_t(elt.cols);
+        size_t stride = size_t(elt.stride);
+        if (stride == cols) {
+            serializeElements(elt.mem, rows * cols);
+            return;
+        }
+        for (size_t r = 0; r < rows; ++r) {
+            serializeElements(elt.mem + r * stride, cols);
+        }
+    }
+
+    /// @brief Deserialize function for the blocks of a row-major matrix (the
+    ///        rows are scattered in the block, the other elements are not
+    ///        modified). If the pointer is null, rows * stride elements are
+    ///        allocated.
+    /// @param elt Element that is deserialized.
+    template <concepts::Pointer T, typename RT, typename CT, typename ST>
+    inline constexpr void deserialize_(tools::StridedArray<T, RT, CT, ST> elt) {
+        using ET = std::remove_pointer_t<mtf::clean_t<T>>;
+        bool ptrValid = char(*fetch(1)) == 'v';
+        ++pos;
+
+        if (!ptrValid) {
+            elt.mem = nullptr;
+            return;
+        }
+        size_t rows = size_t(elt.rows), cols = size_t(elt.cols);
+        size_t stride = size_t(elt.stride);
+        checkBounds(rows * cols);
+        if (elt.mem == nullptr) {
+            elt.mem = allocator().template createArray<ET>(rows * stride);
+        }
+        if (stride == cols) {
+            deserializeElements(elt.mem, rows * cols);
+            return;
+        }
+        for (size_t r = 0; r < rows; ++r) {
+            deserializeElements(elt.mem + r * stride, cols);
+        }
+    }
+
+#if defined(__cpp_lib_mdspan)
+    /* mdspan *****************************************************************/
+
+    /// @brief Serialize function for std::mdspan: the elements are serialized
+    ///        in row-major order (bulk copy for the contiguous layout_right
+    ///        views, strided gather otherwise).
+    /// @param elt Element that is serialized.
+    template <concepts::MdSpan T> inline constexpr void serialize_(T &&elt) {
+        using Span = mtf::clean_t<T>;
+        using ET = std::remove_cv_t<typename Span::element_type>;
+        if constexpr (std::is_same_v<typename Span::layout_type,
+                                     std::layout_right> &&
+                      std::is_same_v<typename Span::accessor_type,
+                                     std::default_accessor<
+                                         typename Span::element_type>>) {
+            serializeElements(static_cast<ET const *>(elt.data_handle()),
+                              elt.size());
+        } else {
+            tools::forEachIndex(elt,
+                                [this](auto const &e) { serialize_(e); });
+        }
+    }
+
+    /// @brief Deserialize function for std::mdspan: the view must refer to
+    ///        an allocated memory with the same extents as the serialized one.
+    /// @param elt Element that is deserialized.
+    template <concepts::MdSpan T> inline constexpr void deserialize_(T &&elt) {
+        using Span = mtf::clean_t<T>;
+        if constexpr (std::is_same_v<typename Span::layout_type,
+                                     std::layout_right> &&
+                      std::is_same_v<typename Span::accessor_type,
+                                     std::default_accessor<
+                                         typename Span::element_type>>) {
+            checkBounds(elt.size());
+            deserializeElements(elt.data_handle(), elt.size());
+        } else {
+            tools::forEachIndex(elt, [this](auto &e) { deserialize_(e); });
+        }
+    }
+#endif
+
+    /* columnar containers ****************************************************/
+
+    /// @brief Type of the tuple of the members of the elements of C.
+    template <typename C>
+    using columns_t = decltype(std::declval<mtf::iter_value_t<C> &>()
+                                   .serializedMembers());
+
+    /// @brief Number of elements of the chunks used to copy the trivial
+    ///        columns.
+    template <typename M>
+    static constexpr size_t column_chunk_v =
+        std::max(size_t(4096) / sizeof(M), size_t(1));
+
+    /// @brief True if the column of M values is stored contiguously.
+    template <typename M>
+    static constexpr bool is_trivial_column_v =
+        is_packable_v<M> && std::is_default_constructible_v<M>;
+
+    /// @brief Serialize function for the containers serialized column by
+    ///        column (SER_COLUMNS): [size][column 0][column 1]... The trivial
+    ///        members are gathered into chunks which are appended in bulk.
+    /// @param elt Element that is serialized.
+    template <typename C>
+    inline constexpr void serialize_(tools::Columnar<C> elt) {
+        using Type = mtf::clean_t<C>;
+        static_assert(
+            requires(mtf::iter_value_t<Type> &value) {
+                value.serializedMembers();
+            }, "The columnar containers require SERIALIZE elements.");
+        appendSize(std::size(elt.container));
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (serializeColumn<Is>(elt.container), ...);
+        }(std::make_index_sequence<std::tuple_size_v<columns_t<Type>>>());
+    }
+
+    /// @brief Serialize the member I of all the elements.
+    /// @param elts Container of SERIALIZE objects.
+    template <size_t I> inline constexpr void serializeColumn(auto &elts) {
+        using M = mtf::clean_t<
+            std::tuple_element_t<I, columns_t<mtf::clean_t<decltype(elts)>>>>;
+
+        if constexpr (is_trivial_column_v<M>) {
+            M chunk[column_chunk_v<M>];
+            size_t count = 0;
+            for (auto &value : elts) {
+                chunk[count++] = std::get<I>(value.serializedMembers());
+                if (count == column_chunk_v<M>) {
+                    appendArray(&chunk[0], count);
+                    count = 0;
+                }
+            }
+            appendArray(&chunk[0], count);
+        } else {
+            for (auto &value : elts) {
+                serialize_(std::get<I>(value.serializedMembers()));
+            }
+        }
+    }
+
+    /// @brief Deserialize function for the containers serialized column by
+    ///        column (SER_COLUMNS). The container must be resizeable.
+    /// @param elt Element that is deserialized.
+    template <typename C>
+    inline constexpr void deserialize_(tools::Columnar<C> elt) {
+        using Type = mtf::clean_t<C>;
+        static_assert(concepts::Resizeable<Type>,
+                      "The columnar containers must be resizeable.");
+        using size_type = decltype(std::size(elt.container));
+        size_type size = deserializeSize<size_type>();
+        elt.container.resize(size);
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (deserializeColumn<Is>(elt.container), ...);
+        }(std::make_index_sequence<std::tuple_size_v<columns_t<Type>>>());
+    }
+
+    /// @brief Deserialize the member I of all the elements.
+    /// @param elts Container of SERIALIZE objects (resized).
+    template <size_t I> inline constexpr void deserializeColumn(auto &elts) {
+        using M = mtf::clean_t<
+            std::tuple_element_t<I, columns_t<mtf::clean_t<decltype(elts)>>>>;
+
+        if constexpr (is_trivial_column_v<M>) {
+            M chunk[column_chunk_v<M>];
+            size_t size = std::size(elts);
+            auto it = std::begin(elts);
+            for (size_t i = 0; i < size; i += column_chunk_v<M>) {
+                size_t count = std::min(column_chunk_v<M>, size - i);
+                readArray(&chunk[0], count);
+                for (size_t j = 0; j < count; ++j, ++it) {
+                    std::get<I>(it->serializedMembers()) = chunk[j];
+                }
+            }
+        } else {
+            for (auto &value : elts) {
+                deserialize_(std::get<I>(value.serializedMembers()));
             }
         }
     }
@@ -0,0 +1,255 @@
+#ifndef SERIALIZER_ARENA_H
+#define SERIALIZER_ARENA_H
+#include "../meta/concepts.hpp"
+#include "../meta/type_check.hpp"
+#include "memory_wrapper.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                               new allocator                                */
+/******************************************************************************/
+
+/// @brief Default allocator used during the deserialization (the objects are
+///        allocated with new and should be deleted by the user).
+struct NewAllocator {
+    /// @brief Allocate a default constructed T.
+    template <typename T> T *create() { return new T(); }
+
+    /// @brief Allocate an array of size default constructed T.
+    template <typename T> T *createArray(size_t size) { return new T[size](); }
+
+    /// @brief Create a shared pointer on a default constructed T.
+    template <typename T> std::shared_ptr<T> makeShared() {
+        return std::make_shared<T>();
+    }
+
+    /// @brief Delete an object created with `create`.
+    template <typename T> void destroy(T *ptr) { delete ptr; }
+};
+
+/******************************************************************************/
+/*                                   arena                                    */
+/******************************************************************************/
+
+/// @brief Monotonic arena used to allocate the objects created during the
+///        deserialization. The memory is allocated by blocks and is never
+///        freed individually: `reset` frees all the objects at once (the
+///        blocks are kept for the next messages) and only the destructors of
+///        the non trivially destructible objects are called.
+///        Note: the objects created in the arena must not be deleted, and the
+///        owners of these objects (ex: destructors that delete the pointers)
+///        must not be used with the arena.
+class Arena {
+  public:
+    /* constructors & destructor **********************************************/
+
+    /// @brief Constructor.
+    /// @param blockSize Size of the memory blocks.
+    explicit Arena(size_t blockSize = 64 * 1024) : blockSize_(blockSize) {}
+
+    Arena(Arena const &) = delete;
+    Arena &operator=(Arena const &) = delete;
+
+    /// @brief Destructor (the objects are destroyed and the memory is freed).
+    ~Arena() { release(); }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the number of bytes allocated in the arena since the
+    ///        last release.
+    size_t size() const { return size_; }
+
+    /// @brief Returns the number of bytes reserved by the blocks.
+    size_t capacity() const {
+        size_t capacity = 0;
+        for (auto const &block : blocks_) {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    /* allocation *************************************************************/
+
+    /// @brief Allocate raw memory in the arena.
+    /// @param size  Number of bytes to allocate.
+    /// @param align Alignment of the memory.
+    /// @return Pointer to the allocated memory.
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        while (current_ < blocks_.size()) {
+            if (void *ptr = allocateInBlock(blocks_[current_], size, align)) {
+                size_ += size;
+                return ptr;
+            }
+            ++current_;
+            offset_ = 0;
+        }
+        size_t newBlockSize = std::max(blockSize_, size + align);
+        blocks_.push_back(
+            Block{std::make_unique<std::byte[]>(newBlockSize), newBlockSize});
+        current_ = blocks_.size() - 1;
+        offset_ = 0;
+        size_ += size;
+        return allocateInBlock(blocks_[current_], size, align);
+    }
+
+    /// @brief Allocate a default constructed T.
+    template <typename T> T *create() {
+        T *ptr = new (allocate(sizeof(T), alignof(T))) T();
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            finalizers_.push_back(Finalizer{&destroyArray<T>, ptr, 1});
+        }
+        return ptr;
+    }
+
+    /// @brief Allocate an array of size default constructed T.
+    template <typename T> T *createArray(size_t size) {
+        T *ptr = static_cast<T *>(allocate(sizeof(T) * size, alignof(T)));
+        for (size_t i = 0; i < size; ++i) {
+            new (ptr + i) T();
+        }
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            finalizers_.push_back(Finalizer{&destroyArray<T>, ptr, size});
+        }
+        return ptr;
+    }
+
+    /// @brief Create a shared pointer which object and control block are
+    ///        allocated in the arena. The object is destroyed by the shared
+    ///        pointer, but the arena must outlive it.
+    template <typename T> std::shared_ptr<T> makeShared();
+
+    /// @brief The objects are not deleted individually.
+    template <typename T> void destroy(T *) {}
+
+    /// @brief Destroy all the objects created in the arena. The memory blocks
+    ///        are kept for the next allocations.
+    void reset() {
+        for (auto it = finalizers_.rbegin(); it != finalizers_.rend(); ++it) {
+            it->destroy(it->ptr, it->size);
+        }
+        finalizers_.clear();
+        current_ = 0;
+        offset_ = 0;
+        size_ = 0;
+    }
+
+    /// @brief Destroy all the objects and free the memory blocks.
+    void release() {
+        reset();
+        blocks_.clear();
+    }
+
+  private:
+    /// @brief Block of memory.
+    struct Block {
+        std::unique_ptr<std::byte[]> mem; ///< memory of the block
+        size_t size;                      ///< size of the block
+    };
+
+    /// @brief Destructor of a non trivially destructible array of objects.
+    struct Finalizer {
+        void (*destroy)(void *, size_t); ///< destroy function
+        void *ptr;                       ///< first object
+        size_t size;                     ///< number of objects
+    };
+
+    std::vector<Block> blocks_;         ///< memory blocks
+    std::vector<Finalizer> finalizers_; ///< destructors to call on reset
+    size_t blockSize_;                  ///< default size of the blocks
+    size_t current_ = 0;                ///< current block
+    size_t offset_ = 0;                 ///< offset in the current block
+    size_t size_ = 0;                   ///< number of bytes allocated
+
+    /// @brief Try to allocate the memory in the given block.
+    /// @return Pointer to the memory or nullptr if there is not enough space.
+    void *allocateInBlock(Block &block, size_t size, size_t align) {
+        auto addr = reinterpret_cast<uintptr_t>(block.mem.get()) + offset_;
+        size_t padding = (align - addr % align) % align;
+
+        if (offset_ + padding + size > block.size) {
+            return nullptr;
+        }
+        void *ptr = block.mem.get() + offset_ + padding;
+        offset_ += padding + size;
+        return ptr;
+    }
+
+    /// @brief Call the destructors of size objects of type T.
+    template <typename T> static void destroyArray(void *ptr, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            static_cast<T *>(ptr)[i].~T();
+        }
+    }
+};
+
+/// @brief Standard allocator that allocates in an arena (deallocate does
+///        nothing).
+/// @tparam T Allocated type.
+template <typename T> struct ArenaAllocator {
+    using value_type = T;
+
+    /// @brief Constructor from the arena.
+    ArenaAllocator(Arena &arena) : arena(&arena) {}
+
+    /// @brief Rebind constructor.
+    template <typename U>
+    ArenaAllocator(ArenaAllocator<U> const &other) : arena(other.arena) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, size_t) {}
+
+    template <typename U>
+    bool operator==(ArenaAllocator<U> const &other) const {
+        return arena == other.arena;
+    }
+
+    Arena *arena; ///< arena in which the memory is allocated
+};
+
+template <typename T> std::shared_ptr<T> Arena::makeShared() {
+    return std::allocate_shared<T>(ArenaAllocator<T>(*this));
+}
+
+/******************************************************************************/
+/*                                 with arena                                 */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper that attaches an arena to the memory. When it
+///        is used for the deserialization, the pointers, the shared pointers,
+///        the dynamic arrays and the polymorphic types are allocated in the
+///        arena (the unique pointers are still allocated with new).
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class WithArena : public MemoryWrapper<MemT> {
+  public:
+    /* constructor ************************************************************/
+
+    /// @brief Constructor from the memory buffer and the arena.
+    /// @param mem   Memory buffer that contains the serialized data.
+    /// @param arena Arena used for the allocations.
+    constexpr WithArena(MemT &mem, Arena &arena)
+        : MemoryWrapper<MemT>(mem), arena_(arena) {}
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the arena.
+    constexpr Arena &arena() { return arena_; }
+
+  private:
+    Arena &arena_; ///< arena used for the allocations
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,297 @@
+#ifndef SERIALIZER_BATCH_H
+#define SERIALIZER_BATCH_H
+#include "../exceptions/corrupted_data.hpp"
+#include "../meta/concepts.hpp"
+#include "../serialize.hpp"
+#include "bytes.hpp"
+#include "parallel.hpp"
+#include "type_table.hpp"
+#include "verified.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                                   record                                   */
+/******************************************************************************/
+
+/// @brief Serialize one object of a batch (the member function is used when
+///        the object is serializable).
+template <typename MemT>
+inline constexpr size_t serializeRecord(MemT &mem, size_t pos,
+                                        auto const &obj) {
+    if constexpr (concepts::Serializable<decltype(obj), MemT>) {
+        return obj.serialize(mem, pos);
+    } else {
+        return serializer::serialize<Serializer<MemT>>(mem, pos, obj);
+    }
+}
+
+/// @brief Deserialize one object of a batch.
+template <typename MemT>
+inline constexpr size_t deserializeRecord(MemT &mem, size_t pos, auto &obj) {
+    if constexpr (concepts::Deserializable<decltype(obj), MemT>) {
+        return obj.deserialize(mem, pos);
+    } else {
+        return serializer::deserialize<Serializer<MemT>>(mem, pos, obj);
+    }
+}
+
+/// @brief Record of a batch. Each record is stored as:
+///        [id (TypeTable::id_type)][payload size (size_t)][payload].
+/// @tparam IdType Type of the identifiers.
+template <typename IdType> struct BatchRecord {
+    IdType id;   ///< identifier of the type of the record
+    size_t pos;  ///< position of the payload in the buffer
+    size_t size; ///< size of the payload
+};
+
+/******************************************************************************/
+/*                                batch writer                                */
+/******************************************************************************/
+
+/// @brief Append length-prefixed and id-tagged records into a memory buffer.
+///        The memory must give access to its data (the payload size is
+///        written once the object is serialized).
+/// @tparam TypeTable Type table of the objects of the batch.
+/// @tparam MemT Type of the memory buffer.
+template <typename TypeTable, typename MemT = Bytes<std::byte>>
+class BatchWriter {
+  public:
+    using id_type = typename TypeTable::id_type;
+    using record_type = BatchRecord<id_type>;
+    static constexpr size_t header_size = sizeof(id_type) + sizeof(size_t);
+
+    /// @brief Constructor.
+    /// @param mem Memory buffer in which the records are written.
+    /// @param pos Position of the first record in the buffer.
+    explicit BatchWriter(MemT &mem, size_t pos = 0) : mem_(mem), pos_(pos) {}
+
+    /// @brief Returns the position of the end of the batch.
+    size_t pos() const { return pos_; }
+
+    /// @brief Returns the number of records written.
+    size_t size() const { return size_; }
+
+    /// @brief Append a record. The type of the object must be in the table.
+    /// @param obj Object to serialize.
+    /// @return Record that has been written.
+    template <typename T> record_type write(T const &obj) {
+        static_assert(has_type_v<T, TypeTable>,
+                      "The type of the record must be in the type table.");
+        id_type id = getId<T>(TypeTable());
+        size_t payload = serializer::serialize<Serializer<MemT>>(
+            mem_, pos_, id, size_t(0));
+        size_t end = serializeRecord(mem_, payload, obj);
+        size_t size = end - payload;
+
+        std::memcpy(mem_.data() + pos_ + sizeof(id_type), &size,
+                    sizeof(size));
+        pos_ = end;
+        ++size_;
+        return record_type{id, payload, size};
+    }
+
+  private:
+    MemT &mem_;       ///< memory buffer
+    size_t pos_;      ///< end of the batch
+    size_t size_ = 0; ///< number of records
+};
+
+/******************************************************************************/
+/*                                batch reader                                */
+/******************************************************************************/
+
+/// @brief Iterate over the records of a batch and dispatch them. The records
+///        can be skipped in O(1) using the payload size. The payloads are
+///        deserialized with bounds checks limited to the record (see
+///        Verified), so a malformed record cannot read the next ones.
+/// @tparam TypeTable Type table of the objects of the batch.
+/// @tparam MemT Type of the memory buffer.
+template <typename TypeTable, typename MemT = Bytes<std::byte>>
+class BatchReader {
+  public:
+    using id_type = typename TypeTable::id_type;
+    using record_type = BatchRecord<id_type>;
+    static constexpr size_t header_size = sizeof(id_type) + sizeof(size_t);
+
+    /// @brief Iterator on the records.
+    class iterator {
+      public:
+        iterator(BatchReader const *reader, size_t pos)
+            : reader_(reader), pos_(pos) {
+            load();
+        }
+
+        record_type const &operator*() const { return record_; }
+        record_type const *operator->() const { return &record_; }
+
+        iterator &operator++() {
+            pos_ = record_.pos + record_.size;
+            load();
+            return *this;
+        }
+
+        bool operator==(iterator const &other) const {
+            return pos_ == other.pos_;
+        }
+
+      private:
+        BatchReader const *reader_;
+        size_t pos_;
+        record_type record_ = {};
+
+        void load() {
+            if (pos_ < reader_->end_) {
+                record_ = reader_->record(pos_);
+            }
+        }
+    };
+
+    /// @brief Constructor.
+    /// @param mem Memory buffer that contains the records.
+    /// @param pos Position of the first record.
+    /// @param end End of the batch.
+    BatchReader(MemT &mem, size_t pos, size_t end)
+        : mem_(mem), begin_(pos), end_(end) {}
+
+    /// @brief Constructor (the batch ends at the end of the buffer).
+    explicit BatchReader(MemT &mem, size_t pos = 0)
+        : BatchReader(mem, pos, mem.size()) {}
+
+    iterator begin() const { return iterator(this, begin_); }
+    iterator end() const { return iterator(this, end_); }
+
+    /// @brief Read the header of the record at pos.
+    /// @throw std::out_of_range if the record overflows the batch.
+    record_type record(size_t pos) const {
+        record_type record;
+
+        if (pos + header_size > end_) [[unlikely]] {
+            throw std::out_of_range("error: truncated batch record.");
+        }
+        std::memcpy(&record.id, mem_.data() + pos, sizeof(id_type));
+        std::memcpy(&record.size, mem_.data() + pos + sizeof(id_type),
+                    sizeof(size_t));
+        record.pos = pos + header_size;
+        if (record.size > end_ - record.pos) [[unlikely]] {
+            throw std::out_of_range("error: truncated batch record.");
+        }
+        return record;
+    }
+
+    /// @brief Deserialize the payload of the record into obj.
+    /// @throw std::logic_error if the type of obj doesn't match the record and
+    ///        exceptions::CorruptedDataError if the payload is invalid.
+    template <typename T> void read(record_type const &record, T &obj) const {
+        if (record.id != getId<T>(TypeTable())) [[unlikely]] {
+            throw std::logic_error(
+                "error: the record doesn't contain the given type.");
+        }
+        readPayload(record, obj);
+    }
+
+    /// @brief Deserialize the records and give them to the handler (as
+    ///        std::shared_ptr). The records which type is not handled (or
+    ///        which id is unknown) are skipped.
+    /// @param handler Function called with the shared pointers.
+    /// @return Number of records dispatched.
+    size_t dispatch(auto &&handler) const {
+        size_t count = 0;
+        for (auto const &record : *this) {
+            count += dispatch(record, handler);
+        }
+        return count;
+    }
+
+    /// @brief Deserialize one record and give it to the handler.
+    /// @return True if the record was dispatched.
+    /// @throw exceptions::CorruptedDataError if the payload is invalid.
+    bool dispatch(record_type const &record, auto &&handler) const {
+        bool dispatched = false;
+
+        if (!hasId(record.id, TypeTable())) {
+            return false;
+        }
+        applyId(record.id, TypeTable(), [&]<typename T>() {
+            if constexpr (std::is_invocable_v<decltype(handler),
+                                              std::shared_ptr<T>>) {
+                auto obj = std::make_shared<T>();
+                readPayload(record, *obj);
+                handler(obj);
+                dispatched = true;
+            }
+        });
+        return dispatched;
+    }
+
+  private:
+    MemT &mem_;    ///< memory buffer
+    size_t begin_; ///< position of the first record
+    size_t end_;   ///< end of the batch
+
+    /// @brief Deserialize the payload of the record into obj. The reads are
+    ///        limited to the payload and the whole payload must be read.
+    /// @throw exceptions::CorruptedDataError if the payload is invalid.
+    template <typename T>
+    void readPayload(record_type const &record, T &obj) const {
+        size_t end = record.pos + record.size;
+        Verified<MemT> verified(mem_, end);
+
+        if (deserializeRecord(verified, record.pos, obj) != end) [[unlikely]] {
+            throw exceptions::CorruptedDataError(
+                "error: the record doesn't match its payload size.");
+        }
+    }
+};
+
+/******************************************************************************/
+/*                       parallel batch deserialization                       */
+/******************************************************************************/
+
+/// @brief Deserialize the records of a batch with several threads. The offsets
+///        of the records are scanned once, then the threads pick chunks of
+///        records (see parallelFor), deserialize them and give them to the
+///        handler (see BatchReader::dispatch). The handler is called
+///        concurrently and must be thread-safe.
+/// @tparam TypeTable Type table of the objects of the batch.
+/// @param mem       Memory buffer that contains the batch.
+/// @param _         Type table.
+/// @param handler   Function called with the deserialized objects.
+/// @param nbThreads Number of threads (0 uses the number of cores).
+/// @return Number of records dispatched.
+/// @throw The first exception thrown by a thread (the other threads stop).
+template <typename TypeTable, typename MemT>
+size_t deserializeBatchParallel(MemT &mem, TypeTable, auto &&handler,
+                                size_t nbThreads = 0) {
+    static_assert(!concepts::Fetchable<MemT>,
+                  "The parallel deserialization requires a memory that is "
+                  "accessible through data().");
+    using Reader = BatchReader<TypeTable, MemT>;
+    Reader reader(mem);
+    std::vector<typename Reader::record_type> records;
+
+    for (auto const &record : reader) {
+        records.push_back(record);
+    }
+    std::atomic<size_t> count = 0;
+
+    parallelFor(nbThreads, records.size(), [&](size_t begin, size_t end) {
+        size_t dispatched = 0;
+        for (size_t i = begin; i < end; ++i) {
+            dispatched += reader.dispatch(records[i], handler);
+        }
+        count += dispatched;
+    });
+    return count;
+}
+
+} // end namespace serializer::tools
+
+#endif
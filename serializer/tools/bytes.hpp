@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <vector>
 
 /******************************************************************************/
 /*                                   bytes                                    */
@@ -11,10 +12,24 @@
 /// @brief namespace serializer tools
 namespace serializer::tools {
 
+/// @brief Inline storage of the small Bytes (empty when N is 0).
+template <typename T, size_t N> struct InlineStorage {
+    T bytes[N];
+    constexpr T *get() { return bytes; }
+    constexpr T const *get() const { return bytes; }
+};
+
+template <typename T> struct InlineStorage<T, 0> {
+    constexpr T *get() const { return nullptr; }
+};
+
 /// @brief Custom vector for serialization (std::vector interface is anoying to
 ///        used for the serialization).
-/// @tparam T Byte type (std::byte, uint8_t, char, ...).
-template <typename T>
+/// @tparam T       Byte type (std::byte, uint8_t, char, ...).
+/// @tparam InlineN Number of bytes stored inside the object: the buffer is
+///                 allocated on the heap only when it grows past InlineN
+///                 bytes (the small messages never allocate).
+template <typename T, size_t InlineN = 0>
   requires (sizeof(T) == sizeof(char))
 class Bytes {
   public:
@@ -28,28 +43,39 @@ class Bytes {
     constexpr Bytes() = default;
 
     /// @brief Constructor with capacity.
-    constexpr Bytes(size_t capacity)
-        : mem_(new T[capacity]), capacity_(capacity) {}
+    constexpr Bytes(size_t capacity) {
+        if (capacity > InlineN) {
+            mem_ = new T[capacity];
+            capacity_ = capacity;
+        }
+    }
 
     /// @brief constructor with a pointer and a size
     constexpr Bytes(T *ptr, size_t capacity, size_t size = 0)
         : mem_(ptr),capacity_(capacity), size_(size) {}
 
     /// @brief Copy constructor.
-    constexpr Bytes(Bytes<T> const &other)
-        : mem_(new T[other.capacity_]), capacity_(other.capacity_),
-          size_(other.size_) {
+    constexpr Bytes(Bytes<T, InlineN> const &other) : Bytes(other.capacity_) {
+        size_ = other.size_;
         std::memcpy(mem_, other.mem_, size_);
     }
 
-    /// @brief Move constructor.
-    constexpr Bytes(Bytes<T> &&other) noexcept
-        : mem_(other.mem_), capacity_(other.capacity_), size_(other.size_) {
-        other.mem_ = nullptr;
+    /// @brief Move constructor (the inline bytes are copied).
+    constexpr Bytes(Bytes<T, InlineN> &&other) noexcept {
+        if (other.isInline()) {
+            std::memcpy(mem_, other.mem_, other.size_);
+        } else {
+            mem_ = other.mem_;
+            capacity_ = other.capacity_;
+            other.mem_ = other.storage_.get();
+            other.capacity_ = InlineN;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
     }
 
     /// @brief Destructor.
-    constexpr ~Bytes() { delete[] mem_; }
+    constexpr ~Bytes() { release(); }
 
     /* accessors **************************************************************/
 
@@ -68,6 +94,11 @@ class Bytes {
     /// @breif Clear the buffer (set the size to 0 but do not reallocate).
     constexpr void clear() { size_ = 0; }
 
+    /// @brief True if the bytes are stored inside the object.
+    constexpr bool isInline() const {
+        return InlineN > 0 && mem_ == storage_.get();
+    }
+
     /* append *****************************************************************/
 
     /// @brief Appends some bytes at pos. The function is called "append" and
@@ -97,14 +128,32 @@ class Bytes {
         }
     }
 
+    /// @brief Increase the capacity of the buffer to exactly `capacity` bytes
+    ///        if it is too small (useful with serializedSize to allocate the
+    ///        memory only once).
+    /// @param capacity Minimal capacity of the buffer.
+    constexpr void reserve(size_t capacity) {
+        if (capacity > capacity_) {
+            alloc(capacity);
+        }
+    }
+
+    /// @brief Change the size of the buffer. The memory is reallocated to
+    ///        exactly `size` bytes if the capacity is too small.
+    /// @param size New size.
+    constexpr void resize(size_t size) {
+        reserve(size);
+        size_ = size;
+    }
+
     /// @brief Reallocate memory and change the capacity.
     /// @param newCapacity New capacity of the the buffer.
     constexpr void alloc(size_t newCapacity) {
+        T *tmp = new T[newCapacity];
+        std::memcpy(tmp, mem_, size_);
+        release();
+        mem_ = tmp;
         capacity_ = newCapacity;
-        T *tmp = mem_;
-        mem_ = new T[capacity_];
-        std::memcpy(mem_, tmp, size_);
-        delete[] tmp;
     }
 
     /* operators **************************************************************/
@@ -115,24 +164,50 @@ class Bytes {
     /// @brief Give read access to the byte `idx`
     constexpr T const &operator[](size_t idx) const { return mem_[idx]; }
 
-    /// @brief Copy assignment
-    constexpr Bytes<T> &operator=(Bytes<T> const &other) {
+    /// @brief Copy assignment (the memory is reallocated only if the capacity
+    ///        is too small).
+    constexpr Bytes<T, InlineN> &operator=(Bytes<T, InlineN> const &other) {
         if (&other == this) {
             return *this;
         }
-        capacity_ = other.capacity_;
-        delete[] mem_;
-        mem_ = new T[capacity_];
+        if (other.size_ > capacity_) {
+            release();
+            capacity_ = other.size_;
+            mem_ = new T[capacity_];
+        }
         size_ = other.size_;
         std::memcpy(mem_, other.mem_, size_);
         return *this;
     }
 
-    /// @brief Move assignment
-    constexpr Bytes<T> &operator=(Bytes<T> &&other) noexcept {
-        capacity_ = other.capacity_;
-        size_ = other.size_;
-        std::swap(this->mem, other.mem_);
+    /// @brief Move assignment (the buffers are swapped, so the old buffer is
+    ///        released with other). The inline bytes of other are copied.
+    constexpr Bytes<T, InlineN> &operator=(Bytes<T, InlineN> &&other) noexcept {
+        if (&other == this) {
+            return *this;
+        }
+        if (other.isInline()) {
+            if (other.size_ > capacity_) {
+                // external buffer smaller than the inline bytes
+                release();
+                mem_ = storage_.get();
+                capacity_ = InlineN;
+            }
+            std::memcpy(mem_, other.mem_, other.size_);
+            size_ = other.size_;
+            other.size_ = 0;
+        } else if (isInline()) {
+            mem_ = other.mem_;
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            other.mem_ = other.storage_.get();
+            other.capacity_ = InlineN;
+            other.size_ = 0;
+        } else {
+            std::swap(mem_, other.mem_);
+            std::swap(capacity_, other.capacity_);
+            std::swap(size_, other.size_);
+        }
         return *this;
     }
 
@@ -142,9 +217,17 @@ class Bytes {
     std::vector<T> vector() const { return std::vector<T>(mem_, mem_ + size_); }
 
   private:
-    T *mem_ = nullptr;    ///< bytes buffer
-    size_t capacity_ = 0; ///< capacity of the buffer
-    size_t size_ = 0;     ///< number of bytes stored
+    [[no_unique_address]] InlineStorage<T, InlineN> storage_; ///< inline bytes
+    T *mem_ = storage_.get();   ///< bytes buffer
+    size_t capacity_ = InlineN; ///< capacity of the buffer
+    size_t size_ = 0;           ///< number of bytes stored
+
+    /// @brief Free the heap buffer.
+    constexpr void release() {
+        if (!isInline()) {
+            delete[] mem_;
+        }
+    }
 };
 
 } // end namespace serializer::tools
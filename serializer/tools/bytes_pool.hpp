@@ -0,0 +1,136 @@
+#ifndef SERIALIZER_BYTES_POOL_H
+#define SERIALIZER_BYTES_POOL_H
+#include "bytes.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/******************************************************************************/
+/*                                 bytes pool                                 */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Thread-safe pool of byte buffers. The buffers are leased to the user
+///        and go back to the pool when the lease is destroyed. The capacity of
+///        the buffers is kept, so a send / receive loop that uses the pool
+///        doesn't allocate once the buffers are large enough.
+/// @tparam T Byte type (std::byte, uint8_t, char, ...).
+template <typename T> class BytesPool {
+  public:
+    /// @brief Buffer leased from the pool (it is given back to the pool when
+    ///        the lease is destroyed).
+    class Lease {
+      public:
+        /// @brief Constructor from the pool and the leased buffer.
+        Lease(BytesPool<T> &pool, Bytes<T> &&bytes)
+            : pool_(&pool), bytes_(std::move(bytes)) {}
+
+        Lease(Lease const &) = delete;
+        Lease &operator=(Lease const &) = delete;
+
+        /// @brief Move constructor.
+        Lease(Lease &&other) noexcept
+            : pool_(std::exchange(other.pool_, nullptr)),
+              bytes_(std::move(other.bytes_)) {}
+
+        /// @brief Move assignment (the current buffer is given back).
+        Lease &operator=(Lease &&other) noexcept {
+            if (&other != this) {
+                giveBack();
+                pool_ = std::exchange(other.pool_, nullptr);
+                bytes_ = std::move(other.bytes_);
+            }
+            return *this;
+        }
+
+        /// @brief Destructor (the buffer is given back to the pool).
+        ~Lease() { giveBack(); }
+
+        /// @brief Access to the buffer.
+        Bytes<T> &operator*() { return bytes_; }
+        Bytes<T> const &operator*() const { return bytes_; }
+        Bytes<T> *operator->() { return &bytes_; }
+        Bytes<T> const *operator->() const { return &bytes_; }
+
+        /// @brief Take the buffer out of the pool (it will not be given back).
+        Bytes<T> release() {
+            pool_ = nullptr;
+            return std::move(bytes_);
+        }
+
+      private:
+        BytesPool<T> *pool_; ///< pool (nullptr if the buffer is released)
+        Bytes<T> bytes_;     ///< leased buffer
+
+        void giveBack() {
+            if (pool_) {
+                pool_->recycle(std::move(bytes_));
+                pool_ = nullptr;
+            }
+        }
+    };
+
+    /* constructor ************************************************************/
+
+    /// @brief Default constructor.
+    BytesPool() = default;
+
+    /// @brief Constructor.
+    /// @param capacity Minimal capacity of the buffers created by the pool.
+    explicit BytesPool(size_t capacity) : capacity_(capacity) {}
+
+    BytesPool(BytesPool<T> const &) = delete;
+    BytesPool<T> &operator=(BytesPool<T> const &) = delete;
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the number of buffers available in the pool.
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return buffers_.size();
+    }
+
+    /* lease / recycle ********************************************************/
+
+    /// @brief Lease an empty buffer which capacity is at least `capacity`. A
+    ///        buffer is created only if the pool is empty.
+    /// @param capacity Minimal capacity of the buffer.
+    /// @return Lease of the buffer.
+    Lease acquire(size_t capacity = 0) {
+        Bytes<T> bytes;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!buffers_.empty()) {
+                bytes = std::move(buffers_.back());
+                buffers_.pop_back();
+            }
+        }
+        bytes.clear();
+        bytes.reserve(std::max(capacity, capacity_));
+        return Lease(*this, std::move(bytes));
+    }
+
+    /// @brief Give a buffer to the pool (it doesn't need to come from the
+    ///        pool).
+    /// @param bytes Buffer to add to the pool.
+    void recycle(Bytes<T> &&bytes) {
+        if (bytes.capacity() == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.push_back(std::move(bytes));
+    }
+
+  private:
+    mutable std::mutex mutex_;      ///< protects the buffers
+    std::vector<Bytes<T>> buffers_; ///< available buffers
+    size_t capacity_ = 4096;        ///< minimal capacity of the buffers
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,414 @@
+#ifndef SERIALIZER_CHANNEL_H
+#define SERIALIZER_CHANNEL_H
+#include "batch.hpp"
+#include "bytes.hpp"
+#include "bytes_pool.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                               async channel                                */
+/******************************************************************************/
+
+/// @brief Asynchronous channel over a socket or a pipe (Linux, epoll). The
+///        messages are batch records ([id][payload size][payload], see
+///        BatchWriter). A background thread writes the submitted buffers and
+///        reads the incoming data, so the serialization of the next messages
+///        overlaps the I/O of the previous ones:
+///        - the submitted buffers are owned by the channel and written
+///          directly (writev, no copy), then given back to the pool,
+///        - the received bytes are read into pooled buffers which are handed
+///          to `dispatch` once they contain whole records (only the bytes of
+///          an incomplete record at the end of a read are copied into the
+///          next buffer).
+///        The payload sizes are written in the native byte order. The file
+///        descriptor is set to non-blocking mode and is not closed by the
+///        channel.
+/// @tparam TypeTable Type table of the messages.
+/// @tparam T Byte type.
+template <typename TypeTable, typename T = std::byte> class AsyncChannel {
+  public:
+    using id_type = typename TypeTable::id_type;
+    static constexpr size_t header_size = sizeof(id_type) + sizeof(size_t);
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Constructor (starts the I/O thread).
+    /// @param fd        File descriptor (socket, pipe, ...).
+    /// @param chunkSize Number of bytes read at once.
+    /// @throw std::system_error if the channel cannot be created.
+    explicit AsyncChannel(int fd, size_t chunkSize = 65536)
+        : fd_(fd), chunkSize_(std::max(chunkSize, header_size)),
+          pool_(chunkSize_), rx_(pool_.acquire().release()) {
+        int flags = ::fcntl(fd_, F_GETFL);
+        if (flags < 0 || ::fcntl(fd_, F_SETFL, flags | O_NONBLOCK) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: fcntl");
+        }
+        epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+        wake_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epoll_ < 0 || wake_ < 0) {
+            int error = errno;
+            closeFds();
+            throw std::system_error(error, std::generic_category(),
+                                    "error: epoll");
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = wake_;
+        ::epoll_ctl(epoll_, EPOLL_CTL_ADD, wake_, &event);
+        event.events = events_;
+        event.data.fd = fd_;
+        if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd_, &event) < 0) {
+            int error = errno;
+            closeFds();
+            throw std::system_error(error, std::generic_category(),
+                                    "error: epoll_ctl");
+        }
+        thread_ = std::thread([this] { run(); });
+    }
+
+    AsyncChannel(AsyncChannel const &) = delete;
+    AsyncChannel &operator=(AsyncChannel const &) = delete;
+
+    /// @brief Destructor (stops the I/O thread, the buffers that are not
+    ///        written yet are dropped, so flush should be called before).
+    ~AsyncChannel() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wakeUp();
+        thread_.join();
+        closeFds();
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the pool of the buffers used by the channel.
+    BytesPool<T> &pool() { return pool_; }
+
+    /// @brief Returns true if the peer closed the connection and all the
+    ///        received buffers have been dispatched.
+    bool closed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return eof_ && received_.empty();
+    }
+
+    /* send *******************************************************************/
+
+    /// @brief Serialize a message in a pooled buffer and submit it.
+    /// @param obj Message (its type must be in the type table).
+    template <typename Msg> void send(Msg const &obj) {
+        auto lease = pool_.acquire();
+        BatchWriter<TypeTable, Bytes<T>> writer(*lease);
+        writer.write(obj);
+        submit(lease.release());
+    }
+
+    /// @brief Submit a buffer that contains whole records (see BatchWriter).
+    ///        The channel takes the ownership of the buffer, which goes to the
+    ///        pool once written.
+    /// @param bytes Buffer to write.
+    /// @throw The error of the I/O thread if any.
+    void submit(Bytes<T> &&bytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            checkError();
+            submitted_.push_back(std::move(bytes));
+            ++nbPending_;
+        }
+        wakeUp();
+    }
+
+    /// @brief Wait until all the submitted buffers are written.
+    /// @throw The error of the I/O thread if any.
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [&] { return nbPending_ == 0 || error_; });
+        checkError();
+    }
+
+    /* receive ****************************************************************/
+
+    /// @brief Wait for received messages and give them to the handler (see
+    ///        BatchReader::dispatch).
+    /// @param handler Function called with the shared pointers.
+    /// @return Number of messages dispatched (0 if the channel is closed).
+    /// @throw The error of the I/O thread if any.
+    size_t dispatch(auto &&handler) { return dispatch(handler, true); }
+
+    /// @brief Give the messages that are already received to the handler
+    ///        (doesn't wait).
+    /// @param handler Function called with the shared pointers.
+    /// @return Number of messages dispatched.
+    /// @throw The error of the I/O thread if any.
+    size_t tryDispatch(auto &&handler) { return dispatch(handler, false); }
+
+  private:
+    int fd_;                          ///< file descriptor
+    int epoll_ = -1;                  ///< epoll instance
+    int wake_ = -1;                   ///< eventfd used to wake the I/O thread
+    size_t chunkSize_;                ///< size of the reads
+    BytesPool<T> pool_;               ///< pool of the buffers
+    std::thread thread_;              ///< I/O thread
+    mutable std::mutex mutex_;        ///< protects the queues and the state
+    std::condition_variable cond_;    ///< signals the written / read data
+    std::vector<Bytes<T>> submitted_; ///< buffers submitted by the user
+    std::deque<Bytes<T>> received_;   ///< buffers of whole records
+    size_t nbPending_ = 0;            ///< number of buffers to write
+    std::exception_ptr error_;        ///< error of the I/O thread
+    bool stop_ = false;               ///< true when the channel is destroyed
+    bool eof_ = false;                ///< true when the peer is closed
+
+    // accessed by the I/O thread only
+    std::deque<Bytes<T>> writing_; ///< buffers being written
+    size_t written_ = 0;           ///< bytes written of the first buffer
+    Bytes<T> rx_;                  ///< buffer being read
+    uint32_t events_ = EPOLLIN;    ///< epoll events of the file descriptor
+    bool socket_ = true;           ///< false if sendmsg is not supported
+
+    /* helper functions *******************************************************/
+
+    void closeFds() {
+        if (epoll_ >= 0) {
+            ::close(epoll_);
+        }
+        if (wake_ >= 0) {
+            ::close(wake_);
+        }
+    }
+
+    void wakeUp() {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t count = ::write(wake_, &one, sizeof(one));
+    }
+
+    bool eof() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return eof_;
+    }
+
+    void checkError() const {
+        if (error_) [[unlikely]] {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    size_t dispatch(auto &handler, bool wait) {
+        std::deque<Bytes<T>> buffers;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (wait) {
+                cond_.wait(lock, [&] {
+                    return !received_.empty() || eof_ || error_;
+                });
+            }
+            if (received_.empty()) {
+                checkError();
+            }
+            std::swap(buffers, received_);
+        }
+        size_t count = 0;
+        for (Bytes<T> &bytes : buffers) {
+            count += BatchReader<TypeTable, Bytes<T>>(bytes).dispatch(handler);
+            pool_.recycle(std::move(bytes));
+        }
+        return count;
+    }
+
+    /* I/O thread *************************************************************/
+
+    void run() {
+        try {
+            epoll_event events[2];
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (stop_) {
+                        return;
+                    }
+                    for (Bytes<T> &bytes : submitted_) {
+                        writing_.push_back(std::move(bytes));
+                    }
+                    submitted_.clear();
+                }
+                if (!eof()) {
+                    readAvailable();
+                }
+                writeAvailable();
+                updateEvents();
+                int nb = ::epoll_wait(epoll_, events, 2, -1);
+                if (nb < 0 && errno != EINTR) {
+                    throw std::system_error(errno, std::generic_category(),
+                                            "error: epoll_wait");
+                }
+                for (int i = 0; i < nb; ++i) {
+                    if (events[i].data.fd == wake_) {
+                        uint64_t value;
+                        [[maybe_unused]] ssize_t count =
+                            ::read(wake_, &value, sizeof(value));
+                    }
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            cond_.notify_all();
+        }
+    }
+
+    /// @brief Read until the socket is empty and publish the whole records.
+    void readAvailable() {
+        for (;;) {
+            rx_.reserve(rx_.size() + chunkSize_);
+            ssize_t count = ::read(fd_, rx_.data() + rx_.size(),
+                                   rx_.capacity() - rx_.size());
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return;
+                }
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: read");
+            }
+            if (count == 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                eof_ = true;
+                cond_.notify_all();
+                return;
+            }
+            rx_.resize(rx_.size() + size_t(count));
+            publish();
+        }
+    }
+
+    /// @brief Move the whole records to the received queue (the incomplete
+    ///        record at the end is copied into a new buffer).
+    void publish() {
+        size_t end = 0;
+        size_t size = 0;
+        while (end + header_size <= rx_.size()) {
+            std::memcpy(&size, rx_.data() + end + sizeof(id_type),
+                        sizeof(size_t));
+            if (size > rx_.size() - end - header_size) {
+                break;
+            }
+            end += header_size + size;
+        }
+        if (end == 0) {
+            return;
+        }
+        size_t rest = rx_.size() - end;
+        size_t capacity = rest >= header_size ? header_size + size : 0;
+        Bytes<T> next = pool_.acquire(std::max(capacity, chunkSize_)).release();
+        next.append(0, rx_.data() + end, rest);
+        rx_.resize(end);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            received_.push_back(std::move(rx_));
+            cond_.notify_all();
+        }
+        rx_ = std::move(next);
+    }
+
+    /// @brief Write the pending buffers until the socket is full.
+    void writeAvailable() {
+        while (!writing_.empty()) {
+            iovec iov[16];
+            size_t nb = std::min(writing_.size(), std::size(iov));
+            for (size_t i = 0; i < nb; ++i) {
+                size_t offset = i == 0 ? written_ : 0;
+                iov[i].iov_base = writing_[i].data() + offset;
+                iov[i].iov_len = writing_[i].size() - offset;
+            }
+            ssize_t count = write(iov, nb);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return;
+                }
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: writev");
+            }
+            written_ += size_t(count);
+            size_t done = 0;
+            while (!writing_.empty() && written_ >= writing_.front().size()) {
+                written_ -= writing_.front().size();
+                pool_.recycle(std::move(writing_.front()));
+                writing_.pop_front();
+                ++done;
+            }
+            if (done > 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                nbPending_ -= done;
+                cond_.notify_all();
+            }
+        }
+    }
+
+    /// @brief Write the buffers (the sockets are written with MSG_NOSIGNAL so
+    ///        a closed peer gives EPIPE instead of SIGPIPE).
+    ssize_t write(iovec *iov, size_t nb) {
+        if (socket_) {
+            msghdr msg{};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = nb;
+            ssize_t count = ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+            if (count >= 0 || errno != ENOTSOCK) {
+                return count;
+            }
+            socket_ = false;
+        }
+        return ::writev(fd_, iov, int(nb));
+    }
+
+    /// @brief Wait for the file descriptor to be writable only if there is
+    ///        data to write (it is removed from epoll when there is nothing to
+    ///        wait for, the hang ups are always reported).
+    void updateEvents() {
+        uint32_t events = (eof() ? 0 : uint32_t(EPOLLIN)) |
+                          (writing_.empty() ? 0 : uint32_t(EPOLLOUT));
+        if (events == events_) {
+            return;
+        }
+        int op = events_ == 0 ? EPOLL_CTL_ADD
+                 : events == 0 ? EPOLL_CTL_DEL
+                               : EPOLL_CTL_MOD;
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd_;
+        if (::epoll_ctl(epoll_, op, fd_, &event) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: epoll_ctl");
+        }
+        events_ = events;
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
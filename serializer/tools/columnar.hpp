@@ -0,0 +1,27 @@
+#ifndef SERIALIZER_COLUMNAR_HPP
+#define SERIALIZER_COLUMNAR_HPP
+#include "../meta/concepts.hpp"
+
+/******************************************************************************/
+/*                                  Columnar                                  */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Wrapper object for the containers of SERIALIZE objects that are
+///        serialized column by column (structure of arrays): the size, then
+///        the first member of all the elements, then the second member, ...
+///        The trivial columns are stored contiguously. The ids of the elements
+///        are not serialized.
+template <concepts::Iterable C> struct Columnar {
+    /// @brief Constructor.
+    /// @param container Reference to the container.
+    constexpr explicit Columnar(C &container) : container(container) {}
+
+    C &container; ///< reference to the container
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef SERIALIZER_COMPACT_H
+#define SERIALIZER_COMPACT_H
+#include "memory_wrapper.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                                   varint                                   */
+/******************************************************************************/
+
+/// @brief Maximum number of bytes of a LEB128 encoded 64 bits integer.
+constexpr size_t varint_max_size = 10;
+
+/// @brief Encode an unsigned integer using LEB128 (7 bits per byte, the high
+///        bit is set when more bytes follow).
+/// @param value Value to encode.
+/// @param bytes Output buffer (at least varint_max_size bytes).
+/// @return Number of bytes written.
+template <typename T>
+inline constexpr size_t varintEncode(uint64_t value, T *bytes) {
+    size_t size = 0;
+    while (value >= 0x80) {
+        bytes[size++] = T((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    bytes[size++] = T(value);
+    return size;
+}
+
+/// @brief Map the signed integers to unsigned integers so that the small
+///        negative values have small encodings (0, -1, 1, -2 -> 0, 1, 2, 3).
+inline constexpr uint64_t zigzagEncode(int64_t value) {
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+/// @brief Inverse of zigzagEncode.
+inline constexpr int64_t zigzagDecode(uint64_t value) {
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+/******************************************************************************/
+/*                                  compact                                   */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper that enables the compact encoding: the sizes
+///        of the strings and the containers are encoded with LEB128 varints
+///        and, if Integers is true, the integer members (bigger than one byte)
+///        are encoded with (zigzag) varints. The integers stored in the
+///        containers of trivial types are still copied directly.
+/// @tparam MemT Type of the wrapped memory buffer.
+/// @tparam Integers Enable the compact encoding of the integer members.
+template <typename MemT, bool Integers = false>
+class Compact : public MemoryWrapper<MemT> {
+  public:
+    static constexpr bool compact_sizes = true;
+    static constexpr bool compact_integers =
+        Integers || concepts::CompactIntegers<MemT>;
+
+    /// @brief Constructor from the wrapped memory buffer.
+    constexpr explicit Compact(MemT &mem) : MemoryWrapper<MemT>(mem) {}
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,448 @@
+#ifndef SERIALIZER_COMPRESSION_H
+#define SERIALIZER_COMPRESSION_H
+#include "../exceptions/corrupted_data.hpp"
+#include "../meta/concepts.hpp"
+#include "../meta/type_check.hpp"
+#include "../serialize.hpp"
+#include "endian.hpp"
+#include "stream.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#ifdef SERIALIZER_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SERIALIZER_WITH_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+#ifdef SERIALIZER_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                                   codecs                                   */
+/******************************************************************************/
+
+/// @brief Compression codecs. The codecs other than Store are available only
+///        if the library is linked and the corresponding macro is defined
+///        (SERIALIZER_WITH_ZLIB, SERIALIZER_WITH_LZ4, SERIALIZER_WITH_ZSTD).
+enum class Codec : uint8_t {
+    Store = 0,   ///< no compression
+    Deflate = 1, ///< zlib
+    LZ4 = 2,     ///< lz4 (fast, lower ratio)
+    Zstd = 3,    ///< zstd
+};
+
+/// @brief Compression settings given to serializeCompressed.
+struct Compression {
+    /// @brief Maximal size of the uncompressed frames (the chunk size is
+    ///        clamped to it, and the frames that declare a larger size are
+    ///        rejected by the reader before anything is allocated).
+    static constexpr size_t maxChunkSize = size_t(64) * 1024 * 1024;
+
+    Codec codec = Codec::Store;   ///< codec used for the frames
+    int level = 0;                ///< level (0 is the codec default level)
+    size_t chunkSize = 64 * 1024; ///< size of the uncompressed frames
+};
+
+/// @brief Returns true if the codec is compiled in.
+inline constexpr bool codecAvailable(Codec codec) {
+    switch (codec) {
+    case Codec::Store:
+        return true;
+#ifdef SERIALIZER_WITH_ZLIB
+    case Codec::Deflate:
+        return true;
+#endif
+#ifdef SERIALIZER_WITH_LZ4
+    case Codec::LZ4:
+        return true;
+#endif
+#ifdef SERIALIZER_WITH_ZSTD
+    case Codec::Zstd:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+/// @brief Implementation of the codecs.
+namespace compression_impl {
+
+/// @brief Returns the maximal size of a compressed chunk of size bytes.
+inline size_t compressBound(Codec codec, size_t size) {
+    switch (codec) {
+#ifdef SERIALIZER_WITH_ZLIB
+    case Codec::Deflate:
+        return (size_t)::compressBound((uLong)size);
+#endif
+#ifdef SERIALIZER_WITH_LZ4
+    case Codec::LZ4:
+        return (size_t)LZ4_compressBound((int)size);
+#endif
+#ifdef SERIALIZER_WITH_ZSTD
+    case Codec::Zstd:
+        return ZSTD_compressBound(size);
+#endif
+    default:
+        return size;
+    }
+}
+
+/// @brief Compress a chunk.
+/// @return Size of the compressed data (0 if the compression failed, the
+///         chunk is then stored).
+inline size_t compress([[maybe_unused]] Compression const &compression,
+                       [[maybe_unused]] unsigned char const *src,
+                       [[maybe_unused]] size_t size,
+                       [[maybe_unused]] unsigned char *dest,
+                       [[maybe_unused]] size_t capacity) {
+    switch (compression.codec) {
+#ifdef SERIALIZER_WITH_ZLIB
+    case Codec::Deflate: {
+        uLongf destSize = (uLongf)capacity;
+        int level = compression.level == 0 ? Z_DEFAULT_COMPRESSION
+                                           : compression.level;
+        int status = ::compress2(dest, &destSize, src, (uLong)size, level);
+        return status == Z_OK ? (size_t)destSize : 0;
+    }
+#endif
+#ifdef SERIALIZER_WITH_LZ4
+    case Codec::LZ4: {
+        auto s = reinterpret_cast<char const *>(src);
+        auto d = reinterpret_cast<char *>(dest);
+        int result;
+        if (compression.level > 0) {
+            result = LZ4_compress_HC(s, d, (int)size, (int)capacity,
+                                     compression.level);
+        } else if (compression.level < 0) {
+            result = LZ4_compress_fast(s, d, (int)size, (int)capacity,
+                                       -compression.level);
+        } else {
+            result = LZ4_compress_default(s, d, (int)size, (int)capacity);
+        }
+        return result > 0 ? (size_t)result : 0;
+    }
+#endif
+#ifdef SERIALIZER_WITH_ZSTD
+    case Codec::Zstd: {
+        size_t result =
+            ZSTD_compress(dest, capacity, src, size, compression.level);
+        return ZSTD_isError(result) ? 0 : result;
+    }
+#endif
+    default:
+        return 0;
+    }
+}
+
+/// @brief Decompress a chunk of rawSize bytes.
+/// @throw std::runtime_error if the chunk cannot be decompressed.
+inline void decompress(Codec codec, unsigned char const *src, size_t size,
+                       unsigned char *dest, size_t rawSize) {
+    bool valid = false;
+
+    switch (codec) {
+    case Codec::Store:
+        valid = size == rawSize;
+        if (valid) {
+            std::memcpy(dest, src, size);
+        }
+        break;
+#ifdef SERIALIZER_WITH_ZLIB
+    case Codec::Deflate: {
+        uLongf destSize = (uLongf)rawSize;
+        valid = ::uncompress(dest, &destSize, src, (uLong)size) == Z_OK &&
+                destSize == rawSize;
+        break;
+    }
+#endif
+#ifdef SERIALIZER_WITH_LZ4
+    case Codec::LZ4:
+        valid = LZ4_decompress_safe(reinterpret_cast<char const *>(src),
+                                    reinterpret_cast<char *>(dest), (int)size,
+                                    (int)rawSize) == (int)rawSize;
+        break;
+#endif
+#ifdef SERIALIZER_WITH_ZSTD
+    case Codec::Zstd:
+        valid = ZSTD_decompress(dest, rawSize, src, size) == rawSize;
+        break;
+#endif
+    default:
+        throw std::runtime_error("error: unsupported compression codec.");
+    }
+    if (!valid) [[unlikely]] {
+        throw std::runtime_error("error: invalid compressed frame.");
+    }
+}
+
+/// @brief Header of the frames: [codec (1 byte)][raw size (4 bytes)][stored
+///        size (4 bytes)], the sizes are little endian. A frame with a raw
+///        size of 0 ends the compressed data.
+constexpr size_t header_size = 9;
+
+/// @brief Convert a size of a frame header from / to little endian.
+inline uint32_t littleEndian(uint32_t value) {
+    if constexpr (std::endian::native == std::endian::big) {
+        return byteswap(value);
+    } else {
+        return value;
+    }
+}
+
+} // end namespace compression_impl
+
+/******************************************************************************/
+/*                             compressed output                              */
+/******************************************************************************/
+
+/// @brief Stream that compresses the written data into frames appended to a
+///        memory buffer. It is used with a StreamWriter, so the frames are
+///        compressed as the data is produced (one frame per flush of the
+///        writer buffer). The frames that don't shrink are stored.
+/// @tparam MemT Type of the memory buffer that receives the frames.
+template <typename MemT> class CompressedOutput {
+  public:
+    using byte_type = mtf::byte_type_t<MemT>;
+
+    /// @brief Constructor.
+    /// @param mem         Memory buffer in which the frames are written.
+    /// @param pos         Position of the first frame.
+    /// @param compression Compression settings.
+    /// @throw std::invalid_argument if the codec is not available.
+    CompressedOutput(MemT &mem, size_t pos, Compression const &compression)
+        : mem_(mem), pos_(pos), compression_(compression) {
+        if (!codecAvailable(compression.codec)) {
+            throw std::invalid_argument(
+                "error: the compression codec is not available.");
+        }
+        compression_.chunkSize = std::clamp(compression.chunkSize, size_t(1),
+                                            Compression::maxChunkSize);
+    }
+
+    /// @brief Returns the position after the last frame.
+    size_t pos() const { return pos_; }
+
+    /// @brief Compress the bytes into frames of at most chunkSize bytes.
+    void write(char const *bytes, size_t nbBytes) {
+        auto src = reinterpret_cast<unsigned char const *>(bytes);
+        while (nbBytes > 0) {
+            size_t size = std::min(nbBytes, compression_.chunkSize);
+            writeFrame(src, size);
+            src += size;
+            nbBytes -= size;
+        }
+    }
+
+    /// @brief Write the frame that ends the compressed data.
+    void finish() { writeFrame(nullptr, 0); }
+
+  private:
+    MemT &mem_;                          ///< output memory buffer
+    size_t pos_;                         ///< position of the next frame
+    Compression compression_;            ///< compression settings
+    std::vector<unsigned char> scratch_; ///< compressed data
+
+    /// @brief Compress a chunk and append its frame.
+    void writeFrame(unsigned char const *src, size_t size) {
+        Codec codec = Codec::Store;
+        unsigned char const *payload = src;
+        size_t stored = size;
+
+        if (size > 0 && compression_.codec != Codec::Store) {
+            scratch_.resize(
+                compression_impl::compressBound(compression_.codec, size));
+            size_t compressed = compression_impl::compress(
+                compression_, src, size, scratch_.data(), scratch_.size());
+            if (compressed > 0 && compressed < size) {
+                codec = compression_.codec;
+                payload = scratch_.data();
+                stored = compressed;
+            }
+        }
+
+        unsigned char header[compression_impl::header_size];
+        uint32_t raw32 = compression_impl::littleEndian(uint32_t(size));
+        uint32_t stored32 = compression_impl::littleEndian(uint32_t(stored));
+        header[0] = (unsigned char)codec;
+        std::memcpy(header + 1, &raw32, 4);
+        std::memcpy(header + 5, &stored32, 4);
+        append(header, compression_impl::header_size);
+        append(payload, stored);
+    }
+
+    /// @brief Append bytes to the memory.
+    void append(unsigned char const *bytes, size_t nbBytes) {
+        auto ptr = reinterpret_cast<byte_type const *>(bytes);
+        if constexpr (concepts::Appendable<MemT>) {
+            mem_.append(pos_, ptr, nbBytes);
+        } else {
+            if (mem_.size() < pos_ + nbBytes) {
+                if constexpr (concepts::Resizeable<MemT>) {
+                    mem_.resize((mem_.size() + nbBytes) * 2);
+                } else {
+                    throw std::out_of_range(
+                        "error: the serialization array is too small.");
+                }
+            }
+            std::memcpy(mem_.data() + pos_, ptr, nbBytes);
+        }
+        pos_ += nbBytes;
+    }
+};
+
+/******************************************************************************/
+/*                              compressed input                              */
+/******************************************************************************/
+
+/// @brief Stream that decompresses the frames written by a CompressedOutput.
+///        It is used with a StreamReader.
+/// @tparam MemT Type of the memory buffer that contains the frames.
+template <typename MemT> class CompressedInput {
+  public:
+    /// @brief Constructor.
+    /// @param mem Memory buffer that contains the frames.
+    /// @param pos Position of the first frame.
+    CompressedInput(MemT &mem, size_t pos) : mem_(mem), pos_(pos) {}
+
+    /// @brief Returns the position of the next frame.
+    size_t pos() const { return pos_; }
+
+    /// @brief Read at most nbBytes decompressed bytes.
+    /// @return Number of bytes read (0 at the end of the compressed data).
+    size_t read(char *bytes, size_t nbBytes) {
+        while (offset_ == buffer_.size()) {
+            if (ended_) {
+                return 0;
+            }
+            loadFrame();
+        }
+        size_t count = std::min(nbBytes, buffer_.size() - offset_);
+        std::memcpy(bytes, buffer_.data() + offset_, count);
+        offset_ += count;
+        return count;
+    }
+
+    /// @brief Skip the remaining frames (pos is then the end of the
+    ///        compressed data).
+    void finish() {
+        while (!ended_) {
+            loadFrame();
+        }
+    }
+
+  private:
+    MemT &mem_;                          ///< input memory buffer
+    size_t pos_;                         ///< position of the next frame
+    std::vector<unsigned char> buffer_;  ///< decompressed frame
+    size_t offset_ = 0;                  ///< read position in the frame
+    bool ended_ = false;                 ///< true after the last frame
+
+    /// @brief Decompress the next frame.
+    /// @throw std::out_of_range if the frame is truncated and
+    ///        exceptions::CorruptedDataError if its size exceeds
+    ///        Compression::maxChunkSize.
+    void loadFrame() {
+        auto data = reinterpret_cast<unsigned char const *>(mem_.data());
+        uint32_t raw, stored;
+
+        if (pos_ > mem_.size() ||
+            mem_.size() - pos_ < compression_impl::header_size) [[unlikely]] {
+            throw std::out_of_range("error: truncated compressed frame.");
+        }
+        auto codec = Codec(data[pos_]);
+        std::memcpy(&raw, data + pos_ + 1, 4);
+        std::memcpy(&stored, data + pos_ + 5, 4);
+        raw = compression_impl::littleEndian(raw);
+        stored = compression_impl::littleEndian(stored);
+        pos_ += compression_impl::header_size;
+        if (stored > mem_.size() - pos_) [[unlikely]] {
+            throw std::out_of_range("error: truncated compressed frame.");
+        }
+        if (raw > Compression::maxChunkSize) [[unlikely]] {
+            throw exceptions::CorruptedDataError(
+                "error: the compressed frame is too large.");
+        }
+        buffer_.resize(raw);
+        offset_ = 0;
+        ended_ = raw == 0;
+        if (!ended_) {
+            compression_impl::decompress(codec, data + pos_, stored,
+                                         buffer_.data(), raw);
+        }
+        pos_ += stored;
+    }
+};
+
+/******************************************************************************/
+/*                          compressed serialization                          */
+/******************************************************************************/
+
+/// @brief Serialize the arguments into compressed frames. The data is
+///        compressed by chunks while it is serialized (the serializer writes
+///        into a StreamWriter which buffer is compressed each time it is
+///        flushed), so there is no second pass over the serialized data.
+/// @param mem         Buffer in which the compressed frames will be stored.
+/// @param pos         Start position in the buffer.
+/// @param compression Codec, level and chunk size.
+/// @param args        Values to serialize
+/// @return Position of the next element in the buffer.
+/// @throw std::invalid_argument if the codec is not available.
+inline size_t serializeCompressed(auto &mem, size_t pos,
+                                  Compression const &compression,
+                                  auto const &...args) {
+    using mem_t = std::remove_reference_t<decltype(mem)>;
+    using output_t = CompressedOutput<mem_t>;
+    bool first_level = pos == 0;
+    output_t output(mem, pos, compression);
+    {
+        StreamWriter<output_t> writer(
+            output, std::clamp(compression.chunkSize, size_t(1),
+                               Compression::maxChunkSize));
+        serializer::serialize<Serializer<decltype(writer)>>(writer, 0,
+                                                            args...);
+        writer.flush();
+    }
+    output.finish();
+    if constexpr (!concepts::Appendable<mem_t> &&
+                  concepts::Resizeable<mem_t>) {
+        if (first_level) [[unlikely]] {
+            mem.resize(output.pos());
+        }
+    }
+    return output.pos();
+}
+
+/// @brief Deserialize data serialized with serializeCompressed. The frames
+///        are decompressed one by one while the data is deserialized.
+/// @param mem  Buffer that contains the compressed frames.
+/// @param pos  Start position in the buffer.
+/// @param args references to the variables that are deserialized.
+/// @return Position after the compressed frames.
+/// @throw std::runtime_error if a frame cannot be decompressed,
+///        std::out_of_range if the frames are truncated and
+///        exceptions::CorruptedDataError if a frame is too large.
+inline size_t deserializeCompressed(auto &mem, size_t pos, auto &&...args) {
+    using mem_t = std::remove_reference_t<decltype(mem)>;
+    using input_t = CompressedInput<mem_t>;
+    input_t input(mem, pos);
+    StreamReader<input_t> reader(input);
+
+    serializer::deserialize<Serializer<decltype(reader)>>(reader, 0, args...);
+    input.finish();
+    return input.pos();
+}
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef SERIALIZER_CRC32C_H
+#define SERIALIZER_CRC32C_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define SERIALIZER_CRC32C_X86
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define SERIALIZER_CRC32C_ARM
+#endif
+
+/******************************************************************************/
+/*                                   crc32c                                   */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Implementation of the crc32c functions.
+namespace crc32c_impl {
+
+/// @brief Reversed Castagnoli polynomial.
+constexpr uint32_t polynomial = 0x82f63b78;
+
+/// @brief Lookup table of the software implementation.
+constexpr std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> result = {};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (size_t bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (crc & 1 ? polynomial : 0);
+        }
+        result[i] = crc;
+    }
+    return result;
+}();
+
+/// @brief Software implementation (used when the CRC instructions are not
+///        available).
+inline uint32_t update(uint32_t crc, unsigned char const *bytes, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef SERIALIZER_CRC32C_X86
+/// @brief SSE4.2 implementation.
+__attribute__((target("sse4.2"))) inline uint32_t
+updateSSE42(uint32_t crc, unsigned char const *bytes, size_t size) {
+    uint64_t crc64 = crc;
+    for (; size >= 8; size -= 8, bytes += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = (uint32_t)crc64;
+    for (; size > 0; --size, ++bytes) {
+        crc = _mm_crc32_u8(crc, *bytes);
+    }
+    return crc;
+}
+#endif
+
+#ifdef SERIALIZER_CRC32C_ARM
+/// @brief ARMv8 CRC implementation.
+inline uint32_t updateARM(uint32_t crc, unsigned char const *bytes,
+                          size_t size) {
+    for (; size >= 8; size -= 8, bytes += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes, 8);
+        crc = __crc32cd(crc, word);
+    }
+    for (; size > 0; --size, ++bytes) {
+        crc = __crc32cb(crc, *bytes);
+    }
+    return crc;
+}
+#endif
+
+} // end namespace crc32c_impl
+
+/// @brief Compute the CRC32C (Castagnoli) of a buffer. The SSE4.2 instructions
+///        are used on x86 when the cpu supports them (detected at runtime) and
+///        the CRC instructions are used on ARMv8 when they are enabled.
+/// @param data Buffer.
+/// @param size Number of bytes.
+/// @param crc  CRC of the previous bytes (used to compute the CRC by parts).
+/// @return CRC32C of the buffer.
+inline uint32_t crc32c(void const *data, size_t size, uint32_t crc = 0) {
+    auto bytes = static_cast<unsigned char const *>(data);
+    crc = ~crc;
+#if defined(SERIALIZER_CRC32C_X86)
+    static const bool sse42 = __builtin_cpu_supports("sse4.2");
+    crc = sse42 ? crc32c_impl::updateSSE42(crc, bytes, size)
+                : crc32c_impl::update(crc, bytes, size);
+#elif defined(SERIALIZER_CRC32C_ARM)
+    crc = crc32c_impl::updateARM(crc, bytes, size);
+#else
+    crc = crc32c_impl::update(crc, bytes, size);
+#endif
+    return ~crc;
+}
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef SERIALIZER_DELTA_H
+#define SERIALIZER_DELTA_H
+#include "../meta/concepts.hpp"
+#include "../serialize.hpp"
+#include "bytes.hpp"
+#include "memory_wrapper.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                              member recorder                               */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper that records the end position of each member
+///        of the serialized object (the arguments of its SERIALIZE). Only the
+///        members of the outermost object are recorded and the trivial members
+///        are not packed so each member has its own range.
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class MemberRecorder : public MemoryWrapper<MemT> {
+  public:
+    static constexpr bool track_members = true;
+
+    /// @brief Constructor.
+    /// @param mem     Memory buffer in which the object is serialized.
+    /// @param offsets Receives the start position of the object followed by
+    ///                the end positions of its members.
+    MemberRecorder(MemT &mem, std::vector<size_t> &offsets)
+        : MemoryWrapper<MemT>(mem), offsets_(offsets) {
+        offsets_.clear();
+    }
+
+    /// @brief Called when the serialization of an object starts.
+    void enter(size_t pos) {
+        if (depth_++ == 0) {
+            offsets_.push_back(pos);
+        }
+    }
+
+    /// @brief Called when the serialization of an object ends.
+    void leave() { --depth_; }
+
+    /// @brief Called after the serialization of a member.
+    void member(size_t pos) {
+        if (depth_ == 1) {
+            offsets_.push_back(pos);
+        }
+    }
+
+  private:
+    std::vector<size_t> &offsets_; ///< member offsets
+    size_t depth_ = 0;             ///< depth of the nested objects
+};
+
+/******************************************************************************/
+/*                              member selector                               */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper used to apply a patch: only the members of the
+///        outermost object which bit is set are deserialized (the others keep
+///        their value).
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class MemberSelector : public MemoryWrapper<MemT> {
+  public:
+    static constexpr bool track_members = true;
+
+    /// @brief Constructor.
+    /// @param mem     Memory buffer that contains the changed members.
+    /// @param changed Bitmap of the changed members.
+    MemberSelector(MemT &mem, std::vector<uint8_t> const &changed)
+        : MemoryWrapper<MemT>(mem), changed_(changed) {}
+
+    /// @brief Returns the number of members of the outermost object.
+    size_t nbMembers() const { return nbMembers_; }
+
+    /// @brief Called when the deserialization of an object starts.
+    void enter(size_t) { ++depth_; }
+
+    /// @brief Called when the deserialization of an object ends.
+    void leave() { --depth_; }
+
+    /// @brief Returns true if the next member should be deserialized.
+    bool select() {
+        if (depth_ != 1) {
+            return true;
+        }
+        size_t idx = nbMembers_++;
+        return idx / 8 < changed_.size() && (changed_[idx / 8] >> idx % 8) & 1;
+    }
+
+  private:
+    std::vector<uint8_t> const &changed_; ///< bitmap of the changed members
+    size_t depth_ = 0;                    ///< depth of the nested objects
+    size_t nbMembers_ = 0;                ///< number of members seen
+};
+
+/******************************************************************************/
+/*                                  snapshot                                  */
+/******************************************************************************/
+
+/// @brief Last serialized state of an object, used by serializeDelta to find
+///        the members that have changed. The buffers are reused from one call
+///        to the other.
+/// @tparam T Byte type.
+template <typename T = std::byte> class Snapshot {
+  public:
+    /// @brief Returns the serialized object.
+    Bytes<T> const &bytes() const { return bytes_; }
+
+    /// @brief Returns the number of members (0 if the snapshot is empty).
+    size_t nbMembers() const {
+        return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+
+    /// @brief Clear the snapshot (the next delta contains all the members).
+    void clear() {
+        bytes_.clear();
+        offsets_.clear();
+    }
+
+  private:
+    Bytes<T> bytes_;                  ///< serialized object
+    std::vector<size_t> offsets_;     ///< member offsets
+    Bytes<T> next_;                   ///< buffer of the next snapshot
+    std::vector<size_t> nextOffsets_; ///< offsets of the next snapshot
+    std::vector<uint8_t> changed_;    ///< bitmap of the changed members
+
+    template <typename U>
+    friend size_t serializeDelta(auto &mem, size_t pos, Snapshot<U> &snapshot,
+                                 auto const &obj);
+};
+
+/******************************************************************************/
+/*                                   delta                                    */
+/******************************************************************************/
+
+/// @brief Serialize the members of obj that have changed since the snapshot
+///        (all the members if the snapshot is empty), and update the snapshot.
+///        The object must use SERIALIZE. The patch is stored as:
+///        [number of members (size_t)][bitmap of the changed members]
+///        [serialized changed members].
+/// @param mem      Buffer in which the patch is written.
+/// @param pos      Position of the patch in the buffer.
+/// @param snapshot Previous state of the object (updated).
+/// @param obj      Object to serialize.
+/// @return Position of the next element in the buffer.
+/// @throw std::logic_error if the object doesn't have serialized members.
+template <typename T>
+size_t serializeDelta(auto &mem, size_t pos, Snapshot<T> &snapshot,
+                      auto const &obj) {
+    using mem_t = std::remove_reference_t<decltype(mem)>;
+    MemberRecorder<Bytes<T>> recorder(snapshot.next_, snapshot.nextOffsets_);
+
+    snapshot.next_.clear();
+    obj.serialize(recorder, 0);
+    if (snapshot.nextOffsets_.size() < 2) [[unlikely]] {
+        throw std::logic_error(
+            "error: the delta serialization requires SERIALIZE members.");
+    }
+
+    // compare the members with the snapshot
+    auto const &offsets = snapshot.nextOffsets_;
+    size_t nbMembers = offsets.size() - 1;
+    bool sameLayout = snapshot.nbMembers() == nbMembers;
+    snapshot.changed_.assign((nbMembers + 7) / 8, 0);
+    for (size_t i = 0; i < nbMembers; ++i) {
+        size_t size = offsets[i + 1] - offsets[i];
+        bool same = sameLayout &&
+                    snapshot.offsets_[i + 1] - snapshot.offsets_[i] == size &&
+                    std::memcmp(snapshot.next_.data() + offsets[i],
+                                snapshot.bytes_.data() + snapshot.offsets_[i],
+                                size) == 0;
+        if (!same) {
+            snapshot.changed_[i / 8] |= uint8_t(1 << i % 8);
+        }
+    }
+
+    // write the patch
+    Serializer<mem_t> serializer(
+        mem, serialize<Serializer<mem_t>>(mem, pos, nbMembers));
+    serializer.append(
+        reinterpret_cast<mtf::byte_type_t<mem_t> const *>(
+            snapshot.changed_.data()),
+        snapshot.changed_.size());
+    for (size_t i = 0; i < nbMembers; ++i) {
+        if ((snapshot.changed_[i / 8] >> i % 8) & 1) {
+            serializer.append(
+                reinterpret_cast<mtf::byte_type_t<mem_t> const *>(
+                    snapshot.next_.data() + offsets[i]),
+                offsets[i + 1] - offsets[i]);
+        }
+    }
+    if constexpr (!concepts::Appendable<mem_t> &&
+                  concepts::Resizeable<mem_t>) {
+        if (pos == 0) {
+            mem.resize(serializer.pos);
+        }
+    }
+    std::swap(snapshot.bytes_, snapshot.next_);
+    std::swap(snapshot.offsets_, snapshot.nextOffsets_);
+    return serializer.pos;
+}
+
+/// @brief Apply a patch created by serializeDelta: the changed members are
+///        deserialized into obj, the others are not modified.
+/// @param mem Buffer that contains the patch.
+/// @param pos Position of the patch in the buffer.
+/// @param obj Object to update.
+/// @return Position of the next element in the buffer.
+/// @throw std::logic_error if the patch doesn't match the members of obj.
+inline size_t deserializeDelta(auto &mem, size_t pos, auto &obj) {
+    using mem_t = std::remove_reference_t<decltype(mem)>;
+    size_t nbMembers = 0;
+    Serializer<mem_t> serializer(
+        mem, deserialize<Serializer<mem_t>>(mem, pos, nbMembers));
+    std::vector<uint8_t> changed((nbMembers + 7) / 8);
+
+    serializer.read(changed.data(), changed.size());
+    MemberSelector<mem_t> selector(mem, changed);
+    size_t end = obj.deserialize(selector, serializer.pos);
+    if (selector.nbMembers() != nbMembers) [[unlikely]] {
+        throw std::logic_error(
+            "error: the patch doesn't match the members of the object.");
+    }
+    return end;
+}
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,312 @@
+#ifndef SERIALIZER_DISPATCHER_H
+#define SERIALIZER_DISPATCHER_H
+#include "batch.hpp"
+#include "type_table.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                                 mpmc queue                                 */
+/******************************************************************************/
+
+/// @brief Bounded lock-free multi-producer multi-consumer queue. Each cell
+///        has a sequence number that tells whether it can be written or read
+///        for the current lap, so the producers and the consumers only
+///        compete on their own cursor.
+/// @tparam T Type of the elements (default constructible and movable).
+template <typename T> class MpmcQueue {
+  public:
+    /// @brief Constructor.
+    /// @param capacity Capacity of the queue (rounded up to a power of 2).
+    explicit MpmcQueue(size_t capacity)
+        : mask_(std::bit_ceil(std::max(capacity, size_t(2))) - 1),
+          cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Add an element (the function doesn't block).
+    /// @return False if the queue is full (value is not moved).
+    bool tryPush(T &value) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Remove an element (the function doesn't block).
+    /// @return False if the queue is empty.
+    bool tryPop(T &value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = intptr_t(seq) - intptr_t(pos + 1);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + mask_ + 1,
+                                        std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Returns the capacity of the queue.
+    size_t capacity() const { return mask_ + 1; }
+
+  private:
+    struct Cell {
+        std::atomic<size_t> sequence; ///< lap of the cell
+        T value;
+    };
+    size_t mask_;                           ///< capacity - 1
+    std::unique_ptr<Cell[]> cells_;         ///< ring of cells
+    alignas(64) std::atomic<size_t> head_ = 0; ///< next cell to write
+    alignas(64) std::atomic<size_t> tail_ = 0; ///< next cell to read
+};
+
+/******************************************************************************/
+/*                                 dispatcher                                 */
+/******************************************************************************/
+
+/// @brief Multi-threaded dispatcher of the objects of a type table. Each type
+///        has its own bounded queue (see MpmcQueue) and a pool of worker
+///        threads runs the handler on the queued objects. The messages are
+///        deserialized by the threads that call receive / receiveBatch (the
+///        deserialization stage) and the objects can also be posted directly
+///        (for instance by the handlers, to chain the tasks). When a queue is
+///        full, the posting thread runs the queued jobs itself until there is
+///        room (back-pressure without deadlock when the handlers post). The
+///        handler is called concurrently and must be thread-safe; the objects
+///        of the same type can be processed out of order.
+/// @tparam TypeTable Type table of the objects.
+template <typename TypeTable> class Dispatcher {
+    using Job = std::shared_ptr<void>;
+
+  public:
+    using id_type = typename TypeTable::id_type;
+
+    /* constructor & destructor ***********************************************/
+
+    /// @brief Constructor (starts the workers).
+    /// @param _             Type table.
+    /// @param handler       Function called with the objects (std::shared_ptr
+    ///                      of the types of the table). The types for which
+    ///                      the handler is not invocable are not dispatched.
+    /// @param nbThreads     Number of workers (0 uses the number of cores).
+    /// @param queueCapacity Capacity of the queue of each type.
+    template <typename Handler>
+    Dispatcher(TypeTable, Handler &&handler, size_t nbThreads = 0,
+               size_t queueCapacity = 1024) {
+        auto shared = std::make_shared<std::decay_t<Handler>>(
+            std::forward<Handler>(handler));
+        handlers_.resize(TypeTable::size);
+        for (size_t id = 0; id < TypeTable::size; ++id) {
+            queues_.push_back(std::make_unique<MpmcQueue<Job>>(queueCapacity));
+            applyId(id, TypeTable(), [&]<typename T>() {
+                if constexpr (std::is_invocable_v<Handler &,
+                                                  std::shared_ptr<T>>) {
+                    handlers_[id] = [shared](Job const &job) {
+                        (*shared)(std::static_pointer_cast<T>(job));
+                    };
+                }
+            });
+        }
+        if (nbThreads == 0) {
+            nbThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        for (size_t i = 0; i < nbThreads; ++i) {
+            workers_.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    Dispatcher(Dispatcher const &) = delete;
+    Dispatcher &operator=(Dispatcher const &) = delete;
+
+    /// @brief Destructor (runs the remaining jobs and stops the workers).
+    ~Dispatcher() {
+        waitJobs();
+        stop_.store(true, std::memory_order_release);
+        posted_.fetch_add(1, std::memory_order_release);
+        posted_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /* posting ****************************************************************/
+
+    /// @brief Queue an object.
+    /// @return False if there is no handler for the type of the object.
+    template <typename T> bool post(std::shared_ptr<T> obj) {
+        static_assert(has_type_v<T, TypeTable>,
+                      "The type of the object must be in the type table.");
+        return post(getId<T>(TypeTable()), std::move(obj));
+    }
+
+    /// @brief Deserialize the objects stored one after the other in the buffer
+    ///        (id followed by the object, see SERIALIZE) and queue them.
+    /// @param mem Memory buffer.
+    /// @return Number of objects dispatched.
+    size_t receive(auto const &mem) {
+        size_t pos = 0, count = 0;
+
+        while (pos < mem.size()) {
+            auto id = getId<TypeTable>(mem, pos);
+            applyId(id, TypeTable(), [&]<typename T>() {
+                auto obj = std::make_shared<T>();
+                pos = obj->deserialize(mem, pos);
+                count += post(id, std::move(obj));
+            });
+        }
+        return count;
+    }
+
+    /// @brief Deserialize the records of a batch (see BatchWriter) and queue
+    ///        them.
+    /// @param mem Memory buffer that contains the batch.
+    /// @return Number of objects dispatched.
+    template <typename MemT> size_t receiveBatch(MemT &mem) {
+        BatchReader<TypeTable, MemT> reader(mem);
+        size_t count = 0;
+        reader.dispatch([&]<typename T>(std::shared_ptr<T> obj) {
+            count += post(std::move(obj));
+        });
+        return count;
+    }
+
+    /* synchronization ********************************************************/
+
+    /// @brief Wait until all the queued objects are processed.
+    /// @throw The first exception thrown by the handler since the last wait.
+    void wait() {
+        waitJobs();
+        std::exception_ptr error = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            std::swap(error, error_);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+  private:
+    std::vector<std::unique_ptr<MpmcQueue<Job>>> queues_; ///< queue per id
+    std::vector<std::function<void(Job const &)>> handlers_; ///< per id
+    std::vector<std::thread> workers_;                     ///< worker threads
+    alignas(64) std::atomic<uint64_t> posted_ = 0;  ///< wakes up the workers
+    alignas(64) std::atomic<uint64_t> pending_ = 0; ///< unfinished jobs
+    std::atomic<bool> stop_ = false;
+    std::exception_ptr error_ = nullptr; ///< first error of the handler
+    std::mutex errorMutex_;
+
+    /// @brief Queue an object (runs jobs while the queue is full).
+    bool post(size_t id, Job job) {
+        if (!handlers_[id]) {
+            return false;
+        }
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        while (!queues_[id]->tryPush(job)) {
+            if (!runOne(id)) {
+                std::this_thread::yield();
+            }
+        }
+        posted_.fetch_add(1, std::memory_order_release);
+        posted_.notify_one();
+        return true;
+    }
+
+    /// @brief Run one job, starting the search at the queue first.
+    /// @return False if all the queues are empty.
+    bool runOne(size_t first) {
+        Job job;
+        for (size_t i = 0; i < queues_.size(); ++i) {
+            size_t id = (first + i) % queues_.size();
+            if (queues_[id]->tryPop(job)) {
+                run(id, job);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Run the handler on a job.
+    void run(size_t id, Job &job) {
+        try {
+            handlers_[id](job);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+        job.reset();
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pending_.notify_all();
+        }
+    }
+
+    /// @brief Loop of the workers (they sleep when the queues are empty).
+    void work(size_t idx) {
+        size_t first = idx % queues_.size();
+        for (;;) {
+            uint64_t posted = posted_.load(std::memory_order_acquire);
+            if (runOne(first)) {
+                continue;
+            }
+            if (stop_.load(std::memory_order_acquire)) {
+                return;
+            }
+            posted_.wait(posted, std::memory_order_acquire);
+        }
+    }
+
+    /// @brief Wait until the number of pending jobs is 0.
+    void waitJobs() {
+        uint64_t pending;
+        while ((pending = pending_.load(std::memory_order_acquire)) != 0) {
+            pending_.wait(pending, std::memory_order_acquire);
+        }
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
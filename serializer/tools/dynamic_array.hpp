@@ -1,6 +1,10 @@
 #ifndef SERIALIZER_DYNAMIC_ARRAY_HPP
 #define SERIALIZER_DYNAMIC_ARRAY_HPP
 #include "../meta/concepts.hpp"
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
 
 /******************************************************************************/
 /*                               Dynamic Array                                */
@@ -34,6 +38,115 @@ template <concepts::Pointer T, typename... DTs> struct DynamicArray {
     std::tuple<const DTs &...> dimensions; ///< dimensions of the array.
 };
 
+/// @brief Returns the number of pointer levels of P.
+template <typename P> inline constexpr size_t pointerDepth() {
+    if constexpr (std::is_pointer_v<P>) {
+        return 1 + pointerDepth<std::remove_pointer_t<P>>();
+    } else {
+        return 0;
+    }
+}
+
+/// @brief Wrapper for the multi-dimensional dynamic arrays (pointers of
+///        pointers) which elements are stored in one contiguous allocation in
+///        row-major order (mem[i] == mem[0] + i * dim1, ...). The elements
+///        are serialized in bulk, with the same layout as a DynamicArray of
+///        one pointer with the same dimensions (no marker per row). When the
+///        pointer is null during the deserialization, the elements are
+///        allocated in one block and each level of pointers in one table (the
+///        user must release the block mem[0]...[0] and the tables).
+template <concepts::Pointer T, typename... DTs> struct ContiguousArray {
+    static_assert(sizeof...(DTs) == pointerDepth<T>(),
+                  "The contiguous arrays need one dimension per pointer "
+                  "level.");
+
+    /// @brief Constructor.
+    /// @param mem Reference to the pointer of the array.
+    /// @param dims Dimensions of the array (one per pointer level).
+    constexpr explicit ContiguousArray(T &mem, DTs const &...dims)
+        : mem(mem), dimensions(dims...) {}
+
+    T &mem; ///< reference to the pointer of the array.
+    std::tuple<const DTs &...> dimensions; ///< dimensions of the array.
+};
+
+/// @brief Wrapper for a 2D block of a larger row-major matrix: rows x cols
+///        elements which rows are separated by stride elements (leading
+///        dimension of the matrix). Only the elements of the block are
+///        serialized, row by row, with the same layout as
+///        DynamicArray(mem, rows, cols), so a block can be deserialized in a
+///        plain array and a plain array in a block. When the pointer is null
+///        during the deserialization, rows * stride elements are allocated.
+template <concepts::Pointer T, typename RT, typename CT, typename ST>
+struct StridedArray {
+    /// @brief Constructor.
+    /// @param mem Reference to the pointer to the first element of the block.
+    /// @param rows Number of rows of the block.
+    /// @param cols Number of columns of the block.
+    /// @param stride Number of elements between two rows.
+    constexpr explicit StridedArray(T &mem, RT const &rows, CT const &cols,
+                                    ST const &stride)
+        : mem(mem), rows(rows), cols(cols), stride(stride) {}
+
+    T &mem;           ///< reference to the pointer of the block.
+    RT const &rows;   ///< number of rows
+    CT const &cols;   ///< number of columns
+    ST const &stride; ///< number of elements between two rows
+};
+
+/// @brief Create the tables of the pointer levels of a contiguous array (see
+///        ContiguousArray) that points into block.
+/// @tparam P Type of the pointer of the current level.
+/// @param allocator Allocator used for the tables.
+/// @param block Block of the elements.
+/// @param dims Dimensions of the array.
+/// @param level Current level.
+/// @param count Number of elements of the tables of the current level.
+template <typename P, size_t N>
+inline constexpr P createLevels(auto &&allocator, auto *block,
+                                std::array<size_t, N> const &dims,
+                                size_t level = 0, size_t count = 1) {
+    using Q = std::remove_pointer_t<P>;
+    if constexpr (!std::is_pointer_v<Q>) {
+        return block;
+    } else {
+        count *= dims[level];
+        P table = allocator.template createArray<Q>(count);
+        Q next = createLevels<Q>(allocator, block, dims, level + 1, count);
+        for (size_t i = 0; i < count; ++i) {
+            table[i] = next + i * dims[level + 1];
+        }
+        return table;
+    }
+}
+
+/// @brief Returns a pointer to the first element of a contiguous array.
+template <typename P> inline constexpr auto firstElement(P ptr) {
+    if constexpr (std::is_pointer_v<std::remove_pointer_t<P>>) {
+        return firstElement(ptr[0]);
+    } else {
+        return ptr;
+    }
+}
+
+#if defined(__cpp_lib_mdspan)
+/// @brief Call fun on the elements of a std::mdspan in row-major order.
+/// @param span Multi-dimensional view.
+/// @param fun Function called on the elements.
+/// @param idx Indices of the current element.
+template <size_t R = 0>
+inline constexpr void forEachIndex(auto &&span, auto &&fun, auto... idx) {
+    using Span = std::remove_cvref_t<decltype(span)>;
+    if constexpr (R == Span::rank()) {
+        fun(span[idx...]);
+    } else {
+        for (typename Span::index_type i = 0; i < span.extent(R); ++i) {
+            forEachIndex<R + 1>(span, fun, idx..., i);
+        }
+    }
+}
+#endif
+
 } // end namespace serializer::tools
 
 #endif
@@ -0,0 +1,211 @@
+#ifndef SERIALIZER_ENDIAN_H
+#define SERIALIZER_ENDIAN_H
+#include "memory_wrapper.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SERIALIZER_ENDIAN_X86
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SERIALIZER_ENDIAN_NEON
+#endif
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                                  byteswap                                  */
+/******************************************************************************/
+
+/// @brief Reverse the bytes of a scalar value (std::byteswap is C++23).
+/// @param value Integer, floating point or enum value.
+/// @return Value with the reversed byte order.
+template <typename T> inline constexpr T byteswap(T value) {
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>,
+                  "Only the scalar types can be byte-swapped (the trivial "
+                  "structures should define a serialize function).");
+    if constexpr (sizeof(T) == 1) {
+        return value;
+    } else if constexpr (sizeof(T) == 2) {
+        return std::bit_cast<T>(
+            __builtin_bswap16(std::bit_cast<uint16_t>(value)));
+    } else if constexpr (sizeof(T) == 4) {
+        return std::bit_cast<T>(
+            __builtin_bswap32(std::bit_cast<uint32_t>(value)));
+    } else if constexpr (sizeof(T) == 8) {
+        return std::bit_cast<T>(
+            __builtin_bswap64(std::bit_cast<uint64_t>(value)));
+    } else {
+        auto bytes = std::bit_cast<std::array<unsigned char, sizeof(T)>>(value);
+        std::reverse(bytes.begin(), bytes.end());
+        return std::bit_cast<T>(bytes);
+    }
+}
+
+/// @brief Implementation of the bulk byteswap functions.
+namespace endian_impl {
+
+/// @brief Scalar byteswap of size elements of Size bytes (the arrays can be
+///        the same).
+template <size_t Size>
+inline void byteswapScalar(unsigned char const *src, unsigned char *dest,
+                           size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char elt[Size];
+        std::memcpy(elt, src + i * Size, Size);
+        std::reverse(elt, elt + Size);
+        std::memcpy(dest + i * Size, elt, Size);
+    }
+}
+
+#ifdef SERIALIZER_ENDIAN_X86
+/// @brief Shuffle mask that reverses the bytes of the elements of a 16 bytes
+///        lane.
+template <size_t Size> inline __m128i shuffleMask() {
+    alignas(16) unsigned char mask[16];
+    for (size_t i = 0; i < 16; ++i) {
+        mask[i] = (unsigned char)((i / Size) * Size + (Size - 1 - i % Size));
+    }
+    return _mm_load_si128(reinterpret_cast<__m128i const *>(mask));
+}
+
+/// @brief Byteswap the 32 bytes blocks with AVX2.
+/// @return Number of processed bytes.
+template <size_t Size>
+__attribute__((target("avx2"))) inline size_t
+byteswapAVX2(unsigned char const *src, unsigned char *dest, size_t nbBytes) {
+    __m256i mask = _mm256_broadcastsi128_si256(shuffleMask<Size>());
+    size_t i = 0;
+    for (; i + 32 <= nbBytes; i += 32) {
+        __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i),
+                            _mm256_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+
+/// @brief Byteswap the 16 bytes blocks with SSSE3.
+/// @return Number of processed bytes.
+template <size_t Size>
+__attribute__((target("ssse3"))) inline size_t
+byteswapSSSE3(unsigned char const *src, unsigned char *dest, size_t nbBytes) {
+    __m128i mask = shuffleMask<Size>();
+    size_t i = 0;
+    for (; i + 16 <= nbBytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i),
+                         _mm_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+#endif
+
+#ifdef SERIALIZER_ENDIAN_NEON
+/// @brief Byteswap the 16 bytes blocks with NEON.
+/// @return Number of processed bytes.
+template <size_t Size>
+inline size_t byteswapNEON(unsigned char const *src, unsigned char *dest,
+                           size_t nbBytes) {
+    size_t i = 0;
+    for (; i + 16 <= nbBytes; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        if constexpr (Size == 2) {
+            v = vrev16q_u8(v);
+        } else if constexpr (Size == 4) {
+            v = vrev32q_u8(v);
+        } else {
+            v = vrev64q_u8(v);
+        }
+        vst1q_u8(dest + i, v);
+    }
+    return i;
+}
+#endif
+
+/// @brief Byteswap the largest prefix of the array that can be processed with
+///        the SIMD instructions available on the host.
+/// @return Number of processed bytes.
+template <size_t Size>
+inline size_t byteswapSIMD(unsigned char const *src, unsigned char *dest,
+                           size_t nbBytes) {
+    if constexpr (Size != 2 && Size != 4 && Size != 8) {
+        return 0;
+    } else {
+#if defined(SERIALIZER_ENDIAN_X86)
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        static const bool ssse3 = __builtin_cpu_supports("ssse3");
+        size_t done = 0;
+        if (avx2) {
+            done = byteswapAVX2<Size>(src, dest, nbBytes);
+        }
+        if (ssse3) {
+            done += byteswapSSSE3<Size>(src + done, dest + done,
+                                        nbBytes - done);
+        }
+        return done;
+#elif defined(SERIALIZER_ENDIAN_NEON)
+        return byteswapNEON<Size>(src, dest, nbBytes);
+#else
+        return 0;
+#endif
+    }
+}
+
+} // end namespace endian_impl
+
+/// @brief Byteswap an array of scalar values using the SIMD shuffles when they
+///        are available (AVX2 / SSSE3 are detected at runtime on x86 and NEON
+///        is used on ARM). The source and the destination can be the same.
+/// @param src  Source values.
+/// @param dest Destination of the swapped values.
+/// @param size Number of values.
+template <typename T>
+inline void byteswapArray(T const *src, T *dest, size_t size) {
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>,
+                  "Only the scalar types can be byte-swapped (the trivial "
+                  "structures should define a serialize function).");
+    if constexpr (sizeof(T) > 1) {
+        auto s = reinterpret_cast<unsigned char const *>(src);
+        auto d = reinterpret_cast<unsigned char *>(dest);
+        size_t nbBytes = size * sizeof(T);
+        size_t done = endian_impl::byteswapSIMD<sizeof(T)>(s, d, nbBytes);
+        endian_impl::byteswapScalar<sizeof(T)>(s + done, d + done,
+                                               (nbBytes - done) / sizeof(T));
+    } else if (src != dest) {
+        std::memcpy(dest, src, size);
+    }
+}
+
+/******************************************************************************/
+/*                                   endian                                   */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper that fixes the byte order of the serialized
+///        data. The scalar values (integers, floating points, enums, sizes and
+///        ids) are byte-swapped when the order differs from the host one, and
+///        the trivial arrays are swapped in bulk with the SIMD shuffles. The
+///        trivial structures that don't have a serialize function cannot be
+///        serialized with this wrapper (the views either), and when the order
+///        differs from the host one, neither can the SERIALIZE_STRUCT types
+///        (their bytes are copied in the host order).
+/// @tparam MemT Type of the wrapped memory buffer.
+/// @tparam Order Byte order of the serialized data.
+template <typename MemT, std::endian Order = std::endian::little>
+class Endian : public MemoryWrapper<MemT> {
+  public:
+    static constexpr std::endian byte_order = Order;
+
+    /// @brief Constructor from the wrapped memory buffer.
+    constexpr explicit Endian(MemT &mem) : MemoryWrapper<MemT>(mem) {}
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,470 @@
+#ifndef SERIALIZER_INCREMENTAL_H
+#define SERIALIZER_INCREMENTAL_H
+#include "../meta/concepts.hpp"
+#include "../meta/serializer_meta.hpp"
+#include "../meta/static_size.hpp"
+#include "../serializer/serializer.hpp"
+#include "context.hpp"
+#include "dynamic_array.hpp"
+#include "tools.hpp"
+#include "type_table.hpp"
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Implementation of the incremental deserialization.
+namespace incremental_impl {
+
+/// @brief Thrown by the incremental buffer when the requested bytes have not
+///        been received yet.
+struct NeedMoreData {
+    size_t end; ///< position of the end of the requested bytes
+};
+
+} // end namespace incremental_impl
+
+/******************************************************************************/
+/*                             incremental buffer                             */
+/******************************************************************************/
+
+/// @brief Memory buffer filled chunk by chunk (ex: data received from a
+///        socket). The deserialization started with deserializeIncremental
+///        suspends when the bytes are not available yet and is resumed by
+///        `feed` once enough bytes have been received. The received bytes are
+///        kept in the buffer (the views of the deserialized objects are not
+///        supported).
+/// @tparam T Byte type.
+template <typename T = std::byte> class IncrementalBuffer {
+  public:
+    using byte_type = T;
+
+    /* feed *******************************************************************/
+
+    /// @brief Append a chunk of data and resume the deserialization if the
+    ///        bytes it is waiting for are available.
+    /// @param bytes   Received bytes.
+    /// @param nbBytes Number of bytes.
+    /// @throw std::logic_error if the buffer is finished.
+    void feed(T const *bytes, size_t nbBytes) {
+        if (finished_) [[unlikely]] {
+            throw std::logic_error("error: the buffer is finished.");
+        }
+        data_.insert(data_.end(), bytes, bytes + nbBytes);
+        if (waiting_ && data_.size() >= needed_) {
+            std::exchange(waiting_, nullptr).resume();
+        }
+    }
+
+    /// @brief Mark the end of the data (ex: connection closed). A waiting
+    ///        deserialization fails with std::out_of_range.
+    void finish() {
+        finished_ = true;
+        if (waiting_) {
+            std::exchange(waiting_, nullptr).resume();
+        }
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the number of received bytes.
+    size_t size() const { return data_.size(); }
+
+    /// @brief Returns the received bytes.
+    T const *data() const { return data_.data(); }
+
+    /// @brief Returns true if finish has been called.
+    bool finished() const { return finished_; }
+
+    /* fetchable interface ****************************************************/
+
+    /// @brief Access to nbBytes bytes at pos.
+    /// @throw std::out_of_range if the data is finished and too short.
+    T const *fetch(size_t pos, size_t nbBytes) const {
+        if (pos + nbBytes > data_.size()) {
+            if (finished_) {
+                throw std::out_of_range("error: the data is truncated.");
+            }
+            throw incremental_impl::NeedMoreData{pos + nbBytes};
+        }
+        return data_.data() + pos;
+    }
+
+    /// @brief Copy nbBytes bytes at pos into dest.
+    /// @throw std::out_of_range if the data is finished and too short.
+    void read(size_t pos, T *dest, size_t nbBytes) const {
+        std::memcpy(dest, fetch(pos, nbBytes), nbBytes);
+    }
+
+    /* awaitable **************************************************************/
+
+    /// @brief Suspend the deserialization until the bytes up to end are
+    ///        received.
+    /// @param end Position of the end of the bytes required.
+    auto need(size_t end) {
+        struct Awaiter {
+            IncrementalBuffer &buffer;
+            size_t end;
+
+            bool await_ready() const noexcept {
+                return end <= buffer.size() || buffer.finished();
+            }
+            void await_suspend(std::coroutine_handle<> handle) noexcept {
+                buffer.waiting_ = handle;
+                buffer.needed_ = end;
+            }
+            void await_resume() const {
+                if (end > buffer.size()) [[unlikely]] {
+                    throw std::out_of_range("error: the data is truncated.");
+                }
+            }
+        };
+        return Awaiter{*this, end};
+    }
+
+  private:
+    std::vector<T> data_;             ///< received bytes
+    std::coroutine_handle<> waiting_; ///< suspended deserialization
+    size_t needed_ = 0;               ///< end of the bytes it waits for
+    bool finished_ = false;           ///< true if no more data will be fed
+};
+
+/******************************************************************************/
+/*                              incremental task                              */
+/******************************************************************************/
+
+/// @brief Coroutine of an incremental deserialization. The deserialization
+///        progresses each time data is fed to the buffer, `done` returns true
+///        when it is finished and `result` gives the position of the end of
+///        the deserialized elements.
+class IncrementalTask {
+  public:
+    struct promise_type {
+        size_t pos = 0;                ///< end of the deserialized elements
+        std::exception_ptr exception;  ///< error of the deserialization
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+
+        IncrementalTask get_return_object() {
+            return IncrementalTask(handle_type::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept {
+            // resume the coroutine that awaits the result (symmetric transfer)
+            struct Awaiter {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<>
+                await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    return h.promise().continuation;
+                }
+                void await_resume() noexcept {}
+            };
+            return Awaiter{};
+        }
+        void return_value(size_t end) { pos = end; }
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    IncrementalTask(IncrementalTask &&other)
+        : handle_(std::exchange(other.handle_, nullptr)) {}
+    IncrementalTask &operator=(IncrementalTask &&other) {
+        std::swap(handle_, other.handle_);
+        return *this;
+    }
+    ~IncrementalTask() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /* result *****************************************************************/
+
+    /// @brief Returns true if the deserialization is finished (or failed).
+    bool done() const { return handle_.done(); }
+
+    /// @brief Returns the position of the end of the deserialized elements.
+    /// @throw std::logic_error if the deserialization is not finished, or the
+    ///        exception thrown by the deserialization.
+    size_t result() const {
+        if (!done()) [[unlikely]] {
+            throw std::logic_error("error: the deserialization is not done.");
+        }
+        if (handle_.promise().exception) {
+            std::rethrow_exception(handle_.promise().exception);
+        }
+        return handle_.promise().pos;
+    }
+
+    /* awaitable **************************************************************/
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<> continuation) noexcept {
+        handle_.promise().continuation = continuation;
+        return handle_;
+    }
+    size_t await_resume() const { return result(); }
+
+    /// @brief Run the coroutine until it waits for data.
+    void start() { handle_.resume(); }
+
+  private:
+    explicit IncrementalTask(handle_type handle) : handle_(handle) {}
+    handle_type handle_; ///< coroutine
+};
+
+namespace incremental_impl {
+
+/******************************************************************************/
+/*                                  elements                                  */
+/******************************************************************************/
+
+/// @brief True if T is a serializer function (SER_FUN).
+template <typename T, typename Ser>
+constexpr bool is_serializer_function_v = requires(T &fun, Ser &serializer) {
+    fun(Context<Phases::Deserialization, Ser &>(serializer));
+};
+
+/// @brief True if MemT is an IncrementalBuffer.
+template <typename MemT> constexpr bool is_incremental_buffer_v = false;
+template <typename T>
+constexpr bool is_incremental_buffer_v<IncrementalBuffer<T>> = true;
+
+/// @brief Deserialize elt synchronously.
+/// @return False if the bytes of elt are not received yet (pos is unchanged).
+template <typename Ser>
+bool tryDeserialize(typename Ser::mem_type &mem, size_t &pos, auto &elt) {
+    try {
+        Ser serializer(mem, pos);
+        deserializeArgs<0>(serializer, std::forward_as_tuple(elt));
+        pos = serializer.pos;
+        return true;
+    } catch (NeedMoreData const &) {
+        return false;
+    }
+}
+
+template <typename Ser, typename T>
+IncrementalTask deserializeElement(typename Ser::mem_type &mem, size_t pos,
+                                   T &elt);
+
+/// @brief Awaitable that deserializes an element: the element is deserialized
+///        synchronously if it is entirely received, otherwise a coroutine is
+///        created (the coroutine frames are only allocated at the end of the
+///        received data).
+template <typename Ser, typename T> struct ElementAwaiter {
+    typename Ser::mem_type &mem;
+    size_t pos;
+    T &elt;
+    std::optional<IncrementalTask> task = std::nullopt;
+
+    bool await_ready() { return tryDeserialize<Ser>(mem, pos, elt); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle) {
+        task.emplace(deserializeElement<Ser>(mem, pos, elt));
+        return task->await_suspend(handle);
+    }
+    size_t await_resume() const { return task ? task->await_resume() : pos; }
+};
+
+/// @brief Returns the awaitable that deserializes elt at pos.
+template <typename Ser, typename T>
+ElementAwaiter<Ser, T> element(typename Ser::mem_type &mem, size_t pos,
+                               T &elt) {
+    return ElementAwaiter<Ser, T>{mem, pos, elt};
+}
+
+/// @brief Read size trivial values as they are received.
+template <typename Ser, typename T>
+IncrementalTask readChunks(typename Ser::mem_type &mem, size_t pos, T *elts,
+                           size_t size) {
+    for (size_t done = 0; done < size;) {
+        co_await mem.need(pos + sizeof(T));
+        size_t count = std::min((mem.size() - pos) / sizeof(T), size - done);
+        Ser serializer(mem, pos);
+        serializer.readArray(elts + done, count);
+        pos = serializer.pos;
+        done += count;
+    }
+    co_return pos;
+}
+
+/// @brief Read a size (non compact).
+template <typename Ser, typename S>
+IncrementalTask readSize(typename Ser::mem_type &mem, size_t pos, S &size) {
+    co_await mem.need(pos + sizeof(S));
+    Ser serializer(mem, pos);
+    size = serializer.template deserializeSize<S>();
+    co_return serializer.pos;
+}
+
+/// @brief Deserialize the members of a SERIALIZE object one by one.
+template <typename Ser, typename Tuple, size_t... Is>
+IncrementalTask deserializeMembers(typename Ser::mem_type &mem, size_t pos,
+                                   Tuple members, std::index_sequence<Is...>) {
+    ((pos = co_await element<Ser>(mem, pos, std::get<Is>(members))), ...);
+    co_return pos;
+}
+
+/// @brief Coroutine that deserializes an element which is not entirely
+///        received. The SERIALIZE objects, the containers and the dynamic
+///        arrays of trivial types are deserialized progressively. The other
+///        types (custom serialize functions, polymorphic types, ...) are
+///        deserialized again from the start once more data is received.
+template <typename Ser, typename T>
+IncrementalTask deserializeElement(typename Ser::mem_type &mem, size_t pos,
+                                   T &elt) {
+    using Type = mtf::clean_t<T>;
+    using MemT = typename Ser::mem_type;
+    constexpr bool has_id = has_type_v<Type, typename Ser::type_table> ||
+                            mtf::polymorphic_id_size_v<Type> > 0;
+    constexpr bool indexed = requires { requires Type::serialized_with_index; };
+
+    if constexpr (is_serializer_function_v<T, Ser> ||
+                  concepts::HasCodec<Type>) {
+        // fallback below
+    } else if constexpr (concepts::FixedSize<Type> && !has_id && !indexed) {
+        co_await mem.need(pos + mtf::static_serialized_size_v<Type>);
+        if (tryDeserialize<Ser>(mem, pos, elt)) {
+            co_return pos;
+        }
+        // the data is larger than the static size, fallback below
+    } else if constexpr (requires { elt.serializedMembers(); } && !has_id &&
+                         !indexed) {
+        using Members = decltype(elt.serializedMembers());
+        co_return co_await deserializeMembers<Ser>(
+            mem, pos, elt.serializedMembers(),
+            std::make_index_sequence<std::tuple_size_v<Members>>());
+    } else if constexpr (concepts::String<Type> &&
+                         !concepts::InternsStrings<MemT>) {
+        using size_type = typename Type::size_type;
+        size_type size = 0;
+        pos = co_await readSize<Ser>(mem, pos, size);
+        elt.resize(size);
+        co_return co_await readChunks<Ser>(mem, pos, elt.data(), size);
+    } else if constexpr (concepts::Container<Type> &&
+                         !concepts::Trivial<Type> &&
+                         !concepts::Deserializable<Type, MemT> &&
+                         !concepts::View<Type>) {
+        using size_type = decltype(std::size(std::declval<Type>()));
+        using ValueType = mtf::remove_const_t<mtf::iter_value_t<Type>>;
+        using IterType = decltype(elt.begin());
+        size_type size = 0;
+        pos = co_await readSize<Ser>(mem, pos, size);
+
+        if constexpr (concepts::ContiguousResizeable<Type>) {
+            elt.resize(size);
+        } else if constexpr (concepts::Clearable<Type>) {
+            elt.clear();
+            if constexpr (requires { elt.reserve(size); }) {
+                elt.reserve(size);
+            }
+        }
+
+        if constexpr (concepts::ContiguousTrivial<Type, MemT>) {
+            co_return co_await readChunks<Ser>(
+                mem, pos, std::to_address(elt.begin()), size);
+        } else if constexpr (std::contiguous_iterator<IterType>) {
+            for (auto &value : elt) {
+                pos = co_await element<Ser>(mem, pos, value);
+            }
+            co_return pos;
+        } else {
+            for (size_t i = 0; i < size; ++i) {
+                ValueType value{};
+                pos = co_await element<Ser>(mem, pos, value);
+                if constexpr (concepts::Insertable<Type, ValueType> ||
+                              concepts::PushBackable<Type, ValueType>) {
+                    insert(elt, std::move(value));
+                } else {
+                    insert(elt, std::move(value), i);
+                }
+            }
+            co_return pos;
+        }
+    } else if constexpr (mtf::is_dynamic_array_v<Type>) {
+        using ST = std::remove_pointer_t<
+            mtf::clean_t<std::remove_reference_t<decltype(elt.mem)>>>;
+        if constexpr (concepts::Trivial<ST> &&
+                      !concepts::Deserializable<ST, MemT>) {
+            co_await mem.need(pos + 1);
+            Ser serializer(mem, pos);
+            bool ptrValid = char(*serializer.fetch(1)) == 'v';
+
+            if (!ptrValid) {
+                elt.mem = nullptr;
+                co_return pos + 1;
+            }
+            size_t size = tupleProd<size_t>(elt.dimensions);
+            if (elt.mem == nullptr) {
+                elt.mem = serializer.allocator().template createArray<ST>(size);
+            }
+            co_return co_await readChunks<Ser>(mem, pos + 1, elt.mem, size);
+        }
+    }
+
+    // deserialize the element from the start once more data is received
+    for (;;) {
+        size_t end = 0;
+        try {
+            Ser serializer(mem, pos);
+            deserializeArgs<0>(serializer, std::forward_as_tuple(elt));
+            co_return serializer.pos;
+        } catch (NeedMoreData const &e) {
+            end = e.end;
+        }
+        co_await mem.need(end);
+    }
+}
+
+/// @brief Deserialize the arguments one by one.
+template <typename Ser>
+IncrementalTask deserializeArgs(typename Ser::mem_type &mem, size_t pos,
+                                auto &...args) {
+    ((pos = co_await element<Ser>(mem, pos, args)), ...);
+    co_return pos;
+}
+
+} // end namespace incremental_impl
+
+/******************************************************************************/
+/*                          incremental deserialize                           */
+/******************************************************************************/
+
+/// @brief Start the deserialization of args from a buffer that is filled
+///        progressively. The deserialization runs until it needs bytes which
+///        are not received yet, and resumes each time a chunk is fed to the
+///        buffer. The elements must be serialized with the same serializer
+///        (type table) and the default layout. The arguments must outlive the
+///        returned task.
+/// @tparam Ser Serializer type (its memory must be an IncrementalBuffer).
+/// @param mem  Buffer that receives the data.
+/// @param pos  Position of the first element in the buffer.
+/// @param args Elements to deserialize.
+/// @return Task which result is the position of the end of the elements.
+template <typename Ser = Serializer<IncrementalBuffer<std::byte>>>
+IncrementalTask deserializeIncremental(typename Ser::mem_type &mem, size_t pos,
+                                       auto &...args) {
+    static_assert(incremental_impl::is_incremental_buffer_v<
+                      typename Ser::mem_type>,
+                  "The incremental deserialization requires an "
+                  "IncrementalBuffer.");
+    IncrementalTask task =
+        incremental_impl::deserializeArgs<Ser>(mem, pos, args...);
+    task.start();
+    return task;
+}
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef SERIALIZER_INSTRUMENTATION_H
+#define SERIALIZER_INSTRUMENTATION_H
+#include "../meta/concepts.hpp"
+#include "../meta/type_transform.hpp"
+#include "context.hpp"
+#include "memory_wrapper.hpp"
+#include "type_table.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                                  counters                                  */
+/******************************************************************************/
+
+/// @brief Returns a time stamp in cycles (nanoseconds on the architectures
+///        that don't have a time stamp counter).
+inline uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count());
+#endif
+}
+
+/// @brief Counters of a type or of an id. The counters are inclusive: the
+///        bytes and the cycles of an object contain the ones of its members.
+struct Counters {
+    uint64_t calls = 0;  ///< number of (de)serializations
+    uint64_t bytes = 0;  ///< number of bytes written or read
+    uint64_t cycles = 0; ///< time spent (see tools::cycles)
+};
+
+/// @brief Counters of a type in the snapshot.
+struct TypeCounters {
+    std::string type; ///< name of the type (typeid)
+    Phases phase;     ///< serialization or deserialization
+    Counters counters;
+};
+
+/// @brief Counters of an id of the type table in the snapshot.
+struct IdCounters {
+    size_t id;    ///< identifier of the type in the type table
+    Phases phase; ///< serialization or deserialization
+    Counters counters;
+};
+
+/// @brief Copy of the counters of an instrumentation (only the entries which
+///        have been called are present).
+struct InstrumentationSnapshot {
+    std::vector<TypeCounters> types; ///< counters of the arguments
+    std::vector<IdCounters> ids;     ///< counters of the type table ids
+    uint64_t reallocations = 0;      ///< reallocations of the memory
+};
+
+/* type index *****************************************************************/
+
+/// @brief Registry of the instrumented types (the types get a dense index so
+///        the counters are stored in vectors).
+class TypeRegistry {
+  public:
+    /// @brief Returns the index of the type T.
+    template <typename T> static size_t index() {
+        static const size_t idx = instance().add(typeid(T));
+        return idx;
+    }
+
+    /// @brief Returns the name of the type with the given index.
+    static std::string name(size_t idx) {
+        TypeRegistry &registry = instance();
+        std::lock_guard<std::mutex> lock(registry.mutex_);
+        return registry.types_[idx]->name();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::vector<std::type_info const *> types_;
+
+    static TypeRegistry &instance() {
+        static TypeRegistry registry;
+        return registry;
+    }
+
+    size_t add(std::type_info const &type) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        types_.push_back(&type);
+        return types_.size() - 1;
+    }
+};
+
+/******************************************************************************/
+/*                              instrumentation                               */
+/******************************************************************************/
+
+/// @brief Counters of the calls, bytes and cycles of the serialization, per
+///        argument type (the arguments of serialize / deserialize and the
+///        members of the SERIALIZE objects; the packed trivial members are
+///        accounted in their object) and per type table id (the types
+///        registered in the type table). The counters are not thread-safe.
+class Instrumentation {
+  public:
+    /* recording **************************************************************/
+
+    /// @brief Run fun and record it for the type T.
+    /// @param pos Reference to the position of the serializer.
+    /// @param fun Function that (de)serializes the element.
+    template <Phases Phase, typename T>
+    inline void record(size_t const &pos, auto &&fun) {
+        size_t idx = TypeRegistry::index<mtf::clean_t<T>>();
+        auto &counters = types_[size_t(Phase)];
+        if (idx >= counters.size()) {
+            counters.resize(idx + 1);
+        }
+        run(counters, idx, pos, fun);
+    }
+
+    /// @brief Run fun and record it for the given type table id.
+    /// @param id  Identifier of the type (not recorded if invalid).
+    /// @param pos Reference to the position of the serializer.
+    /// @param fun Function that (de)serializes the element.
+    template <Phases Phase>
+    inline void recordId(size_t id, size_t const &pos, auto &&fun) {
+        auto &counters = ids_[size_t(Phase)];
+        if (id == size_t(-1)) {
+            fun();
+            return;
+        }
+        if (id >= counters.size()) {
+            counters.resize(id + 1);
+        }
+        run(counters, id, pos, fun);
+    }
+
+    /// @brief Count a reallocation of the memory buffer.
+    void reallocation() { ++reallocations_; }
+
+    /* snapshot ***************************************************************/
+
+    /// @brief Copy the counters.
+    InstrumentationSnapshot snapshot() const {
+        InstrumentationSnapshot result;
+        for (Phases phase : {Phases::Serialization, Phases::Deserialization}) {
+            auto const &types = types_[size_t(phase)];
+            for (size_t i = 0; i < types.size(); ++i) {
+                if (types[i].calls > 0) {
+                    result.types.push_back(
+                        TypeCounters{TypeRegistry::name(i), phase, types[i]});
+                }
+            }
+            auto const &ids = ids_[size_t(phase)];
+            for (size_t i = 0; i < ids.size(); ++i) {
+                if (ids[i].calls > 0) {
+                    result.ids.push_back(IdCounters{i, phase, ids[i]});
+                }
+            }
+        }
+        result.reallocations = reallocations_;
+        return result;
+    }
+
+    /// @brief Reset the counters.
+    void clear() {
+        for (size_t i = 0; i < 2; ++i) {
+            types_[i].clear();
+            ids_[i].clear();
+        }
+        reallocations_ = 0;
+    }
+
+  private:
+    std::vector<Counters> types_[2]; ///< counters per phase and type index
+    std::vector<Counters> ids_[2];   ///< counters per phase and id
+    uint64_t reallocations_ = 0;     ///< number of reallocations
+
+    static void run(std::vector<Counters> &counters, size_t idx,
+                    size_t const &pos, auto &fun) {
+        size_t start = pos;
+        uint64_t begin = cycles();
+        fun();
+        uint64_t end = cycles();
+        // the vector may grow during the nested recordings
+        Counters &entry = counters[idx];
+        ++entry.calls;
+        entry.bytes += pos - start;
+        entry.cycles += end - begin;
+    }
+};
+
+/******************************************************************************/
+/*                                instrumented                                */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper that records the cost of the serialization
+///        per type (see Instrumentation) and the reallocations of the wrapped
+///        buffer (detected with its capacity). Without this wrapper, the
+///        instrumentation code is not compiled.
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class Instrumented : public MemoryWrapper<MemT> {
+  public:
+    using byte_type = mtf::byte_type_t<MemT>;
+
+    /// @brief Constructor from the wrapped memory buffer.
+    constexpr explicit Instrumented(MemT &mem) : MemoryWrapper<MemT>(mem) {}
+
+    /// @brief Returns the counters.
+    Instrumentation &instrumentation() { return instrumentation_; }
+
+    void append(size_t pos, byte_type const *bytes, size_t nbBytes)
+        requires concepts::Appendable<MemT>
+    {
+        size_t before = capacity();
+        this->mem().append(pos, bytes, nbBytes);
+        checkCapacity(before);
+    }
+
+    void resize(size_t size)
+        requires concepts::Resizeable<MemT>
+    {
+        size_t before = capacity();
+        this->mem().resize(size);
+        checkCapacity(before);
+    }
+
+  private:
+    Instrumentation instrumentation_; ///< counters
+
+    size_t capacity() {
+        if constexpr (requires { this->mem().capacity(); }) {
+            return this->mem().capacity();
+        } else {
+            return 0;
+        }
+    }
+
+    void checkCapacity(size_t before) {
+        if (capacity() != before) {
+            instrumentation_.reallocation();
+        }
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef SERIALIZER_INTERNED_H
+#define SERIALIZER_INTERNED_H
+#include "../exceptions/corrupted_data.hpp"
+#include "memory_wrapper.hpp"
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                             string dictionary                              */
+/******************************************************************************/
+
+/// @brief Dictionary of the strings that have been serialized or deserialized
+///        with an interned memory. The strings get the index of their first
+///        occurrence. The strings are stored in a deque, so the references
+///        and the views on the dictionary entries stay valid until clear is
+///        called.
+class StringDictionary {
+  public:
+    /* serialization **********************************************************/
+
+    /// @brief Find the index of a string or add it to the dictionary.
+    /// @param str String to find.
+    /// @return Index of the string and true if the string has been added.
+    std::pair<size_t, bool> insert(std::string_view str) {
+        auto it = indices_.find(str);
+        if (it != indices_.end()) {
+            return {it->second, false};
+        }
+        size_t index = strings_.size();
+        indices_.emplace(strings_.emplace_back(str), index);
+        return {index, true};
+    }
+
+    /* deserialization ********************************************************/
+
+    /// @brief Add a deserialized string (its index is the number of strings).
+    /// @param str Deserialized string.
+    /// @return Reference to the dictionary entry.
+    std::string const &add(std::string str) {
+        return strings_.emplace_back(std::move(str));
+    }
+
+    /// @brief Returns the string at the given index.
+    /// @throw exceptions::CorruptedDataError if the index is invalid.
+    std::string const &get(size_t index) const {
+        if (index >= strings_.size()) [[unlikely]] {
+            throw exceptions::CorruptedDataError(
+                "invalid string reference " + std::to_string(index) + " (" +
+                std::to_string(strings_.size()) + " strings).");
+        }
+        return strings_[index];
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the number of strings in the dictionary.
+    size_t size() const { return strings_.size(); }
+
+    /// @brief Forget the strings (must be called on both sides to start a new
+    ///        dictionary).
+    void clear() {
+        indices_.clear();
+        strings_.clear();
+    }
+
+  private:
+    std::deque<std::string> strings_; ///< strings (stable addresses)
+    std::unordered_map<std::string_view, size_t> indices_; ///< serialization
+};
+
+/******************************************************************************/
+/*                                  interned                                  */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper that serializes each distinct string only
+///        once: its first occurrence is written as a 0 marker followed by the
+///        string, the next ones as the varint index + 1 of the string in the
+///        dictionary. The dictionary is kept by the wrapper, so it lasts for
+///        the whole stream when the same wrapper is used for several messages
+///        (call strings().clear() to use a dictionary per message). The
+///        std::string_view are deserialized as views on the dictionary
+///        entries (no copy).
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class Interned : public MemoryWrapper<MemT> {
+  public:
+    /// @brief Constructor from the wrapped memory buffer.
+    constexpr explicit Interned(MemT &mem) : MemoryWrapper<MemT>(mem) {}
+
+    /// @brief Returns the dictionary of the strings.
+    StringDictionary &strings() { return strings_; }
+
+  private:
+    StringDictionary strings_; ///< interned strings
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef SERIALIZER_LARGE_BYTES_H
+#define SERIALIZER_LARGE_BYTES_H
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <sys/mman.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/******************************************************************************/
+/*                                large bytes                                 */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Memory buffer for the large serialized data (Linux only). The bytes
+///        are stored in an anonymous mapping that grows with mremap: the pages
+///        are moved by the kernel instead of being copied, so growing a buffer
+///        of several GB costs the same as growing a small one. The pages are
+///        committed by the kernel when they are first written (no
+///        initialization). The capacity is a multiple of the page size, so
+///        Bytes should be preferred for the small buffers.
+/// @tparam T Byte type (std::byte, uint8_t, char, ...).
+template <typename T>
+    requires(sizeof(T) == sizeof(char))
+class LargeBytes {
+  public:
+    /* type alias *************************************************************/
+
+    using byte_type = T;
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Default constructor (nothing is mapped).
+    LargeBytes() = default;
+
+    /// @brief Constructor with capacity.
+    /// @throw std::system_error if the memory cannot be mapped.
+    explicit LargeBytes(size_t capacity) { reserve(capacity); }
+
+    LargeBytes(LargeBytes<T> const &) = delete;
+    LargeBytes<T> &operator=(LargeBytes<T> const &) = delete;
+
+    /// @brief Move constructor.
+    LargeBytes(LargeBytes<T> &&other) noexcept
+        : mem_(other.mem_), capacity_(other.capacity_), size_(other.size_) {
+        other.mem_ = nullptr;
+        other.capacity_ = 0;
+        other.size_ = 0;
+    }
+
+    /// @brief Move assignment (the mappings are swapped).
+    LargeBytes<T> &operator=(LargeBytes<T> &&other) noexcept {
+        std::swap(mem_, other.mem_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    /// @brief Destructor.
+    ~LargeBytes() {
+        if (mem_) {
+            ::munmap(mem_, capacity_);
+        }
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns a pointer to the bytes buffer.
+    T *data() { return mem_; }
+
+    /// @brief Returns a const pointer to the bytes buffer.
+    T const *data() const { return mem_; }
+
+    /// @brief Returns the capacity of the mapping.
+    size_t capacity() const { return capacity_; }
+
+    /// @brief Returns the number of bytes stored in the buffer.
+    size_t size() const { return size_; }
+
+    /// @breif Clear the buffer (set the size to 0 but do not unmap).
+    void clear() { size_ = 0; }
+
+    /* append *****************************************************************/
+
+    /// @brief Appends some bytes at pos (same semantic as Bytes::append).
+    /// @param pos     Position where the bytes are appended.
+    /// @param bytes   Buffer of bytes to append.
+    /// @param nbBytes Number of bytes to append.
+    void append(size_t pos, T const *bytes, size_t nbBytes) {
+        upsize(pos + nbBytes);
+        size_ = pos + nbBytes;
+        std::memcpy(mem_ + pos, bytes, nbBytes);
+    }
+
+    /* change size and capacity ***********************************************/
+
+    /// @brief Increase the capacity of the mapping if size bytes cannot be
+    ///        stored (the capacity is doubled).
+    /// @param size New size.
+    void upsize(size_t size) {
+        if (size > capacity_) [[unlikely]] {
+            alloc(size > capacity_ * 2 ? size : capacity_ * 2);
+        }
+    }
+
+    /// @brief Increase the capacity of the mapping to at least `capacity`
+    ///        bytes if it is too small.
+    /// @param capacity Minimal capacity of the mapping.
+    void reserve(size_t capacity) {
+        if (capacity > capacity_) {
+            alloc(capacity);
+        }
+    }
+
+    /// @brief Change the size of the buffer.
+    /// @param size New size.
+    void resize(size_t size) {
+        reserve(size);
+        size_ = size;
+    }
+
+    /// @brief Grow the mapping (the capacity is rounded up to the page size).
+    /// @param newCapacity New capacity of the mapping.
+    /// @throw std::system_error if the memory cannot be mapped.
+    void alloc(size_t newCapacity) {
+        size_t pageSize = size_t(::sysconf(_SC_PAGESIZE));
+        newCapacity = (newCapacity + pageSize - 1) / pageSize * pageSize;
+        if (newCapacity <= capacity_) {
+            return;
+        }
+        void *ptr = mem_ == nullptr
+                        ? ::mmap(nullptr, newCapacity, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                                 -1, 0)
+                        : ::mremap(mem_, capacity_, newCapacity,
+                                   MREMAP_MAYMOVE);
+        if (ptr == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot map the large bytes");
+        }
+        mem_ = static_cast<T *>(ptr);
+        capacity_ = newCapacity;
+    }
+
+    /* operators **************************************************************/
+
+    /// @brief Give read/write access to the byte `idx`.
+    T &operator[](size_t idx) { return mem_[idx]; }
+
+    /// @brief Give read access to the byte `idx`
+    T const &operator[](size_t idx) const { return mem_[idx]; }
+
+    /* convertion *************************************************************/
+
+    /// @brief Create a std::vector from the memory buffer.
+    std::vector<T> vector() const { return std::vector<T>(mem_, mem_ + size_); }
+
+  private:
+    T *mem_ = nullptr;    ///< mapped memory
+    size_t capacity_ = 0; ///< size of the mapping
+    size_t size_ = 0;     ///< number of bytes stored
+};
+
+} // end namespace serializer::tools
+
+#endif
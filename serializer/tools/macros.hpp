@@ -6,19 +6,38 @@
 /******************************************************************************/
 
 /// @brief Generate the serialize and deserialize methods with the specified
-///        serializer. The keywords virtual and override can be added.
+///        serializer. The keywords virtual and override can be added. The
+///        serializedMembers methods give access to the tuple of the members
+///        (used by the compile time layout functions).
 /// @param Ser Serializer.
 /// @param virt Virtual keyworkd.
 /// @param over Override keyworkd.
 /// @param ... Members to serialize.
 #define __SERIALIZE__(Ser, MemT, virt, over, ...)                              \
+    __SERIALIZE_WITH__(serializeWithId, deserializeWithId, Ser, MemT, virt,    \
+                       over, __VA_ARGS__)
+
+/// @brief Generate the serialize and deserialize methods that call the given
+///        serialize and deserialize functions.
+/// @param serFun Serialize function (ex: serializeWithId).
+/// @param deserFun Deserialize function (ex: deserializeWithId).
+/// @param Ser Serializer.
+/// @param virt Virtual keyworkd.
+/// @param over Override keyworkd.
+/// @param ... Members to serialize.
+#define __SERIALIZE_WITH__(serFun, deserFun, Ser, MemT, virt, over, ...)       \
     constexpr virt size_t serialize(MemT &mem, size_t pos = 0) const over {    \
-        return serializer::serializeWithId<Ser, decltype(this)>(mem, pos,      \
-                                                                __VA_ARGS__);  \
+        return serializer::serFun<Ser, decltype(this)>(mem, pos, __VA_ARGS__); \
     }                                                                          \
     constexpr virt size_t deserialize(MemT &mem, size_t pos = 0) over {        \
-        return serializer::deserializeWithId<Ser, decltype(this)>(             \
-            mem, pos, __VA_ARGS__);                                            \
+        return serializer::deserFun<Ser, decltype(this)>(mem, pos,             \
+                                                         __VA_ARGS__);         \
+    }                                                                          \
+    constexpr auto serializedMembers() const {                                 \
+        return serializer::tools::members(__VA_ARGS__);                        \
+    }                                                                          \
+    constexpr auto serializedMembers() {                                       \
+        return serializer::tools::members(__VA_ARGS__);                        \
     }
 
 /// @brief Generate the serialze and deserialize methods with the specified
@@ -35,6 +54,39 @@
     __SERIALIZE__(serializer::Serializer<decltype(mem)>, auto, /* virt */,     \
                   /* over */, __VA_ARGS__)
 
+/// @brief Generate the serialize and deserialize methods with the specified
+///        serializer. A table of the offsets of the members is serialized
+///        before the members (see serializeWithIndex).
+/// @param Ser Serializer.
+/// @param ... Members to serialize.
+#define SERIALIZE_CUSTOM_INDEXED(Ser, ...)                                     \
+    static constexpr bool serialized_with_index = true;                        \
+    __SERIALIZE_WITH__(serializeWithIndex, deserializeWithIndex, Ser, auto,    \
+                       /* virt */, /* over */, __VA_ARGS__)
+
+/// @brief Generate the serialize and deserialize methods with the default
+///        serializer and a table of the offsets of the members.
+/// @param ... Members to serialize.
+#define SERIALIZE_INDEXED(...)                                                 \
+    SERIALIZE_CUSTOM_INDEXED(serializer::Serializer<decltype(mem)>,            \
+                             __VA_ARGS__)
+
+/// @brief Generate the (non virtual) serialize and deserialize methods of a
+///        class of a polymorphic hierarchy registered in the type table. The
+///        id of the type is serialized before the members. The pointers to
+///        the base classes of the hierarchy are serialized with the methods
+///        of their dynamic type found with the type table (the base classes
+///        must not declare serialize methods), so the same hierarchy can be
+///        serialized in any memory buffer.
+/// @param Table Type table of the hierarchy.
+/// @param ... Members to serialize.
+#define SERIALIZE_POLYMORPHIC(Table, ...)                                      \
+    using polymorphic_type_table = Table;                                      \
+    template <typename MemT>                                                   \
+    using polymorphic_serializer_type = serializer::Serializer<MemT, Table>;  \
+    __SERIALIZE__(polymorphic_serializer_type<decltype(mem)>, auto,            \
+                  /* virt */, /* over */, __VA_ARGS__)
+
 /// @brief Generate the serialze and deserialize virtual methods using the
 ///        specified serializer.
 /// @param Ser Serializer
@@ -70,12 +122,14 @@
     virtual size_t deserialize(typename Ser::mem_type &, size_t = 0) = 0;
 
 /// @brief Generate the serialize and deserialize methods that use the
-///        (de)serialize functions.
+///        (de)serialize functions. The object is a plain copy of its bytes, so
+///        the arrays of such objects are copied in bulk.
 #define SERIALIZE_STRUCT()                                                     \
+    static constexpr bool bitwise_serializable = true;                         \
     constexpr size_t serialize(auto &mem, size_t pos = 0) const {              \
         return serializer::serializeStruct(mem, pos, this);                    \
     }                                                                          \
-    constexpr size_t deserialize(auto const &mem, size_t pos = 0) {            \
+    constexpr size_t deserialize(auto &mem, size_t pos = 0) {                  \
         return serializer::deserializeStruct(mem, pos, this);                  \
     }
 
@@ -89,6 +143,30 @@
 ///            value or size_t& by reference)
 #define SER_DARR(...) serializer::tools::DynamicArray(__VA_ARGS__)
 
+/// @brief Helper macro for the multi-dimensional dynamic arrays stored in one
+///        contiguous allocation (serialized in bulk).
+/// @param ptr Pointer of the array (int** for a 2D array).
+/// @param ... Dimensions of the array (one per pointer level).
+#define SER_DARR_CONTIGUOUS(...) serializer::tools::ContiguousArray(__VA_ARGS__)
+
+/// @brief Helper macro for the blocks of a row-major matrix (only the elements
+///        of the block are serialized).
+/// @param ptr Pointer to the first element of the block.
+/// @param rows Number of rows of the block.
+/// @param cols Number of columns of the block.
+/// @param stride Number of elements between two rows of the matrix.
+#define SER_STRIDED(ptr, rows, cols, stride)                                   \
+    serializer::tools::StridedArray(ptr, rows, cols, stride)
+
+/// @brief Helper macro for the members serialized with a numeric codec.
+/// @param codec Codec (ex: serializer::tools::SparseCodec{}).
+/// @param data  Contiguous container or SER_DARR of one dimension.
+#define SER_ENCODED(codec, data) serializer::tools::Encoded(codec, data)
+
+/// @brief Helper macro for the containers serialized column by column.
+/// @param container Container of SERIALIZE objects.
+#define SER_COLUMNS(container) serializer::tools::Columnar(container)
+
 /// @brief Helper macro for SERIALIZE_CUSTOM (get the type of the bytes buffer)
 #define SER_MEMT decltype(mem)
 
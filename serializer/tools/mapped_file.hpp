@@ -0,0 +1,212 @@
+#ifndef SERIALIZER_MAPPED_FILE_H
+#define SERIALIZER_MAPPED_FILE_H
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+/******************************************************************************/
+/*                                mapped file                                 */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Memory buffer backed by a memory-mapped file (Linux only). In write
+///        mode, the serializer writes directly into the mapping which grows
+///        with ftruncate / mremap, and the file is truncated to the serialized
+///        size when it is closed. In read mode, the file is mapped read-only
+///        and can be deserialized without being copied to the heap.
+/// @tparam T Byte type (std::byte, uint8_t, char, ...).
+template <typename T>
+    requires(sizeof(T) == sizeof(char))
+class MappedFile {
+  public:
+    /* type alias *************************************************************/
+
+    using byte_type = T;
+
+    /// @brief Access mode of the file.
+    enum class Mode {
+        Read,  ///< read-only mapping of an existing file
+        Write, ///< the file is created (or truncated) and can be written
+    };
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Open and map a file.
+    /// @param path     Path to the file.
+    /// @param mode     Access mode (read-only or write).
+    /// @param capacity Initial capacity of the mapping in write mode.
+    /// @throw std::system_error if the file cannot be opened or mapped.
+    MappedFile(std::string const &path, Mode mode = Mode::Read,
+               size_t capacity = 4096)
+        : mode_(mode) {
+        int flags = mode_ == Mode::Read ? O_RDONLY : O_RDWR | O_CREAT | O_TRUNC;
+        fd_ = ::open(path.c_str(), flags, 0644);
+        check(fd_ >= 0, "open");
+        try {
+            if (mode_ == Mode::Read) {
+                struct stat st;
+                check(::fstat(fd_, &st) == 0, "fstat");
+                size_ = capacity_ = (size_t)st.st_size;
+                if (capacity_ > 0) {
+                    map(PROT_READ);
+                }
+            } else {
+                alloc(capacity);
+            }
+        } catch (...) {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    MappedFile(MappedFile<T> const &) = delete;
+    MappedFile<T> &operator=(MappedFile<T> const &) = delete;
+
+    /// @brief Move constructor.
+    MappedFile(MappedFile<T> &&other) noexcept
+        : mem_(other.mem_), capacity_(other.capacity_), size_(other.size_),
+          fd_(other.fd_), mode_(other.mode_) {
+        other.mem_ = nullptr;
+        other.fd_ = -1;
+    }
+
+    /// @brief Destructor (the file is truncated to its size in write mode).
+    ~MappedFile() { close(); }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns a pointer to the mapping.
+    T *data() { return mem_; }
+
+    /// @brief Returns a const pointer to the mapping.
+    T const *data() const { return mem_; }
+
+    /// @brief Returns the capacity of the mapping.
+    size_t capacity() const { return capacity_; }
+
+    /// @brief Returns the number of bytes stored in the file.
+    size_t size() const { return size_; }
+
+    /// @breif Clear the buffer (set the size to 0 but do not unmap).
+    void clear() { size_ = 0; }
+
+    /* append *****************************************************************/
+
+    /// @brief Appends some bytes at pos (same semantic as Bytes::append).
+    /// @param pos     Position where the bytes are appended.
+    /// @param bytes   Buffer of bytes to append.
+    /// @param nbBytes Number of bytes to append.
+    void append(size_t pos, T const *bytes, size_t nbBytes) {
+        upsize(pos + nbBytes);
+        size_ = pos + nbBytes;
+        std::memcpy(mem_ + pos, bytes, nbBytes);
+    }
+
+    /* change size and capacity ***********************************************/
+
+    /// @brief Increase the capacity of the mapping if size bytes cannot be
+    ///        stored (the capacity is doubled).
+    /// @param size New size.
+    void upsize(size_t size) {
+        if (size > capacity_) [[unlikely]] {
+            alloc(size > capacity_ * 2 ? size : capacity_ * 2);
+        }
+    }
+
+    /// @brief Increase the capacity of the mapping to exactly `capacity` bytes
+    ///        if it is too small.
+    /// @param capacity Minimal capacity of the mapping.
+    void reserve(size_t capacity) {
+        if (capacity > capacity_) {
+            alloc(capacity);
+        }
+    }
+
+    /// @brief Change the size of the file.
+    /// @param size New size.
+    void resize(size_t size) {
+        reserve(size);
+        size_ = size;
+    }
+
+    /// @brief Grow the file and the mapping (write mode only).
+    /// @param newCapacity New capacity of the mapping.
+    /// @throw std::system_error if the file cannot be resized or remapped.
+    void alloc(size_t newCapacity) {
+        if (mode_ == Mode::Read) {
+            throw std::system_error(EBADF, std::generic_category(),
+                                    "error: the mapped file is read-only");
+        }
+        if (newCapacity == 0) {
+            return;
+        }
+        check(::ftruncate(fd_, (off_t)newCapacity) == 0, "ftruncate");
+        if (mem_ == nullptr) {
+            capacity_ = newCapacity;
+            map(PROT_READ | PROT_WRITE);
+        } else {
+            void *ptr = ::mremap(mem_, capacity_, newCapacity, MREMAP_MAYMOVE);
+            check(ptr != MAP_FAILED, "mremap");
+            mem_ = static_cast<T *>(ptr);
+            capacity_ = newCapacity;
+        }
+    }
+
+    /// @brief Unmap and close the file. In write mode, the file is truncated
+    ///        to the number of bytes stored.
+    void close() {
+        if (mem_) {
+            ::munmap(mem_, capacity_);
+            mem_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            if (mode_ == Mode::Write) {
+                [[maybe_unused]] int r = ::ftruncate(fd_, (off_t)size_);
+            }
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    /* operators **************************************************************/
+
+    /// @brief Give read/write access to the byte `idx`.
+    T &operator[](size_t idx) { return mem_[idx]; }
+
+    /// @brief Give read access to the byte `idx`
+    T const &operator[](size_t idx) const { return mem_[idx]; }
+
+  private:
+    T *mem_ = nullptr;    ///< mapped memory
+    size_t capacity_ = 0; ///< size of the mapping
+    size_t size_ = 0;     ///< number of bytes stored
+    int fd_ = -1;         ///< file descriptor
+    Mode mode_;           ///< access mode
+
+    /// @brief Map capacity_ bytes of the file.
+    void map(int prot) {
+        void *ptr = ::mmap(nullptr, capacity_, prot, MAP_SHARED, fd_, 0);
+        check(ptr != MAP_FAILED, "mmap");
+        mem_ = static_cast<T *>(ptr);
+    }
+
+    /// @brief Throws a std::system_error build from errno if cond is false.
+    static void check(bool cond, char const *what) {
+        if (!cond) [[unlikely]] {
+            throw std::system_error(errno, std::generic_category(),
+                                    std::string("error: ") + what);
+        }
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef SERIALIZER_MEASURE_H
+#define SERIALIZER_MEASURE_H
+#include "../meta/type_check.hpp"
+#include "memory_wrapper.hpp"
+#include <cstddef>
+
+/******************************************************************************/
+/*                                  measure                                   */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Memory buffer that doesn't store anything. When it is used as the
+///        memory of the serializer, the serialization only advances the
+///        position, which gives the exact size of the serialized data.
+/// @tparam T Byte type (std::byte, uint8_t, char, ...).
+template <typename T>
+    requires(sizeof(T) == sizeof(char))
+class Measure {
+  public:
+    /* type alias *************************************************************/
+
+    using byte_type = T;
+
+    /// @brief Nothing is stored (see concepts::MeasuresOnly).
+    static constexpr bool measures_only = true;
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the number of bytes that would have been stored.
+    constexpr size_t size() const { return size_; }
+
+    /// @breif Reset the measured size.
+    constexpr void clear() { size_ = 0; }
+
+    /* append *****************************************************************/
+
+    /// @brief Measure an append (same semantic as Bytes::append, the size is
+    ///        always equal to `pos + count` at the end).
+    /// @param pos     Position where the bytes would be appended.
+    /// @param nbBytes Number of bytes to append.
+    constexpr void append(size_t pos, T const *, size_t nbBytes) {
+        size_ = pos + nbBytes;
+    }
+
+  private:
+    size_t size_ = 0; ///< number of bytes measured
+};
+
+/// @brief Measure that keeps the format of another memory buffer (compact
+///        encoding, byte order, see Policies), so the measured size is the
+///        size of the data serialized into this memory.
+/// @tparam MemT Type of the memory buffer which format is measured.
+template <typename MemT>
+class MeasureOf : public Measure<mtf::byte_type_t<MemT>>,
+                  public Policies<MemT> {};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef SERIALIZER_MEMORY_WRAPPER_H
+#define SERIALIZER_MEMORY_WRAPPER_H
+#include "../meta/concepts.hpp"
+#include "../meta/type_check.hpp"
+#include <bit>
+#include <cstddef>
+
+/******************************************************************************/
+/*                               memory wrapper                               */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Implementation of the memory wrappers.
+namespace wrapper_impl {
+
+/// @brief Byte order of a memory buffer (only defined when the order is fixed,
+///        see concepts::FixedByteOrder).
+template <typename MemT> struct ByteOrder {};
+
+template <typename MemT>
+    requires concepts::FixedByteOrder<MemT>
+struct ByteOrder<MemT> {
+    static constexpr std::endian byte_order = mtf::clean_t<MemT>::byte_order;
+};
+
+} // end namespace wrapper_impl
+
+/// @brief Flags of a memory buffer that change the format of the data or the
+///        checks of the deserialization (compact encoding, byte order, bounds
+///        checks and reuse of the pointees). The memories derived from it
+///        serialize with the same format as MemT.
+/// @tparam MemT Type of the memory buffer which flags are kept.
+template <typename MemT> struct Policies : wrapper_impl::ByteOrder<MemT> {
+    static constexpr bool compact_sizes = concepts::CompactSizes<MemT>;
+    static constexpr bool compact_integers = concepts::CompactIntegers<MemT>;
+    static constexpr bool bounds_checked = concepts::BoundsChecked<MemT>;
+    static constexpr bool reuse_objects = concepts::ReusesObjects<MemT>;
+};
+
+/// @brief Base class of the memory wrappers (WithArena, Compact, ...). It
+///        forwards the flags and the memory functions that the wrapped buffer
+///        provides, so the wrappers can be combined.
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class MemoryWrapper : public Policies<MemT> {
+  public:
+    /* type alias *************************************************************/
+
+    using byte_type = mtf::byte_type_t<MemT>;
+
+    /// @brief True if the wrapped buffer only measures the size.
+    static constexpr bool measures_only = concepts::MeasuresOnly<MemT>;
+
+    /// @brief True if the wrapped buffer serializes the large containers with
+    ///        several threads.
+    static constexpr bool parallel_containers =
+        concepts::ParallelContainers<MemT>;
+
+    /// @brief True if the wrapped buffer is notified of the members.
+    static constexpr bool track_members = concepts::TracksMembers<MemT>;
+
+    /* constructor ************************************************************/
+
+    /// @brief Constructor from the wrapped memory buffer.
+    constexpr explicit MemoryWrapper(MemT &mem) : mem_(mem) {}
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the wrapped buffer.
+    constexpr MemT &mem() { return mem_; }
+
+    /// @brief Returns a pointer to the wrapped buffer.
+    constexpr auto data()
+        requires concepts::DataAccessible<MemT>
+    {
+        return mem_.data();
+    }
+
+    /// @brief Returns a const pointer to the wrapped buffer.
+    constexpr auto data() const
+        requires concepts::DataAccessible<MemT>
+    {
+        return mem_.data();
+    }
+
+    /// @brief Returns the size of the wrapped buffer.
+    constexpr size_t size() const { return mem_.size(); }
+
+    /// @brief Give access to the byte `idx` of the wrapped buffer.
+    constexpr decltype(auto) operator[](size_t idx) { return mem_[idx]; }
+
+    /// @brief Give read access to the byte `idx` of the wrapped buffer.
+    constexpr decltype(auto) operator[](size_t idx) const { return mem_[idx]; }
+
+    /* forwarded memory functions *********************************************/
+
+    constexpr void append(size_t pos, byte_type const *bytes, size_t nbBytes)
+        requires concepts::Appendable<MemT>
+    {
+        mem_.append(pos, bytes, nbBytes);
+    }
+
+    constexpr void appendExternal(size_t pos, byte_type const *bytes,
+                                  size_t nbBytes)
+        requires concepts::ReferencesBlocks<MemT>
+    {
+        mem_.appendExternal(pos, bytes, nbBytes);
+    }
+
+    constexpr void resize(size_t size)
+        requires concepts::Resizeable<MemT>
+    {
+        mem_.resize(size);
+    }
+
+    constexpr decltype(auto) fetch(size_t pos, size_t nbBytes)
+        requires concepts::Fetchable<MemT>
+    {
+        return mem_.fetch(pos, nbBytes);
+    }
+
+    constexpr void read(size_t pos, byte_type *dest, size_t nbBytes)
+        requires concepts::Fetchable<MemT>
+    {
+        mem_.read(pos, dest, nbBytes);
+    }
+
+    constexpr decltype(auto) arena()
+        requires concepts::HasArena<MemT>
+    {
+        return mem_.arena();
+    }
+
+    constexpr decltype(auto) objects()
+        requires concepts::TracksObjects<MemT>
+    {
+        return mem_.objects();
+    }
+
+    constexpr decltype(auto) strings()
+        requires concepts::InternsStrings<MemT>
+    {
+        return mem_.strings();
+    }
+
+    constexpr decltype(auto) instrumentation()
+        requires concepts::Instrumented<MemT>
+    {
+        return mem_.instrumentation();
+    }
+
+    constexpr size_t nbThreads() const
+        requires concepts::ParallelContainers<MemT>
+    {
+        return mem_.nbThreads();
+    }
+
+    constexpr bool parallel(size_t nbElements) const
+        requires concepts::ParallelContainers<MemT>
+    {
+        return mem_.parallel(nbElements);
+    }
+
+    constexpr void enter(size_t pos)
+        requires concepts::TracksMembers<MemT>
+    {
+        mem_.enter(pos);
+    }
+
+    constexpr void leave()
+        requires concepts::TracksMembers<MemT>
+    {
+        mem_.leave();
+    }
+
+    constexpr void member(size_t pos)
+        requires requires(MemT mem) { mem.member(size_t(0)); }
+    {
+        mem_.member(pos);
+    }
+
+    constexpr bool select()
+        requires requires(MemT mem) { mem.select(); }
+    {
+        return mem_.select();
+    }
+
+  private:
+    MemT &mem_; ///< wrapped memory buffer
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,416 @@
+#ifndef SERIALIZER_MPI_H
+#define SERIALIZER_MPI_H
+#include "../exceptions/corrupted_data.hpp"
+#include "../meta/serializer_meta.hpp"
+#include "../serialize.hpp"
+#include "pinned.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+// only the C API is used (the deprecated C++ bindings need another library)
+#ifndef OMPI_SKIP_MPICXX
+#define OMPI_SKIP_MPICXX
+#endif
+#ifndef MPICH_SKIP_MPICXX
+#define MPICH_SKIP_MPICXX
+#endif
+#include <mpi.h>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Implementation of the MPI module.
+namespace mpi_impl {
+
+/// @brief Size of the header of the messages (size of the payload).
+constexpr size_t header_size = sizeof(uint64_t);
+
+/// @brief Throw if an MPI function failed (only for the communicators which
+///        error handler returns the errors, see MPI_ERRORS_RETURN).
+/// @throw std::runtime_error if code is not MPI_SUCCESS.
+inline void check(int code, char const *function) {
+    if (code != MPI_SUCCESS) [[unlikely]] {
+        char message[MPI_MAX_ERROR_STRING];
+        int length = 0;
+        MPI_Error_string(code, message, &length);
+        throw std::runtime_error(std::string("error: ") + function +
+                                 " failed: " + std::string(message, length));
+    }
+}
+
+/// @brief Allocate memory with MPI_Alloc_mem.
+inline void *allocate(size_t size) {
+    void *ptr = nullptr;
+    if (MPI_Alloc_mem(MPI_Aint(size), MPI_INFO_NULL, &ptr) != MPI_SUCCESS) {
+        return nullptr;
+    }
+    return ptr;
+}
+
+/// @brief Free memory allocated with MPI_Alloc_mem.
+inline void deallocate(void *ptr, size_t) { MPI_Free_mem(ptr); }
+
+} // end namespace mpi_impl
+
+/// @brief Host allocator that uses MPI_Alloc_mem (the MPI implementations
+///        return registered memory, so the transfers don't need a copy).
+inline constexpr HostAllocator mpi_allocator = {&mpi_impl::allocate,
+                                                &mpi_impl::deallocate};
+
+/******************************************************************************/
+/*                                  datatype                                  */
+/******************************************************************************/
+
+/// @brief Committed MPI datatype of a type which serialized form is a copy of
+///        its bytes (SERIALIZE_STRUCT): the arrays of T are sent from and
+///        received into the user memory without packing. The layout is not
+///        converted, so the ranks must share the same architecture.
+/// @tparam T Bitwise serializable type.
+template <concepts::BitwiseSerializable T> class MpiDatatype {
+  public:
+    /// @brief Constructor (creates and commits the type).
+    MpiDatatype() {
+        mpi_impl::check(MPI_Type_contiguous(int(sizeof(T)), MPI_BYTE, &type_),
+                        "MPI_Type_contiguous");
+        mpi_impl::check(MPI_Type_commit(&type_), "MPI_Type_commit");
+    }
+
+    MpiDatatype(MpiDatatype const &) = delete;
+    MpiDatatype &operator=(MpiDatatype const &) = delete;
+
+    /// @brief Destructor (the pending operations that use the type are not
+    ///        affected).
+    ~MpiDatatype() { MPI_Type_free(&type_); }
+
+    /// @brief Returns the MPI datatype.
+    MPI_Datatype get() const { return type_; }
+
+  private:
+    MPI_Datatype type_ = MPI_DATATYPE_NULL; ///< committed type
+};
+
+/******************************************************************************/
+/*                                  requests                                  */
+/******************************************************************************/
+
+class MpiChannel;
+
+/// @brief Pending nonblocking operations (waited in the destructor).
+class MpiRequests {
+  public:
+    MpiRequests() = default;
+    MpiRequests(MpiRequests &&) = default;
+    MpiRequests &operator=(MpiRequests &&) = delete;
+
+    /// @brief Destructor (waits for the pending operations).
+    ~MpiRequests() {
+        if (!requests_.empty()) {
+            MPI_Waitall(int(requests_.size()), requests_.data(),
+                        MPI_STATUSES_IGNORE);
+        }
+    }
+
+    /// @brief Check if the operations are complete (they are progressed).
+    bool test() {
+        int done = 0;
+        mpi_impl::check(MPI_Testall(int(requests_.size()), requests_.data(),
+                                    &done, MPI_STATUSES_IGNORE),
+                        "MPI_Testall");
+        if (done) {
+            requests_.clear();
+        }
+        return done;
+    }
+
+    /// @brief Wait until the operations are complete.
+    void wait() {
+        mpi_impl::check(MPI_Waitall(int(requests_.size()), requests_.data(),
+                                    MPI_STATUSES_IGNORE),
+                        "MPI_Waitall");
+        requests_.clear();
+    }
+
+  protected:
+    friend class MpiChannel;
+    std::vector<MPI_Request> requests_; ///< pending operations
+};
+
+/// @brief Message being sent: the serialized data is owned by the request and
+///        released when the request is destroyed.
+class MpiSend : public MpiRequests {
+  public:
+    /// @brief Constructor.
+    /// @param allocator Allocator of the buffer.
+    explicit MpiSend(HostAllocator allocator) : bytes_(0, allocator) {}
+
+    /// @brief Returns the sent bytes (header included).
+    PinnedBytes<> const &bytes() const { return bytes_; }
+
+  private:
+    friend class MpiChannel;
+    PinnedBytes<> bytes_; ///< header followed by the serialized data
+};
+
+/// @brief Message being received. The first chunk is received into a buffer
+///        of one chunk, the following ones are received at their final place
+///        once the size of the message is known.
+class MpiReceive : public MpiRequests {
+  public:
+    /* constructor ************************************************************/
+
+    /// @brief Constructor (posts the reception of the first chunk).
+    /// @param comm      Communicator.
+    /// @param source    Rank of the sender (or MPI_ANY_SOURCE).
+    /// @param tag       Tag of the message (or MPI_ANY_TAG).
+    /// @param chunkSize Size of the chunks (same as the sender).
+    /// @param allocator Allocator of the buffer.
+    MpiReceive(MPI_Comm comm, int source, int tag, size_t chunkSize,
+               HostAllocator allocator)
+        : comm_(comm), chunkSize_(chunkSize), bytes_(chunkSize, allocator) {
+        bytes_.resize(chunkSize);
+        requests_.emplace_back();
+        mpi_impl::check(MPI_Irecv(bytes_.data(), int(chunkSize), MPI_BYTE,
+                                  source, tag, comm, &requests_.back()),
+                        "MPI_Irecv");
+    }
+
+    MpiReceive(MpiReceive &&) = default;
+
+    /// @brief Destructor (the pending receptions are cancelled).
+    ~MpiReceive() {
+        for (MPI_Request &request : requests_) {
+            if (request != MPI_REQUEST_NULL) {
+                MPI_Cancel(&request);
+            }
+        }
+    }
+
+    /* progress ***************************************************************/
+
+    /// @brief Check if the message is received (the reception is progressed).
+    /// @throw exceptions::CorruptedDataError if the header is invalid.
+    bool test() {
+        if (!headerReceived_) {
+            int done = 0;
+            MPI_Status status;
+            mpi_impl::check(MPI_Test(&requests_.back(), &done, &status),
+                            "MPI_Test");
+            if (!done) {
+                return false;
+            }
+            requests_.clear();
+            receiveChunks(status);
+        }
+        return MpiRequests::test();
+    }
+
+    /// @brief Wait until the message is received.
+    /// @throw exceptions::CorruptedDataError if the header is invalid.
+    void wait() {
+        if (!headerReceived_) {
+            MPI_Status status;
+            mpi_impl::check(MPI_Wait(&requests_.back(), &status), "MPI_Wait");
+            requests_.clear();
+            receiveChunks(status);
+        }
+        MpiRequests::wait();
+    }
+
+    /* deserialization ********************************************************/
+
+    /// @brief Wait for the message and deserialize it.
+    /// @tparam Ser Serializer type.
+    /// @param args references to the variables that are deserialized.
+    /// @return Number of deserialized bytes.
+    template <typename Ser = Serializer<PinnedBytes<>>>
+    size_t deserialize(auto &&...args) {
+        wait();
+        return serializer::deserialize<Ser>(bytes_, mpi_impl::header_size,
+                                            args...) -
+               mpi_impl::header_size;
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the rank of the sender (once the first chunk is
+    ///        received).
+    int source() const { return source_; }
+
+    /// @brief Returns the tag of the message (once the first chunk is
+    ///        received).
+    int tag() const { return tag_; }
+
+    /// @brief Returns the received bytes (header included).
+    PinnedBytes<> const &bytes() const { return bytes_; }
+
+  private:
+    MPI_Comm comm_;              ///< communicator
+    size_t chunkSize_;           ///< size of the chunks
+    PinnedBytes<> bytes_;        ///< header followed by the serialized data
+    bool headerReceived_ = false; ///< the first chunk is received
+    int source_ = MPI_ANY_SOURCE;
+    int tag_ = MPI_ANY_TAG;
+
+    /// @brief Read the header and post the reception of the other chunks
+    ///        (from the sender of the first one).
+    void receiveChunks(MPI_Status const &status) {
+        int count = 0;
+        MPI_Get_count(&status, MPI_BYTE, &count);
+        uint64_t size = 0;
+        if (size_t(count) >= mpi_impl::header_size) {
+            std::memcpy(&size, bytes_.data(), mpi_impl::header_size);
+        }
+        size_t end = mpi_impl::header_size + size;
+        if (size_t(count) < mpi_impl::header_size ||
+            size_t(count) != std::min(end, chunkSize_)) [[unlikely]] {
+            throw exceptions::CorruptedDataError(
+                "error: invalid MPI message header.");
+        }
+        headerReceived_ = true;
+        source_ = status.MPI_SOURCE;
+        tag_ = status.MPI_TAG;
+        bytes_.resize(size_t(count));
+        bytes_.resize(end);
+        for (size_t offset = chunkSize_; offset < end; offset += chunkSize_) {
+            requests_.emplace_back();
+            mpi_impl::check(
+                MPI_Irecv(bytes_.data() + offset,
+                          int(std::min(chunkSize_, end - offset)), MPI_BYTE,
+                          source_, tag_, comm_, &requests_.back()),
+                "MPI_Irecv");
+        }
+    }
+};
+
+/******************************************************************************/
+/*                                mpi channel                                 */
+/******************************************************************************/
+
+/// @brief Nonblocking transfer of serialized objects between MPI ranks. The
+///        size of a message is computed with the pre-size pass, so the data is
+///        serialized once into a buffer allocated with MPI_Alloc_mem. The
+///        message starts with its size and is sent in chunks of chunkSize
+///        bytes: the receiver posts the reception of the first chunk without
+///        knowing the size, then receives the other chunks directly at their
+///        place (no size round trip, and the large DynamicArray payloads are
+///        pipelined instead of waiting for one large rendezvous transfer).
+///        The messages with the same source and tag are received in order,
+///        but only one of them can be pending on the receiver side.
+class MpiChannel {
+  public:
+    /// @brief Constructor.
+    /// @param comm      Communicator.
+    /// @param chunkSize Size of the chunks (the same on all the ranks).
+    /// @param allocator Allocator of the message buffers.
+    /// @throw std::invalid_argument if the chunk size is invalid.
+    explicit MpiChannel(MPI_Comm comm = MPI_COMM_WORLD,
+                        size_t chunkSize = 1 << 20,
+                        HostAllocator allocator = mpi_allocator)
+        : comm_(comm), chunkSize_(chunkSize), allocator_(allocator) {
+        if (chunkSize < mpi_impl::header_size || chunkSize > INT_MAX) {
+            throw std::invalid_argument(
+                "error: invalid MPI chunk size " + std::to_string(chunkSize) +
+                ".");
+        }
+    }
+
+    /* serialized messages ****************************************************/
+
+    /// @brief Serialize the arguments and post the sends of the chunks.
+    /// @tparam Ser Serializer type (its type table and additional types are
+    ///             used, see serializeExact and MpiReceive::deserialize).
+    /// @param dest Rank of the receiver.
+    /// @param tag  Tag of the message.
+    /// @param args Values to serialize.
+    /// @return Pending send (owns the serialized data).
+    template <typename Ser = Serializer<PinnedBytes<>>>
+    MpiSend send(int dest, int tag, auto const &...args) {
+        MpiSend request(allocator_);
+        PinnedBytes<> &bytes = request.bytes_;
+        size_t end =
+            serializeExact<Ser>(bytes, mpi_impl::header_size, args...);
+        uint64_t size = end - mpi_impl::header_size;
+        std::memcpy(bytes.data(), &size, mpi_impl::header_size);
+
+        for (size_t offset = 0; offset < end; offset += chunkSize_) {
+            request.requests_.emplace_back();
+            mpi_impl::check(
+                MPI_Isend(bytes.data() + offset,
+                          int(std::min(chunkSize_, end - offset)), MPI_BYTE,
+                          dest, tag, comm_, &request.requests_.back()),
+                "MPI_Isend");
+        }
+        return request;
+    }
+
+    /// @brief Post the reception of a message.
+    /// @param source Rank of the sender (or MPI_ANY_SOURCE).
+    /// @param tag    Tag of the message (or MPI_ANY_TAG).
+    /// @return Pending reception (see MpiReceive::deserialize).
+    MpiReceive receive(int source, int tag) {
+        return MpiReceive(comm_, source, tag, chunkSize_, allocator_);
+    }
+
+    /* bitwise structures *****************************************************/
+
+    /// @brief Send an array of bitwise serializable structures from the user
+    ///        memory (no packing, see MpiDatatype).
+    /// @param dest Rank of the receiver.
+    /// @param tag  Tag of the message.
+    /// @param elts Elements to send (must not change until the send is done).
+    /// @return Pending send.
+    /// @throw std::length_error if there are too many elements.
+    template <concepts::BitwiseSerializable T>
+    MpiRequests sendStructs(int dest, int tag, std::span<T const> elts) {
+        MpiDatatype<T> type;
+        MpiRequests request;
+        request.requests_.emplace_back();
+        mpi_impl::check(MPI_Isend(elts.data(), count(elts.size()), type.get(),
+                                  dest, tag, comm_, &request.requests_.back()),
+                        "MPI_Isend");
+        return request;
+    }
+
+    /// @brief Receive an array of bitwise serializable structures directly
+    ///        into the user memory.
+    /// @param source Rank of the sender (or MPI_ANY_SOURCE).
+    /// @param tag    Tag of the message (or MPI_ANY_TAG).
+    /// @param elts   Destination of the elements.
+    /// @return Pending reception.
+    /// @throw std::length_error if there are too many elements.
+    template <concepts::BitwiseSerializable T>
+    MpiRequests receiveStructs(int source, int tag, std::span<T> elts) {
+        MpiDatatype<T> type;
+        MpiRequests request;
+        request.requests_.emplace_back();
+        mpi_impl::check(MPI_Irecv(elts.data(), count(elts.size()), type.get(),
+                                  source, tag, comm_,
+                                  &request.requests_.back()),
+                        "MPI_Irecv");
+        return request;
+    }
+
+  private:
+    MPI_Comm comm_;           ///< communicator
+    size_t chunkSize_;        ///< size of the chunks
+    HostAllocator allocator_; ///< allocator of the message buffers
+
+    /// @brief Convert a number of elements to an MPI count.
+    static int count(size_t size) {
+        if (size > INT_MAX) {
+            throw std::length_error("error: too many elements for MPI.");
+        }
+        return int(size);
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
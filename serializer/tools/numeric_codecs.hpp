@@ -0,0 +1,337 @@
+#ifndef SERIALIZER_NUMERIC_CODECS_H
+#define SERIALIZER_NUMERIC_CODECS_H
+#include "../exceptions/corrupted_data.hpp"
+#include "compact.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define SERIALIZER_NUMERIC_CODECS_X86
+#endif
+
+/******************************************************************************/
+/*                               numeric codecs                               */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Implementation of the numeric codecs.
+namespace numeric_impl {
+
+/// @brief Number of elements processed at once by the codecs (the values are
+///        transformed in a first loop that the compiler can vectorize, then
+///        packed into a local buffer that is appended at once).
+constexpr size_t chunk_size = 64;
+
+/// @brief Software implementation of findNonZero.
+inline size_t findNonZeroScalar(unsigned char const *bytes, size_t begin,
+                                size_t end) {
+    size_t i = begin;
+    if constexpr (std::endian::native == std::endian::little) {
+        for (; i + 8 <= end; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, 8);
+            if (word != 0) {
+                return i + size_t(std::countr_zero(word)) / 8;
+            }
+        }
+    }
+    for (; i < end; ++i) {
+        if (bytes[i] != 0) {
+            return i;
+        }
+    }
+    return end;
+}
+
+#ifdef SERIALIZER_NUMERIC_CODECS_X86
+/// @brief AVX2 implementation of findNonZero.
+__attribute__((target("avx2"))) inline size_t
+findNonZeroAVX2(unsigned char const *bytes, size_t begin, size_t end) {
+    size_t i = begin;
+    __m256i zero = _mm256_setzero_si256();
+    for (; i + 32 <= end; i += 32) {
+        __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<__m256i const *>(bytes + i));
+        auto mask =
+            uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)));
+        if (mask != 0xffffffff) {
+            return i + size_t(std::countr_zero(~mask));
+        }
+    }
+    return findNonZeroScalar(bytes, i, end);
+}
+#endif
+
+/// @brief Returns the position of the first non-zero byte in [begin, end), or
+///        end if all the bytes are 0.
+inline size_t findNonZero(unsigned char const *bytes, size_t begin,
+                          size_t end) {
+#if defined(SERIALIZER_NUMERIC_CODECS_X86)
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2 ? findNonZeroAVX2(bytes, begin, end)
+                : findNonZeroScalar(bytes, begin, end);
+#else
+    return findNonZeroScalar(bytes, begin, end);
+#endif
+}
+
+/// @brief Unsigned integer with the same size as T.
+template <typename T>
+using uint_of_t = std::conditional_t<
+    sizeof(T) == 8, uint64_t,
+    std::conditional_t<sizeof(T) == 4, uint32_t,
+                       std::conditional_t<sizeof(T) == 2, uint16_t, uint8_t>>>;
+
+/// @brief Pointer to the raw bytes of the serializer at its position (the
+///        bounds are checked).
+inline unsigned char const *raw(auto &ser, size_t nbBytes) {
+    return reinterpret_cast<unsigned char const *>(ser.fetch(nbBytes));
+}
+
+/// @brief Append the raw bytes of a local buffer to the serializer.
+inline void appendRaw(auto &ser, unsigned char const *bytes, size_t nbBytes) {
+    using byte_type = typename std::remove_cvref_t<decltype(ser)>::byte_type;
+    ser.append(reinterpret_cast<byte_type const *>(bytes), nbBytes);
+}
+
+} // end namespace numeric_impl
+
+/* sparse *********************************************************************/
+
+/// @brief Codec for the arrays that are mostly zeros: the number of non-zero
+///        elements is followed by the (index delta, value) pairs of the
+///        non-zero elements. The zeros are detected on the bytes (-0.0 is
+///        kept), using AVX2 when it is available. The elements take less than
+///        one byte, so the size of the containers cannot be checked against
+///        the buffer: the bounds checked memories reject the sizes above
+///        maxSize instead.
+struct SparseCodec {
+    size_t maxSize = size_t(1) << 28; ///< maximal number of elements
+
+    /// @brief Encode size elements.
+    template <typename T>
+    void encode(auto &ser, T const *elts, size_t size) const {
+        static_assert(std::is_arithmetic_v<T>,
+                      "The sparse codec requires arithmetic elements.");
+        auto bytes = reinterpret_cast<unsigned char const *>(elts);
+        size_t nbBytes = size * sizeof(T);
+        size_t count = 0;
+        for (size_t i = 0; (i = next<T>(bytes, i, nbBytes)) < nbBytes;
+             i += sizeof(T)) {
+            ++count;
+        }
+        ser.appendVarint(uint64_t(count));
+        size_t last = 0;
+        for (size_t i = 0; (i = next<T>(bytes, i, nbBytes)) < nbBytes;
+             i += sizeof(T)) {
+            size_t idx = i / sizeof(T);
+            ser.appendVarint(uint64_t(idx - last));
+            ser.appendTrivial(elts[idx]);
+            last = idx;
+        }
+    }
+
+    /// @brief Decode size elements.
+    /// @throw exceptions::CorruptedDataError if an index is out of the array.
+    template <typename T> void decode(auto &ser, T *elts, size_t size) const {
+        std::fill(elts, elts + size, T(0));
+        size_t count = size_t(ser.deserializeVarint());
+        size_t idx = 0;
+        for (size_t i = 0; i < count; ++i) {
+            idx += size_t(ser.deserializeVarint());
+            if (idx >= size) [[unlikely]] {
+                throw exceptions::CorruptedDataError(
+                    "invalid sparse index " + std::to_string(idx) + " (" +
+                    std::to_string(size) + " elements).");
+            }
+            elts[idx] = ser.template deserializeTrivial<T>();
+        }
+    }
+
+  private:
+    /// @brief Position of the first byte of the next non-zero element.
+    template <typename T>
+    static size_t next(unsigned char const *bytes, size_t pos, size_t end) {
+        pos = numeric_impl::findNonZero(bytes, pos, end);
+        return pos - pos % sizeof(T);
+    }
+};
+
+/* xor ************************************************************************/
+
+/// @brief Lossless codec for the smooth floating point series (Gorilla-like,
+///        with a byte granularity): each value is xored with the previous
+///        one and only the bytes between the leading and the trailing zero
+///        bytes of the result are stored, after a header byte (number of
+///        trailing zero bytes, number of stored bytes). The close values
+///        share the sign, the exponent and the first bits of the mantissa,
+///        and the repeated values take one byte.
+struct XorCodec {
+    /// @brief Encode size elements.
+    template <typename T>
+    void encode(auto &ser, T const *elts, size_t size) const {
+        static_assert(std::is_floating_point_v<T>,
+                      "The xor codec requires floating point elements.");
+        using U = numeric_impl::uint_of_t<T>;
+        constexpr size_t chunk = numeric_impl::chunk_size;
+        U xored[chunk];
+        unsigned char out[chunk * (1 + sizeof(U))];
+        U prev = 0;
+
+        for (size_t begin = 0; begin < size; begin += chunk) {
+            size_t n = std::min(chunk, size - begin);
+            T const *values = elts + begin;
+            xored[0] = std::bit_cast<U>(values[0]) ^ prev;
+            for (size_t i = 1; i < n; ++i) {
+                xored[i] = std::bit_cast<U>(values[i]) ^
+                           std::bit_cast<U>(values[i - 1]);
+            }
+            prev = std::bit_cast<U>(values[n - 1]);
+            size_t len = 0;
+            for (size_t i = 0; i < n; ++i) {
+                U value = xored[i];
+                if (value == 0) {
+                    out[len++] = 0;
+                    continue;
+                }
+                size_t trailing = size_t(std::countr_zero(value)) / 8;
+                size_t leading = size_t(std::countl_zero(value)) / 8;
+                size_t stored = sizeof(U) - leading - trailing;
+                out[len++] = (unsigned char)((trailing << 4) | stored);
+                value >>= 8 * trailing;
+                for (size_t b = 0; b < stored; ++b) {
+                    out[len++] = (unsigned char)(value >> (8 * b));
+                }
+            }
+            numeric_impl::appendRaw(ser, out, len);
+        }
+    }
+
+    /// @brief Decode size elements.
+    /// @throw exceptions::CorruptedDataError if a header is invalid.
+    template <typename T> void decode(auto &ser, T *elts, size_t size) const {
+        using U = numeric_impl::uint_of_t<T>;
+        U prev = 0;
+
+        for (size_t i = 0; i < size; ++i) {
+            unsigned char header = *numeric_impl::raw(ser, 1);
+            ++ser.pos;
+            size_t trailing = header >> 4, stored = header & 0xf;
+            if (trailing + stored > sizeof(U)) [[unlikely]] {
+                throw exceptions::CorruptedDataError(
+                    "invalid xor header " + std::to_string(header) + ".");
+            }
+            unsigned char const *bytes = numeric_impl::raw(ser, stored);
+            U value = 0;
+            for (size_t b = 0; b < stored; ++b) {
+                value |= U(U(bytes[b]) << (8 * b));
+            }
+            ser.pos += stored;
+            if (stored > 0) {
+                value <<= 8 * trailing;
+            }
+            prev ^= value;
+            elts[i] = std::bit_cast<T>(prev);
+        }
+    }
+};
+
+/* quantized ******************************************************************/
+
+/// @brief Lossy codec that stores the values rounded to a multiple of step
+///        (the error is at most step / 2): the number of steps is delta
+///        encoded with zigzag varints, so the smooth series take one or two
+///        bytes per element.
+struct QuantizedCodec {
+    double step; ///< quantization step
+
+    /// @brief Constructor.
+    /// @param step Quantization step (must be positive).
+    /// @throw std::invalid_argument if the step is not positive.
+    constexpr explicit QuantizedCodec(double step) : step(step) {
+        if (!(step > 0)) {
+            throw std::invalid_argument(
+                "error: the quantization step must be positive.");
+        }
+    }
+
+    /// @brief Encode size elements.
+    /// @throw std::out_of_range if a value cannot be quantized (too large or
+    ///        NaN).
+    template <typename T>
+    void encode(auto &ser, T const *elts, size_t size) const {
+        static_assert(std::is_arithmetic_v<T>,
+                      "The quantized codec requires arithmetic elements.");
+        constexpr size_t chunk = numeric_impl::chunk_size;
+        constexpr double limit = double(int64_t(1) << 62);
+        double inverse = 1.0 / step;
+        double scaled[chunk];
+        unsigned char out[chunk * varint_max_size];
+        int64_t prev = 0;
+
+        for (size_t begin = 0; begin < size; begin += chunk) {
+            size_t n = std::min(chunk, size - begin);
+            bool valid = true;
+            for (size_t i = 0; i < n; ++i) {
+                scaled[i] = double(elts[begin + i]) * inverse;
+                valid &= std::abs(scaled[i]) < limit;
+            }
+            if (!valid) {
+                throw std::out_of_range(
+                    "error: the value cannot be quantized.");
+            }
+            size_t len = 0;
+            for (size_t i = 0; i < n; ++i) {
+                auto q = int64_t(std::round(scaled[i]));
+                len += varintEncode(zigzagEncode(q - prev), out + len);
+                prev = q;
+            }
+            numeric_impl::appendRaw(ser, out, len);
+        }
+    }
+
+    /// @brief Decode size elements.
+    template <typename T> void decode(auto &ser, T *elts, size_t size) const {
+        int64_t q = 0;
+        for (size_t i = 0; i < size; ++i) {
+            q += zigzagDecode(ser.deserializeVarint());
+            if constexpr (std::is_integral_v<T>) {
+                elts[i] = T(std::round(double(q) * step));
+            } else {
+                elts[i] = T(double(q) * step);
+            }
+        }
+    }
+};
+
+/* encoded ********************************************************************/
+
+/// @brief Wrapper that serializes a member with a numeric codec (SparseCodec,
+///        XorCodec, QuantizedCodec or any type with the same encode / decode
+///        functions, and a maxSize member if the elements can take less than
+///        one byte). The data is either a one-dimensional DynamicArray (the
+///        null pointer marker is kept and the array is allocated if needed)
+///        or a contiguous container (the size is stored first).
+/// @tparam Codec Type of the codec.
+/// @tparam Data DynamicArray or reference to a container.
+template <typename Codec, typename Data> struct Encoded {
+    Codec codec; ///< codec of the elements
+    Data data;   ///< DynamicArray or reference to the container
+};
+
+template <typename Codec, typename Data>
+Encoded(Codec, Data &&) -> Encoded<Codec, Data>;
+
+} // end namespace serializer::tools
+
+#endif
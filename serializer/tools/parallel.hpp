@@ -0,0 +1,114 @@
+#ifndef SERIALIZER_PARALLEL_H
+#define SERIALIZER_PARALLEL_H
+#include "memory_wrapper.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                                parallel for                                */
+/******************************************************************************/
+
+/// @brief Call fn(begin, end) on chunks of [0, size) using several threads.
+///        The threads pick the chunks using a shared atomic cursor, so the
+///        load is balanced when the cost of the elements varies. The calling
+///        thread takes part in the work.
+/// @param nbThreads Number of threads (0 uses the number of cores).
+/// @param size      Number of elements.
+/// @param fn        Function called on the ranges of elements (thread-safe).
+/// @throw The first exception thrown by fn (the other threads stop).
+inline void parallelFor(size_t nbThreads, size_t size, auto &&fn) {
+    if (nbThreads == 0) {
+        nbThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    nbThreads = std::max(std::min(nbThreads, size), size_t(1));
+
+    // small chunks balance the load while limiting the contention on the
+    // cursor
+    size_t chunk = std::max(size / (nbThreads * 16), size_t(1));
+    std::atomic<size_t> cursor = 0;
+    std::exception_ptr error = nullptr;
+    std::mutex errorMutex;
+
+    auto work = [&] {
+        try {
+            size_t begin;
+            while ((begin = cursor.fetch_add(chunk)) < size) {
+                fn(begin, std::min(begin + chunk, size));
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            cursor = size;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < nbThreads; ++i) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/******************************************************************************/
+/*                                  parallel                                  */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper that enables the parallel serialization of
+///        the large containers of non trivial elements. The sizes of the
+///        elements are measured first, the offsets are computed with a prefix
+///        sum and then the threads write the elements directly into their
+///        slots. The output is identical to the sequential serialization.
+///        The wrapped memory must be accessible through data() and the nested
+///        containers are serialized sequentially.
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class Parallel : public MemoryWrapper<MemT> {
+  public:
+    static constexpr bool parallel_containers = true;
+
+    /* constructor ************************************************************/
+
+    /// @brief Constructor from the wrapped memory buffer.
+    /// @param mem         Memory buffer in which the data is written.
+    /// @param nbThreads   Number of threads (0 uses the number of cores).
+    /// @param minElements Minimal number of elements of the containers that
+    ///                    are serialized in parallel.
+    constexpr explicit Parallel(MemT &mem, size_t nbThreads = 0,
+                                size_t minElements = 256)
+        : MemoryWrapper<MemT>(mem), nbThreads_(nbThreads),
+          minElements_(minElements) {}
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the number of threads (0 is the number of cores).
+    constexpr size_t nbThreads() const { return nbThreads_; }
+
+    /// @brief Returns true if a container of nbElements elements should be
+    ///        serialized in parallel.
+    constexpr bool parallel(size_t nbElements) const {
+        return nbThreads_ != 1 && nbElements >= minElements_;
+    }
+
+  private:
+    size_t nbThreads_;   ///< number of threads
+    size_t minElements_; ///< minimal size of the parallel containers
+};
+
+} // end namespace serializer::tools
+
+#endif
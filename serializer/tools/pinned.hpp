@@ -0,0 +1,349 @@
+#ifndef SERIALIZER_PINNED_H
+#define SERIALIZER_PINNED_H
+#include "arena.hpp"
+#include "memory_wrapper.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <sys/mman.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                               host allocator                               */
+/******************************************************************************/
+
+/// @brief Allocation hooks used for the host memory of the pinned buffers. The
+///        default one locks anonymous mappings with mlock, the GPU runtimes
+///        can be plugged with captureless lambdas, for instance:
+///        `HostAllocator{[](size_t n) { void *p = nullptr;
+///        cudaHostAlloc(&p, n, cudaHostAllocDefault); return p; },
+///        [](void *p, size_t) { cudaFreeHost(p); }}`.
+struct HostAllocator {
+    void *(*allocate)(size_t size);           ///< returns nullptr on failure
+    void (*deallocate)(void *ptr, size_t size); ///< size given to allocate
+};
+
+/// @brief Implementation of the page-locked allocator.
+namespace pinned_impl {
+
+/// @brief Returns the size of the memory pages.
+inline size_t pageSize() {
+    static const size_t size = size_t(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+/// @brief Map and lock size bytes (the pages are faulted in by mlock).
+/// @return nullptr if the memory cannot be mapped or locked (see
+///         RLIMIT_MEMLOCK).
+inline void *allocate(size_t size) {
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return nullptr;
+    }
+    if (mlock(ptr, size) != 0) {
+        munmap(ptr, size);
+        return nullptr;
+    }
+    return ptr;
+}
+
+/// @brief Unlock and unmap memory returned by allocate.
+inline void deallocate(void *ptr, size_t size) {
+    munlock(ptr, size);
+    munmap(ptr, size);
+}
+
+} // end namespace pinned_impl
+
+/// @brief Page-locked host memory (mlock): the pages stay resident, so the
+///        DMA transfers don't need a bounce buffer (the GPU runtimes still
+///        have to register the memory to use it as pinned memory, see
+///        HostAllocator to allocate with the runtime directly).
+inline constexpr HostAllocator page_locked_allocator = {
+    &pinned_impl::allocate, &pinned_impl::deallocate};
+
+/******************************************************************************/
+/*                                pinned bytes                                */
+/******************************************************************************/
+
+/// @brief Memory buffer with the same interface as Bytes which storage is
+///        allocated with a HostAllocator (page-locked memory by default), so
+///        the serialized messages can be sent to a device without staging
+///        copy. The capacity is a multiple of the page size and the buffer is
+///        movable but not copyable (the pinned memory is a limited resource).
+/// @tparam T Byte type (std::byte, uint8_t, char, ...).
+template <typename T = std::byte>
+    requires(sizeof(T) == sizeof(char))
+class PinnedBytes {
+  public:
+    /* type alias *************************************************************/
+
+    using byte_type = T;
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Constructor.
+    /// @param capacity  Initial capacity (rounded up to the page size).
+    /// @param allocator Hooks used to allocate the memory.
+    /// @throw std::bad_alloc if the memory cannot be allocated.
+    explicit PinnedBytes(size_t capacity = 0,
+                         HostAllocator allocator = page_locked_allocator)
+        : allocator_(allocator) {
+        reserve(capacity);
+    }
+
+    PinnedBytes(PinnedBytes const &) = delete;
+    PinnedBytes &operator=(PinnedBytes const &) = delete;
+
+    /// @brief Move constructor.
+    PinnedBytes(PinnedBytes &&other) noexcept
+        : allocator_(other.allocator_),
+          mem_(std::exchange(other.mem_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          size_(std::exchange(other.size_, 0)) {}
+
+    /// @brief Move assignment (the buffers are swapped).
+    PinnedBytes &operator=(PinnedBytes &&other) noexcept {
+        std::swap(allocator_, other.allocator_);
+        std::swap(mem_, other.mem_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    /// @brief Destructor.
+    ~PinnedBytes() { release(); }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns a pointer to the bytes buffer.
+    T *data() { return mem_; }
+
+    /// @brief Returns a const pointer to the bytes buffer.
+    T const *data() const { return mem_; }
+
+    /// @brief Returns the current capacity of the buffer.
+    size_t capacity() const { return capacity_; }
+
+    /// @brief Returns the number of bytes stored in the buffer.
+    size_t size() const { return size_; }
+
+    /// @brief Clear the buffer (set the size to 0 but do not reallocate).
+    void clear() { size_ = 0; }
+
+    /* append *****************************************************************/
+
+    /// @brief Appends some bytes at pos (the size is `pos + count` at the end).
+    /// @param pos     Position where the bytes are appended.
+    /// @param bytes   Buffer of bytes to append.
+    /// @param nbBytes Number of bytes to append.
+    void append(size_t pos, T const *bytes, size_t nbBytes) {
+        upsize(pos + nbBytes);
+        size_ = pos + nbBytes;
+        std::memcpy(mem_ + pos, bytes, nbBytes);
+    }
+
+    /* change size and capacity ***********************************************/
+
+    /// @brief Increase the capacity of the memory buffer if size bytes cannot
+    ///        be stored.
+    /// @param size New size.
+    void upsize(size_t size) {
+        if (size > capacity_) [[unlikely]] {
+            alloc(std::max(size, capacity_ * 2));
+        }
+    }
+
+    /// @brief Increase the capacity of the buffer if it is too small (use it
+    ///        with serializedSize to lock the memory only once).
+    /// @param capacity Minimal capacity of the buffer.
+    void reserve(size_t capacity) {
+        if (capacity > capacity_) {
+            alloc(capacity);
+        }
+    }
+
+    /// @brief Change the size of the buffer.
+    /// @param size New size.
+    void resize(size_t size) {
+        reserve(size);
+        size_ = size;
+    }
+
+    /// @brief Reallocate memory and change the capacity.
+    /// @param newCapacity New capacity (rounded up to the page size).
+    /// @throw std::bad_alloc if the memory cannot be allocated.
+    void alloc(size_t newCapacity) {
+        size_t page = pinned_impl::pageSize();
+        newCapacity = (newCapacity + page - 1) / page * page;
+        auto tmp = static_cast<T *>(allocator_.allocate(newCapacity));
+        if (tmp == nullptr) {
+            throw std::bad_alloc();
+        }
+        if (size_ > 0) {
+            std::memcpy(tmp, mem_, size_);
+        }
+        release();
+        mem_ = tmp;
+        capacity_ = newCapacity;
+    }
+
+    /* operators **************************************************************/
+
+    /// @brief Give read/write access to the byte `idx`.
+    T &operator[](size_t idx) { return mem_[idx]; }
+
+    /// @brief Give read access to the byte `idx`
+    T const &operator[](size_t idx) const { return mem_[idx]; }
+
+  private:
+    HostAllocator allocator_; ///< allocation hooks
+    T *mem_ = nullptr;        ///< bytes buffer
+    size_t capacity_ = 0;     ///< capacity of the buffer
+    size_t size_ = 0;         ///< number of bytes stored
+
+    /// @brief Free the buffer.
+    void release() {
+        if (mem_ != nullptr) {
+            allocator_.deallocate(mem_, capacity_);
+        }
+    }
+};
+
+/******************************************************************************/
+/*                               staging buffer                               */
+/******************************************************************************/
+
+/// @brief Allocator used during the deserialization that places the arrays of
+///        trivial elements (the DynamicArray payloads) one after the other in
+///        a buffer given by the user (for instance a pinned staging buffer or
+///        a mapped device buffer), so they can be transferred to the device
+///        with one asynchronous copy of [data(), data() + size()) without
+///        intermediate host copy. The other objects (pointers, shared
+///        pointers, arrays of pointers or of non trivial types) are allocated
+///        in an internal arena. Nothing is freed individually: the buffer is
+///        reused after reset.
+class StagingBuffer {
+  public:
+    /* constructor ************************************************************/
+
+    /// @brief Constructor.
+    /// @param mem       Staging memory (not owned).
+    /// @param capacity  Size of the staging memory in bytes.
+    /// @param alignment Alignment of the arrays in the staging memory.
+    StagingBuffer(void *mem, size_t capacity, size_t alignment = 256)
+        : mem_(static_cast<std::byte *>(mem)), capacity_(capacity),
+          alignment_(alignment) {}
+
+    StagingBuffer(StagingBuffer const &) = delete;
+    StagingBuffer &operator=(StagingBuffer const &) = delete;
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the staging memory.
+    std::byte *data() const { return mem_; }
+
+    /// @brief Returns the number of bytes used in the staging memory.
+    size_t size() const { return size_; }
+
+    /// @brief Returns the size of the staging memory.
+    size_t capacity() const { return capacity_; }
+
+    /// @brief Returns the offset of an array in the staging memory (the device
+    ///        address of the array is the device base address + offset).
+    size_t offset(void const *ptr) const {
+        return size_t(static_cast<std::byte const *>(ptr) - mem_);
+    }
+
+    /// @brief Returns the arena used for the objects that are not staged.
+    Arena &arena() { return arena_; }
+
+    /* allocation *************************************************************/
+
+    /// @brief Allocate raw memory in the staging buffer.
+    /// @param size  Number of bytes to allocate.
+    /// @param align Alignment of the memory.
+    /// @throw std::bad_alloc if the staging memory is full.
+    void *allocate(size_t size, size_t align) {
+        align = std::max(align, alignment_);
+        auto addr = reinterpret_cast<uintptr_t>(mem_) + size_;
+        size_t padding = (align - addr % align) % align;
+
+        if (size_ + padding + size > capacity_) {
+            throw std::bad_alloc();
+        }
+        void *ptr = mem_ + size_ + padding;
+        size_ += padding + size;
+        return ptr;
+    }
+
+    /// @brief Allocate a default constructed T (in the arena).
+    template <typename T> T *create() { return arena_.create<T>(); }
+
+    /// @brief Allocate an array of size T. The arrays of trivial types are
+    ///        staged and not initialized (the deserialization overwrites
+    ///        them), the others are allocated in the arena.
+    template <typename T> T *createArray(size_t size) {
+        if constexpr (std::is_trivial_v<T> && !std::is_pointer_v<T>) {
+            return static_cast<T *>(allocate(sizeof(T) * size, alignof(T)));
+        } else {
+            return arena_.createArray<T>(size);
+        }
+    }
+
+    /// @brief Create a shared pointer on a default constructed T (in the
+    ///        arena).
+    template <typename T> std::shared_ptr<T> makeShared() {
+        return arena_.makeShared<T>();
+    }
+
+    /// @brief The objects are not deleted individually.
+    template <typename T> void destroy(T *) {}
+
+    /// @brief Reuse the staging memory from the start and destroy the objects
+    ///        of the arena (the staged arrays must not be used anymore).
+    void reset() {
+        size_ = 0;
+        arena_.reset();
+    }
+
+  private:
+    std::byte *mem_;   ///< staging memory
+    size_t capacity_;  ///< size of the staging memory
+    size_t alignment_; ///< minimal alignment of the staged arrays
+    size_t size_ = 0;  ///< number of bytes used
+    Arena arena_;      ///< memory of the objects that are not staged
+};
+
+/******************************************************************************/
+/*                                with staging                                */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper that deserializes the dynamic arrays into a
+///        staging buffer (see StagingBuffer).
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class WithStaging : public MemoryWrapper<MemT> {
+  public:
+    /// @brief Constructor from the memory buffer and the staging buffer.
+    constexpr WithStaging(MemT &mem, StagingBuffer &staging)
+        : MemoryWrapper<MemT>(mem), staging_(staging) {}
+
+    /// @brief Returns the staging buffer (used as the arena of the memory).
+    constexpr StagingBuffer &arena() { return staging_; }
+
+  private:
+    StagingBuffer &staging_; ///< allocator of the deserialized objects
+};
+
+} // end namespace serializer::tools
+
+#endif
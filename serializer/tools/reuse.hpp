@@ -0,0 +1,32 @@
+#ifndef SERIALIZER_REUSE_H
+#define SERIALIZER_REUSE_H
+#include "memory_wrapper.hpp"
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                                   reuse                                    */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper that enables the reuse of the destination
+///        during the deserialization: the existing pointees are kept when
+///        their dynamic type is the deserialized one (checked against the id
+///        of the type table for the polymorphic types), so deserializing
+///        repeatedly into the same long-lived object does not allocate. The
+///        shared pointers are reused only when they are the sole owner of the
+///        pointee. The strings and the contiguous containers always keep their
+///        capacity (and their elements are deserialized in place). The objects
+///        tracked by tools::Tracked are never reused.
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class Reuse : public MemoryWrapper<MemT> {
+  public:
+    static constexpr bool reuse_objects = true;
+
+    /// @brief Constructor from the wrapped memory buffer.
+    constexpr explicit Reuse(MemT &mem) : MemoryWrapper<MemT>(mem) {}
+};
+
+} // end namespace serializer::tools
+
+#endif
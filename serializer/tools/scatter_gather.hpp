@@ -0,0 +1,171 @@
+#ifndef SERIALIZER_SCATTER_GATHER_H
+#define SERIALIZER_SCATTER_GATHER_H
+#include "bytes.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <sys/uio.h>
+#include <system_error>
+#include <vector>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                               scatter gather                               */
+/******************************************************************************/
+
+/// @brief Output memory that produces a list of iovec for writev / sendmsg.
+///        The small appends are copied into a staging buffer, while the large
+///        arrays and strings of the serialized objects (SER_DARR, containers
+///        of trivial types, ...) are referenced in place. The serialized
+///        objects must not be modified nor destroyed until the data is
+///        written (the temporaries cannot be serialized). The appends must be
+///        sequential and the memory cannot be read (the functions that patch
+///        the buffer, like BatchWriter, are not supported).
+/// @tparam T Byte type.
+template <typename T = std::byte>
+    requires(sizeof(T) == sizeof(char))
+class ScatterGather {
+  public:
+    /* type alias *************************************************************/
+
+    using byte_type = T;
+
+    /* constructor ************************************************************/
+
+    /// @brief Constructor.
+    /// @param threshold Minimal size of the referenced blocks (the smaller
+    ///                  blocks are copied).
+    explicit ScatterGather(size_t threshold = 4096)
+        : threshold_(std::max(threshold, size_t(1))) {}
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the number of serialized bytes.
+    size_t size() const { return size_; }
+
+    /// @brief Returns the number of bytes copied into the staging buffer.
+    size_t staged() const { return staging_.size(); }
+
+    /// @brief Returns the minimal size of the referenced blocks.
+    size_t threshold() const { return threshold_; }
+
+    /// @brief Clear the memory (the staging buffer is kept).
+    void clear() {
+        staging_.clear();
+        segments_.clear();
+        size_ = 0;
+    }
+
+    /* append *****************************************************************/
+
+    /// @brief Copy some bytes at pos (pos must be the current size).
+    /// @throw std::logic_error if the append is not sequential.
+    void append(size_t pos, T const *bytes, size_t nbBytes) {
+        checkPos(pos);
+        if (segments_.empty() || segments_.back().ptr != nullptr) {
+            segments_.push_back(Segment{nullptr, staging_.size(), 0});
+        }
+        staging_.append(staging_.size(), bytes, nbBytes);
+        segments_.back().size += nbBytes;
+        size_ += nbBytes;
+    }
+
+    /// @brief Append a block of the serialized object: it is referenced if it
+    ///        is larger than the threshold, copied otherwise.
+    /// @throw std::logic_error if the append is not sequential.
+    void appendExternal(size_t pos, T const *bytes, size_t nbBytes) {
+        if (nbBytes < threshold_) {
+            append(pos, bytes, nbBytes);
+            return;
+        }
+        checkPos(pos);
+        segments_.push_back(Segment{bytes, 0, nbBytes});
+        size_ += nbBytes;
+    }
+
+    /* output *****************************************************************/
+
+    /// @brief Returns the list of the buffers to write (valid until the next
+    ///        append).
+    std::vector<iovec> const &iovecs() {
+        iovecs_.resize(segments_.size());
+        for (size_t i = 0; i < segments_.size(); ++i) {
+            Segment const &segment = segments_[i];
+            T const *ptr = segment.ptr ? segment.ptr
+                                       : staging_.data() + segment.offset;
+            iovecs_[i].iov_base = const_cast<T *>(ptr);
+            iovecs_[i].iov_len = segment.size;
+        }
+        return iovecs_;
+    }
+
+    /// @brief Write all the bytes to a file descriptor (the partial writes
+    ///        are resumed).
+    /// @param fd Blocking file descriptor (file, pipe, socket, ...).
+    /// @throw std::system_error if the write fails.
+    void writeTo(int fd) {
+        std::vector<iovec> iov = iovecs();
+        size_t first = 0;
+
+        while (first < iov.size()) {
+            int nb = int(std::min(iov.size() - first, size_t(IOV_MAX)));
+            ssize_t count = ::writev(fd, iov.data() + first, nb);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: writev");
+            }
+            for (size_t written = size_t(count); first < iov.size();) {
+                if (written < iov[first].iov_len) {
+                    iov[first].iov_base =
+                        static_cast<char *>(iov[first].iov_base) + written;
+                    iov[first].iov_len -= written;
+                    break;
+                }
+                written -= iov[first++].iov_len;
+            }
+        }
+    }
+
+    /// @brief Gather the bytes into a std::vector.
+    std::vector<T> vector() {
+        std::vector<T> result(size_);
+        size_t pos = 0;
+        for (iovec const &iov : iovecs()) {
+            std::memcpy(result.data() + pos, iov.iov_base, iov.iov_len);
+            pos += iov.iov_len;
+        }
+        return result;
+    }
+
+  private:
+    /// @brief Range of the output (in the staging buffer if ptr is nullptr).
+    struct Segment {
+        T const *ptr;  ///< referenced bytes
+        size_t offset; ///< offset in the staging buffer
+        size_t size;   ///< number of bytes
+    };
+    Bytes<T> staging_;             ///< copied bytes
+    std::vector<Segment> segments_; ///< output ranges
+    std::vector<iovec> iovecs_;    ///< output buffers
+    size_t size_ = 0;              ///< number of serialized bytes
+    size_t threshold_;             ///< minimal size of the referenced blocks
+
+    void checkPos(size_t pos) const {
+        if (pos != size_) [[unlikely]] {
+            throw std::logic_error("error: the scatter gather memory only "
+                                   "supports sequential appends.");
+        }
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
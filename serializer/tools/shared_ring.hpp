@@ -0,0 +1,455 @@
+#ifndef SERIALIZER_SHARED_RING_H
+#define SERIALIZER_SHARED_RING_H
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+/******************************************************************************/
+/*                                shared ring                                 */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Ring buffer of messages in shared memory for the processes (or the
+///        threads) running on the same host (Linux only). The producers
+///        reserve a slot with a lock-free compare-and-swap and serialize
+///        directly into it (the slot is a memory buffer of fixed size), the
+///        consumer deserializes the messages in place (no copy, the views
+///        point into the ring). There is no system call once the ring is
+///        mapped: the producers and the consumer spin (and yield) when the
+///        ring is full or empty. Several producers can write concurrently,
+///        but there is only one consumer. The records are stored as a 16
+///        bytes header (record length and message size) followed by the
+///        message and never wrap (a padding record fills the end of the ring
+///        when a message doesn't fit). The messages are at most half of the
+///        ring, so a record and its padding always fit once the ring is
+///        empty. The messages are published in the order of the
+///        reservations.
+/// @tparam T Byte type (std::byte, uint8_t, char, ...).
+template <typename T = std::byte>
+    requires(sizeof(T) == sizeof(char))
+class SharedRing {
+    /// @brief Header of the records.
+    struct Header {
+        uint64_t length; ///< length of the record (header included)
+        uint64_t size;   ///< size of the message (padding_size for padding)
+    };
+
+    /// @brief Control block stored at the start of the mapping (the counters
+    ///        are positions that never wrap, on separate cache lines).
+    struct Control {
+        uint64_t capacity;                          ///< size of the ring
+        alignas(64) std::atomic<uint64_t> reserved; ///< end of the reservations
+        alignas(64) std::atomic<uint64_t> committed; ///< end of the messages
+        alignas(64) std::atomic<uint64_t> released; ///< end of the read data
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "The shared ring requires lock-free 64 bits atomics.");
+
+    static constexpr uint64_t padding_size = ~uint64_t(0);
+    static constexpr size_t record_alignment = sizeof(Header);
+
+  public:
+    using byte_type = T;
+
+    /* slot *******************************************************************/
+
+    /// @brief Reserved space of a message (memory buffer of fixed size for the
+    ///        serializer). The message is published by commit. A slot that is
+    ///        destroyed without being committed is skipped by the consumer.
+    class Slot {
+      public:
+        using byte_type = T;
+
+        Slot() = default;
+        Slot(Slot const &) = delete;
+        Slot &operator=(Slot const &) = delete;
+
+        /// @brief Move constructor.
+        Slot(Slot &&other) noexcept
+            : ring_(std::exchange(other.ring_, nullptr)), start_(other.start_),
+              record_(other.record_), end_(other.end_), size_(other.size_) {}
+
+        /// @brief Move assignment.
+        Slot &operator=(Slot &&other) noexcept {
+            std::swap(ring_, other.ring_);
+            std::swap(start_, other.start_);
+            std::swap(record_, other.record_);
+            std::swap(end_, other.end_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+
+        /// @brief Destructor (the slot is abandoned if it is not committed).
+        ~Slot() {
+            if (ring_) {
+                ring_->publish(*this, padding_size);
+            }
+        }
+
+        /// @brief True if the slot is reserved (see tryReserve).
+        explicit operator bool() const { return ring_ != nullptr; }
+
+        /// @brief Returns a pointer to the reserved bytes.
+        T *data() { return ring_->record(record_) + sizeof(Header); }
+
+        /// @brief Returns a const pointer to the reserved bytes.
+        T const *data() const {
+            return ring_->record(record_) + sizeof(Header);
+        }
+
+        /// @brief Returns the number of reserved bytes.
+        size_t size() const { return size_; }
+
+        /// @brief Give access to the byte `idx`.
+        T &operator[](size_t idx) { return data()[idx]; }
+
+        /// @brief Give read access to the byte `idx`.
+        T const &operator[](size_t idx) const { return data()[idx]; }
+
+        /// @brief Publish the message (waits until the slots reserved before
+        ///        this one are published or abandoned).
+        /// @param size Size of the message (position returned by serialize).
+        /// @throw std::out_of_range if size is larger than the slot.
+        void commit(size_t size) {
+            if (size > size_) {
+                throw std::out_of_range(
+                    "error: the message is larger than the slot.");
+            }
+            ring_->publish(*this, size);
+            ring_ = nullptr;
+        }
+
+      private:
+        friend class SharedRing<T>;
+        SharedRing<T> *ring_ = nullptr; ///< ring of the slot
+        uint64_t start_ = 0;  ///< start of the reservation (padding included)
+        uint64_t record_ = 0; ///< start of the record
+        uint64_t end_ = 0;    ///< end of the reservation
+        size_t size_ = 0;     ///< reserved bytes
+
+        Slot(SharedRing<T> *ring, uint64_t start, uint64_t record,
+             uint64_t end, size_t size)
+            : ring_(ring), start_(start), record_(record), end_(end),
+              size_(size) {}
+    };
+
+    /* message ****************************************************************/
+
+    /// @brief Message received from the ring (read-only memory buffer for the
+    ///        serializer, which refers to the ring). The space of the message
+    ///        is given back to the producers when it is released.
+    class Message {
+      public:
+        using byte_type = T;
+
+        Message() = default;
+        Message(Message const &) = delete;
+        Message &operator=(Message const &) = delete;
+
+        /// @brief Move constructor.
+        Message(Message &&other) noexcept
+            : ring_(std::exchange(other.ring_, nullptr)), data_(other.data_),
+              size_(other.size_), end_(other.end_) {}
+
+        /// @brief Move assignment.
+        Message &operator=(Message &&other) noexcept {
+            std::swap(ring_, other.ring_);
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(end_, other.end_);
+            return *this;
+        }
+
+        /// @brief Destructor (releases the message).
+        ~Message() { release(); }
+
+        /// @brief True if a message has been received (see tryReceive).
+        explicit operator bool() const { return ring_ != nullptr; }
+
+        /// @brief Returns a pointer to the message.
+        T const *data() const { return data_; }
+
+        /// @brief Returns the size of the message.
+        size_t size() const { return size_; }
+
+        /// @brief Give read access to the byte `idx`.
+        T const &operator[](size_t idx) const { return data_[idx]; }
+
+        /// @brief Give the space of the message back to the producers (the
+        ///        views on the message become invalid).
+        void release() {
+            if (ring_) {
+                ring_->control_->released.store(end_,
+                                                std::memory_order_release);
+                ring_->receiving_ = false;
+                ring_ = nullptr;
+            }
+        }
+
+      private:
+        friend class SharedRing<T>;
+        SharedRing<T> *ring_ = nullptr; ///< ring of the message
+        T const *data_ = nullptr;       ///< bytes of the message
+        size_t size_ = 0;               ///< size of the message
+        uint64_t end_ = 0;              ///< end of the record
+
+        Message(SharedRing<T> *ring, T const *data, size_t size, uint64_t end)
+            : ring_(ring), data_(data), size_(size), end_(end) {}
+    };
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Create an anonymous ring (shared with the child processes
+    ///        created with fork after the construction).
+    /// @param capacity Capacity of the ring (rounded up to a power of 2).
+    /// @throw std::system_error if the memory cannot be mapped.
+    explicit SharedRing(size_t capacity) {
+        capacity = ringCapacity(capacity);
+        map(-1, sizeof(Control) + capacity, MAP_SHARED | MAP_ANONYMOUS);
+        init(capacity);
+    }
+
+    SharedRing(SharedRing<T> const &) = delete;
+    SharedRing<T> &operator=(SharedRing<T> const &) = delete;
+
+    /// @brief Move constructor.
+    SharedRing(SharedRing<T> &&other) noexcept
+        : control_(std::exchange(other.control_, nullptr)),
+          mappingSize_(other.mappingSize_), readPos_(other.readPos_),
+          receiving_(other.receiving_) {}
+
+    /// @brief Destructor (unmap the ring, the named rings are not unlinked).
+    ~SharedRing() {
+        if (control_) {
+            ::munmap(control_, mappingSize_);
+        }
+    }
+
+    /// @brief Create a named ring (POSIX shared memory object).
+    /// @param name     Name of the shared memory object ("/name").
+    /// @param capacity Capacity of the ring (rounded up to a power of 2).
+    /// @throw std::system_error if the object exists or cannot be mapped.
+    static SharedRing<T> create(std::string const &name, size_t capacity) {
+        capacity = ringCapacity(capacity);
+        size_t size = sizeof(Control) + capacity;
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        check(fd >= 0, "shm_open");
+        SharedRing<T> ring;
+        try {
+            check(::ftruncate(fd, off_t(size)) == 0, "ftruncate");
+            ring.map(fd, size, MAP_SHARED);
+        } catch (...) {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw;
+        }
+        ::close(fd);
+        ring.init(capacity);
+        return ring;
+    }
+
+    /// @brief Open a named ring created by another process.
+    /// @param name Name of the shared memory object.
+    /// @throw std::system_error if the object cannot be opened or mapped.
+    static SharedRing<T> open(std::string const &name) {
+        int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+        check(fd >= 0, "shm_open");
+        SharedRing<T> ring;
+        try {
+            struct stat st;
+            check(::fstat(fd, &st) == 0, "fstat");
+            check(size_t(st.st_size) > sizeof(Control), "fstat");
+            ring.map(fd, size_t(st.st_size), MAP_SHARED);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+        ring.readPos_ =
+            ring.control_->released.load(std::memory_order_acquire);
+        return ring;
+    }
+
+    /// @brief Remove a named ring (the mappings stay valid).
+    static void unlink(std::string const &name) {
+        ::shm_unlink(name.c_str());
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the capacity of the ring.
+    size_t capacity() const { return size_t(control_->capacity); }
+
+    /// @brief Returns the size of the largest message that can be reserved
+    ///        (the padding before a record is shorter than the record, so a
+    ///        record of half of the ring always fits in an empty ring).
+    size_t maxMessageSize() const {
+        return capacity() / 2 - sizeof(Header);
+    }
+
+    /* producers **************************************************************/
+
+    /// @brief Reserve a slot of size bytes (the function doesn't block).
+    /// @param size Size of the slot.
+    /// @return The slot, or an empty slot if the ring is full.
+    /// @throw std::out_of_range if the message is larger than maxMessageSize.
+    Slot tryReserve(size_t size) {
+        uint64_t length = recordLength(size);
+        uint64_t mask = control_->capacity - 1;
+        uint64_t start = control_->reserved.load(std::memory_order_relaxed);
+        uint64_t record, end;
+        do {
+            uint64_t offset = start & mask;
+            uint64_t pad = offset + length > control_->capacity
+                               ? control_->capacity - offset
+                               : 0;
+            record = start + pad;
+            end = record + length;
+            if (end - control_->released.load(std::memory_order_acquire) >
+                control_->capacity) {
+                return Slot();
+            }
+        } while (!control_->reserved.compare_exchange_weak(
+            start, end, std::memory_order_acq_rel, std::memory_order_relaxed));
+        return Slot(this, start, record, end, size);
+    }
+
+    /// @brief Reserve a slot of size bytes (wait until there is enough space).
+    /// @param size Size of the slot.
+    /// @throw std::out_of_range if the message is larger than maxMessageSize.
+    Slot reserve(size_t size) {
+        for (;;) {
+            if (Slot slot = tryReserve(size)) {
+                return slot;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    /* consumer ***************************************************************/
+
+    /// @brief Receive the next message (the function doesn't block). The
+    ///        message must be released before the next one is received.
+    /// @return The message, or an empty message if the ring is empty.
+    /// @throw std::logic_error if the previous message is not released.
+    Message tryReceive() {
+        if (receiving_) {
+            throw std::logic_error(
+                "error: the previous message is not released.");
+        }
+        uint64_t committed =
+            control_->committed.load(std::memory_order_acquire);
+        while (readPos_ != committed) {
+            T const *ptr = record(readPos_);
+            Header header;
+            std::memcpy(&header, ptr, sizeof(Header));
+            readPos_ += header.length;
+            if (header.size != padding_size) {
+                receiving_ = true;
+                return Message(this, ptr + sizeof(Header), size_t(header.size),
+                               readPos_);
+            }
+            control_->released.store(readPos_, std::memory_order_release);
+        }
+        return Message();
+    }
+
+    /// @brief Receive the next message (wait until a message is committed).
+    /// @throw std::logic_error if the previous message is not released.
+    Message receive() {
+        for (;;) {
+            if (Message message = tryReceive()) {
+                return message;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+  private:
+    Control *control_ = nullptr; ///< control block (start of the mapping)
+    size_t mappingSize_ = 0;     ///< size of the mapping
+    uint64_t readPos_ = 0;       ///< next record of the consumer
+    bool receiving_ = false;     ///< a message is not released
+
+    SharedRing() = default;
+
+    /// @brief Throw a system error if cond is false.
+    static void check(bool cond, char const *what) {
+        if (!cond) {
+            throw std::system_error(errno, std::generic_category(),
+                                    std::string("error: ") + what);
+        }
+    }
+
+    /// @brief Capacity of the ring (power of 2, large enough for a record).
+    static size_t ringCapacity(size_t capacity) {
+        return std::bit_ceil(std::max(capacity, 4 * sizeof(Header)));
+    }
+
+    /// @brief Length of the record of a message of size bytes.
+    uint64_t recordLength(size_t size) const {
+        if (size > maxMessageSize()) {
+            throw std::out_of_range(
+                "error: the message is larger than half of the shared ring.");
+        }
+        return (sizeof(Header) + size + record_alignment - 1) /
+               record_alignment * record_alignment;
+    }
+
+    /// @brief Map the control block and the ring.
+    void map(int fd, size_t size, int flags) {
+        void *ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+        check(ptr != MAP_FAILED, "mmap");
+        control_ = static_cast<Control *>(ptr);
+        mappingSize_ = size;
+    }
+
+    /// @brief Initialize the control block of a new ring.
+    void init(size_t capacity) {
+        control_ = new (control_) Control{};
+        control_->capacity = capacity;
+    }
+
+    /// @brief Returns the address of the record at pos.
+    T *record(uint64_t pos) const {
+        return reinterpret_cast<T *>(control_ + 1) +
+               (pos & (control_->capacity - 1));
+    }
+
+    /// @brief Write the headers of a slot and publish it once the previous
+    ///        reservations are published.
+    void publish(Slot const &slot, uint64_t size) {
+        if (slot.record_ != slot.start_) {
+            Header padding{slot.record_ - slot.start_, padding_size};
+            std::memcpy(record(slot.start_), &padding, sizeof(Header));
+        }
+        Header header{slot.end_ - slot.record_, size};
+        std::memcpy(record(slot.record_), &header, sizeof(Header));
+        while (control_->committed.load(std::memory_order_acquire) !=
+               slot.start_) {
+            std::this_thread::yield();
+        }
+        control_->committed.store(slot.end_, std::memory_order_release);
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,320 @@
+#ifndef SERIALIZER_STREAM_H
+#define SERIALIZER_STREAM_H
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <ios>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+/******************************************************************************/
+/*                                 fd stream                                  */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Minimal stream interface over a file descriptor (the file descriptor
+///        is not owned by the stream).
+class FdStream {
+  public:
+    /// @brief Constructor from a file descriptor.
+    /// @param fd File descriptor (file, pipe, socket, ...).
+    explicit FdStream(int fd) : fd_(fd) {}
+
+    /// @brief Returns the file descriptor.
+    int fd() const { return fd_; }
+
+    /// @brief Write all the bytes to the file descriptor.
+    /// @param bytes   Buffer to write.
+    /// @param nbBytes Number of bytes to write.
+    /// @throw std::system_error if the write fails.
+    void write(char const *bytes, size_t nbBytes) {
+        while (nbBytes > 0) {
+            ssize_t count = ::write(fd_, bytes, nbBytes);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: write");
+            }
+            bytes += count;
+            nbBytes -= (size_t)count;
+        }
+    }
+
+    /// @brief Read at most nbBytes bytes from the file descriptor.
+    /// @param bytes   Destination buffer.
+    /// @param nbBytes Maximum number of bytes to read.
+    /// @return Number of bytes read (0 at the end of the file).
+    /// @throw std::system_error if the read fails.
+    size_t read(char *bytes, size_t nbBytes) {
+        ssize_t count;
+        do {
+            count = ::read(fd_, bytes, nbBytes);
+        } while (count < 0 && errno == EINTR);
+        if (count < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: read");
+        }
+        return (size_t)count;
+    }
+
+  private:
+    int fd_; ///< file descriptor
+};
+
+/******************************************************************************/
+/*                               stream writer                                */
+/******************************************************************************/
+
+/// @brief Memory buffer that writes the serialized data to a stream
+///        (std::ostream or FdStream) using a fixed size buffer. The buffer is
+///        flushed when it is full and the large appends (ex: containers of
+///        trivial types) are written directly to the stream. The appends must
+///        be sequential (the position is the position in the stream).
+/// @tparam Stream Output stream type (std::ostream or FdStream).
+/// @tparam T Byte type (std::byte, uint8_t, char, ...).
+template <typename Stream, typename T = std::byte>
+    requires(sizeof(T) == sizeof(char))
+class StreamWriter {
+  public:
+    /* type alias *************************************************************/
+
+    using byte_type = T;
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Constructor from the output stream.
+    /// @param stream   Stream in which the data is written.
+    /// @param capacity Capacity of the buffer.
+    explicit StreamWriter(Stream &stream, size_t capacity = 4096)
+        : stream_(stream), buffer_(std::max(capacity, size_t(1))) {}
+
+    StreamWriter(StreamWriter<Stream, T> const &) = delete;
+    StreamWriter<Stream, T> &operator=(StreamWriter<Stream, T> const &) =
+        delete;
+
+    /// @brief Destructor (the remaining bytes are flushed, the errors are
+    ///        ignored so flush() should be called explicitly to handle them).
+    ~StreamWriter() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the number of bytes written (flushed or not).
+    size_t size() const { return flushed_ + end_; }
+
+    /// @brief Returns the capacity of the buffer.
+    size_t capacity() const { return buffer_.size(); }
+
+    /* append *****************************************************************/
+
+    /// @brief Appends some bytes at pos (pos should be the current size).
+    /// @param pos     Position where the bytes are appended.
+    /// @param bytes   Buffer of bytes to append.
+    /// @param nbBytes Number of bytes to append.
+    /// @throw std::logic_error if the append is not sequential.
+    void append(size_t pos, T const *bytes, size_t nbBytes) {
+        if (pos != size()) [[unlikely]] {
+            throw std::logic_error(
+                "error: the stream writer only supports sequential appends.");
+        }
+        if (end_ + nbBytes > buffer_.size()) {
+            flush();
+        }
+        if (nbBytes >= buffer_.size()) {
+            write(bytes, nbBytes);
+            flushed_ += nbBytes;
+        } else {
+            std::memcpy(buffer_.data() + end_, bytes, nbBytes);
+            end_ += nbBytes;
+        }
+    }
+
+    /// @brief Write the content of the buffer to the stream.
+    void flush() {
+        if (end_ > 0) {
+            write(buffer_.data(), end_);
+            flushed_ += end_;
+            end_ = 0;
+        }
+        if constexpr (std::is_base_of_v<std::ostream, Stream>) {
+            stream_.flush();
+        }
+    }
+
+  private:
+    Stream &stream_;         ///< output stream
+    std::vector<T> buffer_;  ///< write buffer
+    size_t end_ = 0;         ///< number of bytes in the buffer
+    size_t flushed_ = 0;     ///< number of bytes written to the stream
+
+    /// @brief Write some bytes to the stream.
+    void write(T const *bytes, size_t nbBytes) {
+        auto ptr = reinterpret_cast<char const *>(bytes);
+        if constexpr (std::is_base_of_v<std::ostream, Stream>) {
+            stream_.write(ptr, (std::streamsize)nbBytes);
+            if (!stream_) [[unlikely]] {
+                throw std::ios_base::failure(
+                    "error: cannot write to the stream.");
+            }
+        } else {
+            stream_.write(ptr, nbBytes);
+        }
+    }
+};
+
+/******************************************************************************/
+/*                               stream reader                                */
+/******************************************************************************/
+
+/// @brief Memory buffer that reads the serialized data from a stream
+///        (std::istream or FdStream) using a fixed size buffer that is refilled
+///        when required. The large reads are done directly in the destination
+///        object. The reads must go forward (the position is the position in
+///        the stream).
+/// @tparam Stream Input stream type (std::istream or FdStream).
+/// @tparam T Byte type (std::byte, uint8_t, char, ...).
+template <typename Stream, typename T = std::byte>
+    requires(sizeof(T) == sizeof(char))
+class StreamReader {
+  public:
+    /* type alias *************************************************************/
+
+    using byte_type = T;
+
+    /* constructors ***********************************************************/
+
+    /// @brief Constructor from the input stream.
+    /// @param stream   Stream from which the data is read.
+    /// @param capacity Capacity of the buffer.
+    explicit StreamReader(Stream &stream, size_t capacity = 4096)
+        : stream_(stream), buffer_(std::max(capacity, size_t(1))) {}
+
+    StreamReader(StreamReader<Stream, T> const &) = delete;
+    StreamReader<Stream, T> &operator=(StreamReader<Stream, T> const &) =
+        delete;
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the capacity of the buffer.
+    size_t capacity() const { return buffer_.size(); }
+
+    /* read *******************************************************************/
+
+    /// @brief Give access to the nbBytes bytes at pos. The buffer is refilled
+    ///        (and grown if nbBytes is larger than its capacity) if required.
+    /// @param pos     Position in the stream.
+    /// @param nbBytes Number of bytes to access.
+    /// @return Pointer to the bytes (valid until the next read).
+    /// @throw std::out_of_range at the end of the stream.
+    T const *fetch(size_t pos, size_t nbBytes) {
+        if (pos < begin_) [[unlikely]] {
+            throw std::logic_error(
+                "error: the stream reader only supports forward reads.");
+        }
+        if (pos + nbBytes > begin_ + end_) {
+            refill(pos, nbBytes);
+        }
+        return buffer_.data() + (pos - begin_);
+    }
+
+    /// @brief Copy the nbBytes bytes at pos into dest. The bytes that are not
+    ///        in the buffer are read directly into dest when there are more
+    ///        than the capacity of the buffer.
+    /// @param pos     Position in the stream.
+    /// @param dest    Destination buffer.
+    /// @param nbBytes Number of bytes to copy.
+    /// @throw std::out_of_range at the end of the stream.
+    void read(size_t pos, T *dest, size_t nbBytes) {
+        T const *bytes = fetch(pos, 0);
+        size_t available = std::min(begin_ + end_ - pos, nbBytes);
+        size_t remaining = nbBytes - available;
+
+        std::memcpy(dest, bytes, available);
+        if (remaining >= buffer_.size()) {
+            readAll(dest + available, remaining);
+            begin_ = pos + nbBytes;
+            end_ = 0;
+        } else if (remaining > 0) {
+            std::memcpy(dest + available, fetch(pos + available, remaining),
+                        remaining);
+        }
+    }
+
+  private:
+    Stream &stream_;        ///< input stream
+    std::vector<T> buffer_; ///< read buffer
+    size_t begin_ = 0;      ///< position of the buffer in the stream
+    size_t end_ = 0;        ///< number of bytes in the buffer
+
+    /// @brief Discard the bytes before pos and fill the buffer so it contains
+    ///        at least nbBytes bytes from pos.
+    void refill(size_t pos, size_t nbBytes) {
+        // skip the bytes that are before pos
+        while (begin_ + end_ < pos) {
+            begin_ += end_;
+            end_ = 0;
+            fill(std::min(pos - begin_, buffer_.size()));
+        }
+        size_t offset = pos - begin_;
+        std::memmove(buffer_.data(), buffer_.data() + offset, end_ - offset);
+        begin_ = pos;
+        end_ -= offset;
+        if (nbBytes > buffer_.size()) {
+            buffer_.resize(nbBytes);
+        }
+        fill(nbBytes);
+    }
+
+    /// @brief Read from the stream until the buffer contains nbBytes bytes.
+    void fill(size_t nbBytes) {
+        while (end_ < nbBytes) {
+            size_t count = readSome(buffer_.data() + end_,
+                                    buffer_.size() - end_);
+            if (count == 0) [[unlikely]] {
+                throw std::out_of_range("error: unexpected end of the stream.");
+            }
+            end_ += count;
+        }
+    }
+
+    /// @brief Read exactly nbBytes bytes from the stream into dest.
+    void readAll(T *dest, size_t nbBytes) {
+        while (nbBytes > 0) {
+            size_t count = readSome(dest, nbBytes);
+            if (count == 0) [[unlikely]] {
+                throw std::out_of_range("error: unexpected end of the stream.");
+            }
+            dest += count;
+            nbBytes -= count;
+        }
+    }
+
+    /// @brief Read at most nbBytes bytes from the stream.
+    size_t readSome(T *dest, size_t nbBytes) {
+        auto ptr = reinterpret_cast<char *>(dest);
+        if constexpr (std::is_base_of_v<std::istream, Stream>) {
+            stream_.read(ptr, (std::streamsize)nbBytes);
+            return (size_t)stream_.gcount();
+        } else {
+            return stream_.read(ptr, nbBytes);
+        }
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -2,6 +2,10 @@
 #define SERIALIZER_TOOLS_HPP
 #include "../meta/concepts.hpp"
 #include "../meta/type_check.hpp"
+#include "context.hpp"
+#include <functional>
+#include <tuple>
+#include <utility>
 
 namespace serializer::tools {
 
@@ -10,6 +14,9 @@ namespace serializer::tools {
 /******************************************************************************/
 
 /// @brief Insert an element into an iterable using the insert member function.
+///        The ordered containers use the end as a hint since the elements are
+///        serialized in order (amortized constant insertion). The element is
+///        moved if it is an rvalue.
 /// @tparam Container Container type.
 /// @tparam T Type of the lement to insert.
 /// @param container
@@ -17,7 +24,14 @@ namespace serializer::tools {
 template <typename Container, typename T>
     requires serializer::concepts::Insertable<Container, T>
 inline constexpr void insert(Container &&container, T &&element) {
-    container.insert(element);
+    if constexpr (requires {
+                      container.emplace_hint(container.end(),
+                                             std::forward<T>(element));
+                  }) {
+        container.emplace_hint(container.end(), std::forward<T>(element));
+    } else {
+        container.insert(std::forward<T>(element));
+    }
 }
 
 /// @brief Insert an element into an iterable using the add member
@@ -29,7 +43,7 @@ inline constexpr void insert(Container &&container, T &&element) {
 template <typename Container, typename T>
     requires serializer::concepts::PushBackable<Container, T>
 inline constexpr void insert(Container &&container, T &&element) {
-    container.push_back(element);
+    container.push_back(std::forward<T>(element));
 }
 
 /// @brief Insert an element into an iterable using the operator[].
@@ -40,7 +54,7 @@ inline constexpr void insert(Container &&container, T &&element) {
 /// @param idx Index where the element should be inserted in the container.
 template <typename Container, typename T>
 inline constexpr void insert(Container &&container, T &&element, size_t idx) {
-    container[idx] = element;
+    container[idx] = std::forward<T>(element);
 }
 
 /******************************************************************************/
@@ -94,6 +108,120 @@ T tupleProd(std::tuple<Types...> const &tuple) {
     return tupleProd_<T>(tuple, std::make_index_sequence<sizeof...(Types)>());
 }
 
+/// @brief Create the tuple of the members given to SERIALIZE. The lvalues are
+///        stored by reference and the temporaries (ids, super, SER_FUN, ...)
+///        by value.
+/// @param args Members of the object.
+/// @return Tuple of the members.
+template <typename... Args> inline constexpr auto members(Args &&...args) {
+    return std::tuple<Args...>(std::forward<Args>(args)...);
+}
+
+/******************************************************************************/
+/*                      serialize / deserialize arguments                     */
+/******************************************************************************/
+
+/// @brief Arguments that the serializer copies byte by byte (consecutive
+///        packable arguments are serialized with only one append).
+template <typename Ser, typename T>
+concept Packable = requires { requires Ser::template is_packable_v<T>; };
+
+/// @brief Count the number of consecutive packable arguments from Idx.
+/// @tparam Ser Serializer
+/// @tparam Idx Index of the first argument.
+/// @tparam Args Tuple of the arguments types.
+template <typename Ser, size_t Idx, typename Args>
+constexpr size_t nbPackable() {
+    if constexpr (Idx < std::tuple_size_v<Args>) {
+        if constexpr (Packable<Ser, std::tuple_element_t<Idx, Args>>) {
+            return 1 + nbPackable<Ser, Idx + 1, Args>();
+        }
+    }
+    return 0;
+}
+
+/// @brief Serialize the arguments from Idx. The runs of packable arguments
+///        are appended at once so they cost only one capacity check.
+/// @tparam Idx Index of the first argument to serialize.
+/// @tparam Ser Serializer
+/// @param serializer Serializer that holds the memory buffer.
+/// @param args Tuple of references to the arguments.
+template <size_t Idx, typename Ser, typename Args>
+inline constexpr void serializeArgs(Ser &serializer, Args const &args) {
+    if constexpr (Idx < std::tuple_size_v<Args>) {
+        constexpr size_t nb = nbPackable<Ser, Idx, Args>();
+
+        if constexpr (nb > 1) {
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+                serializer.appendPacked(std::get<Idx + Is>(args)...);
+            }(std::make_index_sequence<nb>());
+            serializeArgs<Idx + nb>(serializer, args);
+        } else {
+            auto &arg = std::get<Idx>(args);
+            auto serializeArg = [&] {
+                if constexpr (SerializerFunction(arg, serializer)) {
+                    arg(Context<Phases::Serialization, Ser>(serializer));
+                } else {
+                    serializer.serialize_(arg);
+                }
+            };
+            if constexpr (concepts::Instrumented<typename Ser::mem_type>) {
+                serializer.mem.instrumentation()
+                    .template record<Phases::Serialization, decltype(arg)>(
+                        serializer.pos, serializeArg);
+            } else {
+                serializeArg();
+            }
+            if constexpr (concepts::TracksMembers<typename Ser::mem_type>) {
+                serializer.mem.member(serializer.pos);
+            }
+            serializeArgs<Idx + 1>(serializer, args);
+        }
+    }
+}
+
+/// @brief Deserialize the arguments from Idx. The runs of packable arguments
+///        are read at once.
+/// @tparam Idx Index of the first argument to deserialize.
+/// @tparam Ser Serializer
+/// @param serializer Serializer that holds the memory buffer.
+/// @param args Tuple of references to the arguments.
+template <size_t Idx, typename Ser, typename Args>
+inline constexpr void deserializeArgs(Ser &serializer, Args const &args) {
+    if constexpr (Idx < std::tuple_size_v<Args>) {
+        constexpr size_t nb = nbPackable<Ser, Idx, Args>();
+
+        if constexpr (nb > 1) {
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+                serializer.deserializePacked(std::get<Idx + Is>(args)...);
+            }(std::make_index_sequence<nb>());
+            deserializeArgs<Idx + nb>(serializer, args);
+        } else {
+            auto &arg = std::get<Idx>(args);
+            if constexpr (concepts::TracksMembers<typename Ser::mem_type>) {
+                if (!serializer.mem.select()) {
+                    return deserializeArgs<Idx + 1>(serializer, args);
+                }
+            }
+            auto deserializeArg = [&] {
+                if constexpr (SerializerFunction(arg, serializer)) {
+                    arg(Context<Phases::Deserialization, Ser>(serializer));
+                } else {
+                    serializer.deserialize_(arg);
+                }
+            };
+            if constexpr (concepts::Instrumented<typename Ser::mem_type>) {
+                serializer.mem.instrumentation()
+                    .template record<Phases::Deserialization, decltype(arg)>(
+                        serializer.pos, deserializeArg);
+            } else {
+                deserializeArg();
+            }
+            deserializeArgs<Idx + 1>(serializer, args);
+        }
+    }
+}
+
 /******************************************************************************/
 /*                         deserialize with accessors                         */
 /******************************************************************************/
@@ -0,0 +1,147 @@
+#ifndef SERIALIZER_TRACKED_H
+#define SERIALIZER_TRACKED_H
+#include "../exceptions/corrupted_data.hpp"
+#include "memory_wrapper.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                               object tracker                               */
+/******************************************************************************/
+
+/// @brief Address used to identify the type T in the object tracker (the
+///        pointers to an object and to its first member must not be confused).
+template <typename T> inline constexpr char tracked_type_key = 0;
+
+/// @brief Table of the objects that have been serialized or deserialized
+///        through a pointer. During the serialization, the indices of the
+///        objects are stored in a flat open addressing hash map (linear
+///        probing) indexed by the address and the type of the objects. During
+///        the deserialization, the indices give access to the created objects.
+class ObjectTracker {
+  public:
+    /* serialization **********************************************************/
+
+    /// @brief Find the index of an object or add it to the table.
+    /// @param ptr  Address of the object.
+    /// @param type Key of the type of the object (tracked_type_key).
+    /// @return Index of the object and true if the object has been added.
+    std::pair<size_t, bool> insert(void const *ptr, void const *type) {
+        if (2 * (indices_ + 1) > slots_.size()) {
+            grow();
+        }
+        size_t mask = slots_.size() - 1;
+        for (size_t i = hash(ptr, type) & mask;; i = (i + 1) & mask) {
+            Slot &slot = slots_[i];
+            if (slot.ptr == nullptr) {
+                slot = Slot{ptr, type, indices_};
+                return {indices_++, true};
+            }
+            if (slot.ptr == ptr && slot.type == type) {
+                return {slot.index, false};
+            }
+        }
+    }
+
+    /* deserialization ********************************************************/
+
+    /// @brief Add a deserialized object (its index is the number of objects).
+    /// @param obj Object (the raw pointers don't own the object).
+    void add(std::shared_ptr<void> obj) { objects_.push_back(std::move(obj)); }
+
+    /// @brief Returns the object at the given index.
+    /// @throw exceptions::CorruptedDataError if the index is invalid.
+    std::shared_ptr<void> const &get(size_t index) const {
+        if (index >= objects_.size()) [[unlikely]] {
+            throw exceptions::CorruptedDataError(
+                "invalid object reference " + std::to_string(index) + " (" +
+                std::to_string(objects_.size()) + " objects).");
+        }
+        return objects_[index];
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the number of tracked objects.
+    size_t size() const { return indices_ + objects_.size(); }
+
+    /// @brief Forget the tracked objects (the memory is kept).
+    void clear() {
+        if (indices_ > 0) {
+            std::fill(slots_.begin(), slots_.end(), Slot{});
+        }
+        indices_ = 0;
+        objects_.clear();
+    }
+
+  private:
+    /// @brief Slot of the hash map (empty if ptr is nullptr).
+    struct Slot {
+        void const *ptr = nullptr;  ///< address of the object
+        void const *type = nullptr; ///< type key of the object
+        size_t index = 0;           ///< index of the object
+    };
+    std::vector<Slot> slots_;                  ///< hash map (size: power of 2)
+    size_t indices_ = 0;                       ///< number of serialized objects
+    std::vector<std::shared_ptr<void>> objects_; ///< deserialized objects
+
+    /// @brief Hash of an object key.
+    static size_t hash(void const *ptr, void const *type) {
+        uint64_t h = uint64_t(uintptr_t(ptr)) ^ (uint64_t(uintptr_t(type)) << 1);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return size_t(h);
+    }
+
+    /// @brief Double the capacity of the hash map.
+    void grow() {
+        std::vector<Slot> slots(slots_.empty() ? 64 : 2 * slots_.size());
+        size_t mask = slots.size() - 1;
+        for (Slot const &slot : slots_) {
+            if (slot.ptr != nullptr) {
+                size_t i = hash(slot.ptr, slot.type) & mask;
+                while (slots[i].ptr != nullptr) {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = slot;
+            }
+        }
+        slots_ = std::move(slots);
+    }
+};
+
+/******************************************************************************/
+/*                                  tracked                                   */
+/******************************************************************************/
+
+/// @brief Memory buffer wrapper that serializes each object pointed by several
+///        shared or raw pointers only once: the next pointers are serialized
+///        as a reference to the first one. On deserialization, the pointers
+///        share the same object again (the shared pointers share the
+///        ownership). The unique pointers and the polymorphic types registered
+///        in the type table are not tracked.
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class Tracked : public MemoryWrapper<MemT> {
+  public:
+    /// @brief Constructor from the wrapped memory buffer.
+    constexpr explicit Tracked(MemT &mem) : MemoryWrapper<MemT>(mem) {}
+
+    /// @brief Returns the table of the tracked objects.
+    ObjectTracker &objects() { return objects_; }
+
+  private:
+    ObjectTracker objects_; ///< tracked objects
+};
+
+} // end namespace serializer::tools
+
+#endif
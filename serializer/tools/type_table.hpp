@@ -5,8 +5,12 @@
 #include "../meta/type_transform.hpp"
 #include "../exceptions/id_not_found.hpp"
 #include "../exceptions/abstract_type.hpp"
+#include "arena.hpp"
+#include <array>
+#include <cstdint>
 #include <stdexcept>
 #include <type_traits>
+#include <typeinfo>
 
 /******************************************************************************/
 /*                                 type table                                 */
@@ -18,8 +22,12 @@ namespace serializer::tools {
 /// @brief Table that is used to get the identifiers of the serialized types.
 /// @tparam Tyes Registers types.
 template <typename... Types> struct TypeTable {
-    using id_type = unsigned int; // TODO
     static constexpr size_t size = sizeof...(Types);
+
+    /// @brief Smallest unsigned integer type that can store all the ids.
+    using id_type = std::conditional_t<
+        (size <= 256), uint8_t,
+        std::conditional_t<(size <= 65536), uint16_t, uint32_t>>;
 };
 
 /* contains *******************************************************************/
@@ -67,8 +75,12 @@ constexpr inline TypeTable<T, Ts...>::id_type getId(TypeTable<T, Ts...>) {
 /// @param pos Start position in the buffer where the id is serialized.
 template <typename TypeTable>
 inline constexpr typename TypeTable::id_type getId(auto &mem, size_t pos = 0) {
-    return *std::bit_cast<const typename TypeTable::id_type *>(mem.data() +
-                                                               pos);
+    using id_type = typename TypeTable::id_type;
+    if constexpr (concepts::Fetchable<decltype(mem)>) {
+        return *std::bit_cast<const id_type *>(mem.fetch(pos, sizeof(id_type)));
+    } else {
+        return *std::bit_cast<const id_type *>(mem.data() + pos);
+    }
 }
 
 /* create *********************************************************************/
@@ -78,17 +90,20 @@ inline constexpr typename TypeTable::id_type getId(auto &mem, size_t pos = 0) {
 ///        Note: if the element is not a pointer the function does nothing.
 /// @tparam T Type of the pointer
 /// @param elt Element that will contain the result
+/// @param allocator Allocator used for the pointers and the shared pointers
+///                  (NewAllocator or Arena).
 /// @throw Error when T is an abstract class.
-template <typename T> inline constexpr void create(auto &elt) {
+template <typename T>
+inline constexpr void create(auto &elt, auto &&allocator) {
     using Type = decltype(elt);
     if constexpr (!std::is_abstract_v<T>) {
         if constexpr (concepts::Pointer<Type>) {
             if (elt != nullptr) {
-                delete elt;
+                allocator.destroy(elt);
             }
-            elt = new T();
+            elt = allocator.template create<T>();
         } else if constexpr (mtf::is_shared_v<Type>) {
-            elt = std::make_shared<T>();
+            elt = allocator.template makeShared<T>();
         } else if constexpr (mtf::is_unique_v<Type>) {
             elt = std::make_unique<T>();
         }
@@ -97,65 +112,132 @@ template <typename T> inline constexpr void create(auto &elt) {
     }
 }
 
-/// @brief Create a polymorphic type. The real type is found using the given id.
+/// @brief True if elt is a valid pointer to an object whose dynamic type is T
+///        (the pointee can be reused to deserialize a T).
+template <typename T> inline constexpr bool pointsTo(auto const &elt) {
+    if (elt == nullptr) {
+        return false;
+    }
+    if constexpr (std::is_polymorphic_v<T>) {
+        return typeid(*elt) == typeid(T);
+    } else {
+        return true;
+    }
+}
+
+/// @brief Create a pointer of type T using new (see create above).
+template <typename T> inline constexpr void create(auto &elt) {
+    create<T>(elt, NewAllocator());
+}
+
+/// @brief Create a polymorphic type. The real type is found using the given id
+///        in a table of create functions indexed by the ids (constant time
+///        whatever the size of the type table).
 /// @tparam SuperType Type of the element.
-/// @tparam T Firt type in the table.
-/// @tparam Ts Rest of the types in the table.
-/// @param id Identifier of the target type.
+/// @tparam Types Types in the table.
+/// @param id Identifier of the target type (it must be in the table).
 /// @parma _ Type table.
 /// @parma elt Deserialize element, it will contains the result object.
-template <typename SuperType, typename IdType, typename T, typename... Ts>
-constexpr inline void createPolymorphic(IdType id, TypeTable<T, Ts...>,
-                                        SuperType &elt) {
-    if (id == 0) {
-        create<T>(elt);
-    } else {
-        if constexpr (sizeof...(Ts)) {
-            createPolymorphic(IdType(id - 1), TypeTable<Ts...>(), elt);
-        }
-    }
+/// @param allocator Allocator used to create the object.
+template <typename SuperType, typename IdType, typename... Types>
+constexpr inline void createPolymorphic(IdType id, TypeTable<Types...>,
+                                        SuperType &elt, auto &&allocator) {
+    using Alloc = std::remove_reference_t<decltype(allocator)>;
+    using Create = void (*)(SuperType &, Alloc &);
+    constexpr std::array<Create, sizeof...(Types)> creates = {
+        [](SuperType &elt, Alloc &allocator) {
+            create<Types>(elt, allocator);
+        }...};
+    creates[id](elt, allocator);
 }
 
 /// @brief Creates a element using the identifier.
 /// @tparam TypeTable The type table.
 /// @param id Identifier of the type to create.
 /// @param elt Element that will contain the created type.
+/// @param allocator Allocator used to create the object.
 /// @throw Error when the id is not in the given type table.
 template <typename TypeTable>
-constexpr inline void createId(auto id, auto &elt) {
+constexpr inline void createId(auto id, auto &elt, auto &&allocator) {
     if (!hasId(id, TypeTable())) [[unlikely]] {
         throw exceptions::IdNotFoundError(id);
     }
     if (id == getId<decltype(elt)>(TypeTable())) {
-        create<mtf::base_t<decltype(elt)>>(elt);
+        create<mtf::base_t<decltype(elt)>>(elt, allocator);
     } else {
-        createPolymorphic(id, TypeTable(), elt);
+        createPolymorphic(id, TypeTable(), elt, allocator);
     }
 }
 
+/// @brief True if elt is a valid pointer to an object of the type that has
+///        the given identifier in the type table.
+/// @param id Identifier of the type.
+/// @param elt Pointer or smart pointer.
+template <typename... Types>
+constexpr inline bool pointsToId(size_t id, TypeTable<Types...>,
+                                 auto const &elt) {
+    using T = mtf::clean_t<decltype(elt)>;
+    if constexpr (concepts::Pointer<T> || concepts::SmartPtr<T>) {
+        size_t idx = 0;
+        bool result = false;
+        ((result = result || (idx++ == id && pointsTo<Types>(elt))), ...);
+        return result;
+    } else {
+        return false;
+    }
+}
+
+/// @brief Returns the id of the dynamic type of the object pointed by elt (the
+///        static type is used for the values), size_t(-1) if the pointer is
+///        null or if its dynamic type is not in the type table.
+/// @param elt Pointer, smart pointer or value.
+template <typename... Types>
+inline size_t dynamicId(auto const &elt, TypeTable<Types...> table) {
+    using T = mtf::clean_t<decltype(elt)>;
+    if constexpr (concepts::Pointer<T> || concepts::SmartPtr<T>) {
+        size_t id = size_t(-1);
+        if (elt != nullptr) {
+            ((id = id == size_t(-1) && typeid(*elt) == typeid(Types)
+                       ? size_t(getId<Types>(table))
+                       : id),
+             ...);
+        }
+        return id;
+    } else {
+        return getId<T>(table);
+    }
+}
+
+/// @brief Creates a element using the identifier (allocated with new).
+template <typename TypeTable>
+constexpr inline void createId(auto id, auto &elt) {
+    createId<TypeTable>(id, elt, NewAllocator());
+}
+
 /* apply id *******************************************************************/
 
 /// @brief Apply a template lambda to the type with the identifier `id` in the
-///        given type table.
-/// @tparam T First type in the type table.
-/// @tparam Ts Rest of the types in the type table.
+///        given type table. The lambda is called through a table of functions
+///        indexed by the ids (constant time whatever the size of the type
+///        table).
+/// @tparam Types Types in the type table.
 /// @param id       Identifier of the target type.
 /// @param _        Type table.
 /// @param function Template lambda / functor to apply on the type. the
 ///                 operator() should be template parametrized with a type T
 ///                 that will correspond to the type of identifier id.
-template <typename T, typename... Ts>
-constexpr void applyId(auto id, TypeTable<T, Ts...>, auto function) {
-    if (id == 0) {
-        function.template operator()<T>();
-    } else {
-        if constexpr (sizeof...(Ts)) {
-            applyId(typename TypeTable<T, Ts...>::id_type(id - 1),
-                    TypeTable<Ts...>(), function);
-        } else {
-            throw std::logic_error("error: id not found");
-        }
+/// @throw std::logic_error when the id is not in the type table.
+template <typename... Types>
+constexpr void applyId(auto id, TypeTable<Types...>, auto function) {
+    using Function = decltype(function);
+    using Apply = void (*)(Function &);
+    constexpr std::array<Apply, sizeof...(Types)> applies = {
+        [](Function &function) { function.template operator()<Types>(); }...};
+
+    if (!hasId(id, TypeTable<Types...>())) [[unlikely]] {
+        throw std::logic_error("error: id not found");
     }
+    applies[id](function);
 }
 
 } // end namespace serializer::tools
@@ -0,0 +1,68 @@
+#ifndef SERIALIZER_UNCHECKED_H
+#define SERIALIZER_UNCHECKED_H
+#include "../meta/type_check.hpp"
+#include "memory_wrapper.hpp"
+#include <cstddef>
+#include <cstring>
+
+/******************************************************************************/
+/*                                 unchecked                                  */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Wrapper around a memory buffer which capacity is guaranteed (ex:
+///        computed with serializedSize). The appends are done without any
+///        bounds check nor reallocation, so the serialization of trivial
+///        members is reduced to simple stores.
+///        Note: the size of the wrapped memory is not updated, it should be
+///        set before the serialization. The format of the wrapped memory is
+///        kept (see Policies).
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class Unchecked : public Policies<MemT> {
+  public:
+    /* type alias *************************************************************/
+
+    using byte_type = mtf::byte_type_t<MemT>;
+
+    /* constructor ************************************************************/
+
+    /// @brief Constructor from the memory buffer in which the data is written.
+    /// @param mem Memory buffer (its size should be large enough).
+    constexpr explicit Unchecked(MemT &mem) : mem_(mem) {}
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns a pointer to the wrapped buffer.
+    constexpr auto data() { return mem_.data(); }
+
+    /// @brief Returns a const pointer to the wrapped buffer.
+    constexpr auto data() const { return mem_.data(); }
+
+    /// @brief Returns the size of the wrapped buffer.
+    constexpr size_t size() const { return mem_.size(); }
+
+    /// @brief Give access to the byte `idx` of the wrapped buffer.
+    constexpr decltype(auto) operator[](size_t idx) { return mem_[idx]; }
+
+    /// @brief Give read access to the byte `idx` of the wrapped buffer.
+    constexpr decltype(auto) operator[](size_t idx) const { return mem_[idx]; }
+
+    /* append *****************************************************************/
+
+    /// @brief Copy the bytes at pos without checking the capacity.
+    /// @param pos     Position where the bytes are appended.
+    /// @param bytes   Buffer of bytes to append.
+    /// @param nbBytes Number of bytes to append.
+    constexpr void append(size_t pos, byte_type const *bytes, size_t nbBytes) {
+        std::memcpy(mem_.data() + pos, bytes, nbBytes);
+    }
+
+  private:
+    MemT &mem_; ///< wrapped memory buffer
+};
+
+} // end namespace serializer::tools
+
+#endif
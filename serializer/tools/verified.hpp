@@ -0,0 +1,56 @@
+#ifndef SERIALIZER_VERIFIED_H
+#define SERIALIZER_VERIFIED_H
+#include "../meta/concepts.hpp"
+#include "memory_wrapper.hpp"
+#include <cstddef>
+
+/******************************************************************************/
+/*                                  verified                                  */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Memory buffer wrapper used to deserialize untrusted data. Every read
+///        is checked against the end of the data and the sizes of the
+///        containers are checked against the remaining bytes (each element
+///        takes at least one byte), so a truncated or corrupted message throws
+///        a CorruptedDataError instead of crashing the receiver. The checks
+///        are only compiled in this mode and the format of the wrapped memory
+///        is kept (ex: Verified<Compact<Bytes>> reads the compact encoding).
+/// @tparam MemT Type of the wrapped memory buffer.
+template <typename MemT> class Verified : public MemoryWrapper<MemT> {
+  public:
+    static constexpr bool bounds_checked = true;
+    static_assert(!concepts::Fetchable<MemT>,
+                  "The streams already check the end of the data.");
+
+    /* constructors ***********************************************************/
+
+    /// @brief Constructor from the wrapped memory buffer (the data ends at the
+    ///        end of the buffer).
+    /// @param mem Memory buffer that contains the data.
+    constexpr explicit Verified(MemT &mem) : MemoryWrapper<MemT>(mem) {}
+
+    /// @brief Constructor from the wrapped memory buffer and the end of the
+    ///        data.
+    /// @param mem  Memory buffer that contains the data.
+    /// @param size End of the data (must not exceed the size of mem).
+    constexpr Verified(MemT &mem, size_t size)
+        : MemoryWrapper<MemT>(mem), size_(size) {}
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the end of the data.
+    constexpr size_t size() const {
+        return size_ == npos ? MemoryWrapper<MemT>::size() : size_;
+    }
+
+  private:
+    static constexpr size_t npos = size_t(-1);
+    size_t size_ = npos; ///< end of the data (npos: end of the buffer)
+};
+
+} // end namespace serializer::tools
+
+#endif
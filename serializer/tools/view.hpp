@@ -0,0 +1,209 @@
+#ifndef SERIALIZER_VIEW_H
+#define SERIALIZER_VIEW_H
+#include "../meta/concepts.hpp"
+#include "../meta/serializer_meta.hpp"
+#include "../meta/static_size.hpp"
+#include "../serializer/serializer.hpp"
+#include "bytes.hpp"
+#include "type_table.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/******************************************************************************/
+/*                                    view                                    */
+/******************************************************************************/
+
+/// @brief Read only access to the members of a serialized object without
+///        deserializing the whole object. The object must use SERIALIZE (the
+///        members are given by their index in the SERIALIZE list). The offsets
+///        of the members that follow fixed size members are computed at
+///        compile time. The other members are found by skipping the previous
+///        ones (only the sizes of the strings and of the containers of fixed
+///        size elements are read), and the offsets are cached. When the object
+///        is serialized with an offset table (SERIALIZE_INDEXED), the offsets
+///        are read from the table.
+/// @tparam T   Type of the serialized object.
+/// @tparam Ser Serializer used to serialize the object (type table).
+template <typename T, typename Ser = Serializer<Bytes<std::byte> const>>
+class View {
+  public:
+    /* type alias *************************************************************/
+
+    using mem_type = std::remove_reference_t<typename Ser::mem_type>;
+    using members_type = decltype(std::declval<T &>().serializedMembers());
+
+    /// @brief Type of the member I.
+    template <size_t I>
+    using member_type = mtf::clean_t<std::tuple_element_t<I, members_type>>;
+
+    /// @brief Number of members.
+    static constexpr size_t nb_members = std::tuple_size_v<members_type>;
+
+    static_assert(!concepts::CompactSizes<mem_type> &&
+                      !concepts::CompactIntegers<mem_type> &&
+                      !concepts::InternsStrings<mem_type>,
+                  "The views require the default layout.");
+
+    /* constructor ************************************************************/
+
+    /// @brief Constructor.
+    /// @param mem Memory buffer that contains the serialized object.
+    /// @param pos Position of the object in the buffer.
+    constexpr explicit View(mem_type &mem, size_t pos = 0) : mem_(mem) {
+        offsets_.fill(npos);
+        offsets_[0] = pos + id_size;
+        if constexpr (indexed) {
+            Ser serializer(mem_, offsets_[0]);
+            nbIndexed_ = serializer.template deserializeTrivial<uint32_t>();
+            table_ = serializer.pos;
+            offsets_[0] = table_ + nbIndexed_ * sizeof(uint32_t);
+        }
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Returns the position of the member I in the buffer (I can be
+    ///        nb_members, the end of the object).
+    /// @throw std::out_of_range if the member is not in the offset table.
+    template <size_t I> constexpr size_t offset() const {
+        static_assert(I <= nb_members, "Invalid member index.");
+        if constexpr (indexed) {
+            return I == 0 ? offsets_[0] : indexedEnd(I - 1);
+        } else if constexpr (static_offsets[I] != mtf::dynamic_size) {
+            return offsets_[0] + static_offsets[I];
+        } else {
+            if (offsets_[I] == npos) {
+                offsets_[I] = skip<member_type<I - 1>>(offset<I - 1>());
+            }
+            return offsets_[I];
+        }
+    }
+
+    /// @brief Returns the position of the end of the object in the buffer.
+    constexpr size_t end() const {
+        if constexpr (indexed) {
+            return nbIndexed_ == 0 ? offsets_[0] : indexedEnd(nbIndexed_ - 1);
+        } else {
+            return offset<nb_members>();
+        }
+    }
+
+    /// @brief Deserialize the member I.
+    /// @return Copy of the member.
+    /// @throw std::out_of_range if the member is not in the offset table.
+    template <size_t I> constexpr member_type<I> get() const {
+        static_assert(I < nb_members, "Invalid member index.");
+        static_assert(std::is_default_constructible_v<member_type<I>>,
+                      "Only the default constructible members can be read.");
+        if constexpr (indexed) {
+            if (I >= nbIndexed_) [[unlikely]] {
+                throw std::out_of_range("error: the member is not serialized.");
+            }
+        }
+        member_type<I> value{};
+        Ser serializer(mem_, offset<I>());
+        serializer.deserialize_(value);
+        return value;
+    }
+
+  private:
+    static constexpr size_t npos = size_t(-1);
+
+    /// @brief True if the object is serialized with an offset table.
+    static constexpr bool indexed =
+        requires { requires T::serialized_with_index; };
+
+    /// @brief Size of the id serialized before the members (type table of
+    ///        the SERIALIZE_POLYMORPHIC types or of the serializer).
+    static constexpr size_t id_size = [] {
+        if constexpr (mtf::polymorphic_id_size_v<T> > 0) {
+            return mtf::polymorphic_id_size_v<T>;
+        } else if constexpr (has_type_v<T, typename Ser::type_table>) {
+            return sizeof(typename Ser::id_type);
+        } else {
+            return size_t(0);
+        }
+    }();
+
+    /// @brief Offsets of the members that can be computed at compile time
+    ///        (relative to the first member).
+    static constexpr std::array<size_t, nb_members + 1> static_offsets = [] {
+        std::array<size_t, nb_members + 1> result;
+        std::array<size_t, nb_members> sizes = []<size_t... Is>(
+                                                   std::index_sequence<Is...>) {
+            return std::array<size_t, nb_members>{
+                mtf::static_serialized_size_v<member_type<Is>>...};
+        }(std::make_index_sequence<nb_members>());
+        result[0] = 0;
+        for (size_t i = 0; i < nb_members; ++i) {
+            result[i + 1] = result[i] == mtf::dynamic_size ||
+                                    sizes[i] == mtf::dynamic_size
+                                ? mtf::dynamic_size
+                                : result[i] + sizes[i];
+        }
+        return result;
+    }();
+
+    /// @brief True if M is a container of fixed size elements.
+    template <typename M>
+    static constexpr bool has_fixed_size_elements = [] {
+        if constexpr (concepts::Container<M> &&
+                      !concepts::Serializable<M, mem_type>) {
+            return concepts::FixedSize<mtf::iter_value_t<M>>;
+        } else {
+            return false;
+        }
+    }();
+
+    /// @brief Returns the position of the element that follows the serialized
+    ///        M at pos.
+    template <typename M> constexpr size_t skip(size_t pos) const {
+        Ser serializer(mem_, pos);
+
+        if constexpr (concepts::FixedSize<M>) {
+            return pos + mtf::static_serialized_size_v<M>;
+        } else if constexpr (concepts::String<M>) {
+            using size_type = typename M::size_type;
+            size_type size = serializer.template deserializeSize<size_type>();
+            return serializer.pos + size * sizeof(typename M::value_type);
+        } else if constexpr (has_fixed_size_elements<M>) {
+            using size_type = decltype(std::size(std::declval<M>()));
+            size_type size = serializer.template deserializeSize<size_type>();
+            return serializer.pos +
+                   size * mtf::static_serialized_size_v<mtf::iter_value_t<M>>;
+        } else {
+            static_assert(std::is_default_constructible_v<M>,
+                          "The member cannot be skipped.");
+            M value{};
+            serializer.deserialize_(value);
+            return serializer.pos;
+        }
+    }
+
+    /// @brief Read the end of the member idx in the offset table.
+    constexpr size_t indexedEnd(size_t idx) const {
+        if (idx >= nbIndexed_) [[unlikely]] {
+            throw std::out_of_range("error: the member is not serialized.");
+        }
+        Ser serializer(mem_, table_ + idx * sizeof(uint32_t));
+        return offsets_[0] + serializer.template deserializeTrivial<uint32_t>();
+    }
+
+    mem_type &mem_; ///< memory buffer
+    size_t table_ = 0;     ///< position of the offset table
+    size_t nbIndexed_ = 0; ///< number of members in the offset table
+    mutable std::array<size_t, nb_members + 1> offsets_; ///< cached offsets
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -1,3 +1,5 @@
+#ifndef HEDGEHOG_HPP
+#define HEDGEHOG_HPP
 #include <serializer/serializer.hpp>
 #include <serializer/tools/macros.hpp>
 
@@ -19,8 +21,8 @@ template <typename T, BlockId Id> class MatrixBlock;
 template <typename T>
 using TypeTable = serializer::tools::TypeTable<Matrix<T>, PartialSum<T>,
                                                MatrixBlock<T, Input>>;
-template <typename T>
-using HHSerializer = serializer::Serializer<serializer::Bytes, TypeTable<T>>;
+template <typename T, typename MemT = serializer::Bytes>
+using HHSerializer = serializer::Serializer<MemT, TypeTable<T>>;
 
 /******************************************************************************/
 /*                          matrix and matrix blocks                          */
@@ -67,8 +69,9 @@ template <typename T, BlockId Id> class MatrixBlock {
     /* SERIALIZE(serializer::tools::getId<MatrixBlock<T, Id>>(TypeTable<T>()), x_, */
     /*           y_, matrixWidth_, matrixHeight_, blockSize_, dataSize_, */
     /*           SER_DARR(data_, dataSize_)); */
-    SERIALIZE_CUSTOM(HHSerializer<T>, x_, y_, matrixWidth_, matrixHeight_,
-                   blockSize_, dataSize_, SER_DARR(data_, dataSize_));
+    template <typename MemT> using Serializer = HHSerializer<T, MemT>;
+    SERIALIZE_CUSTOM(Serializer<SER_MEMT>, x_, y_, matrixWidth_, matrixHeight_,
+                     blockSize_, dataSize_, SER_DARR(data_, dataSize_));
 
     size_t x() const { return x_; }
     size_t y() const { return y_; }
@@ -98,12 +101,14 @@ template <typename T> struct PartialSum {
 /******************************************************************************/
 
 struct Network {
+    static inline serializer::BytesPool pool;
     static inline serializer::Bytes data;
-    static void send(serializer::Bytes mem) {
+    static void send(serializer::Bytes const &mem) {
         data.append(data.size(), mem.data(), mem.size());
     }
-    static serializer::Bytes rcv() {
-        serializer::Bytes result = data;
+    static serializer::BytesPool::Lease rcv() {
+        auto result = pool.acquire(data.size());
+        *result = data;
         data.clear();
         return result;
     }
@@ -174,7 +179,7 @@ struct TaskManager : RunExecute<Tasks...> {
     TaskManager(std::shared_ptr<Tasks>... tasks)
         : RunExecute<Tasks...>(std::make_tuple(tasks...)) {}
 
-    void receive(serializer::Bytes buff) {
+    void receive(serializer::Bytes const &buff) {
         size_t pos = 0;
 
         while (pos < buff.size()) {
@@ -186,6 +191,13 @@ struct TaskManager : RunExecute<Tasks...> {
             });
         }
     }
+
+    /// receive a batch of records (see serializer::tools::BatchWriter)
+    void receiveBatch(serializer::Bytes const &buff) {
+        serializer::tools::BatchReader<TypeTable, const serializer::Bytes>
+            reader(buff);
+        reader.dispatch([&](auto v) { this->runExecute(v); });
+    }
 };
 
 /******************************************************************************/
@@ -239,3 +251,5 @@ template <typename T> struct ResultTask : Task<In<PartialSum<T>>, Out<>> {
     }
     size_t result = 0;
 };
+
+#endif
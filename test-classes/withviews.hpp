@@ -0,0 +1,28 @@
+#ifndef WITH_VIEWS_HPP
+#define WITH_VIEWS_HPP
+#include <serializer/serializer.hpp>
+#include <serializer/tools/macros.hpp>
+#include <span>
+#include <string_view>
+
+class WithViews {
+  public:
+    explicit WithViews(int x = 0, std::string_view str = "",
+                       std::span<const double> values = {})
+        : x_(x), str_(str), values_(values) {}
+    ~WithViews() = default;
+
+    SERIALIZE(x_, str_, values_);
+
+    /* accessors **************************************************************/
+    [[nodiscard]] int x() const { return x_; }
+    [[nodiscard]] std::string_view str() const { return str_; }
+    [[nodiscard]] std::span<const double> values() const { return values_; }
+
+  private:
+    int x_;
+    std::string_view str_;
+    std::span<const double> values_;
+};
+
+#endif
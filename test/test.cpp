@@ -25,6 +25,47 @@
 #define TEST_DYNAMIC_ARRAYS
 #define TEST_TREE
 #define TEST_HH
+#define TEST_SERIALIZED_SIZE
+#define TEST_UNCHECKED
+#define TEST_PACKED
+#define TEST_VIEWS
+#define TEST_MAPPED_FILE
+#define TEST_STREAM
+#define TEST_ARENA
+#define TEST_BYTES_POOL
+#define TEST_COMPACT
+#define TEST_DISPATCH
+#define TEST_BATCH
+#define TEST_BATCH_PARALLEL
+#define TEST_PARALLEL
+#define TEST_ENDIAN
+#define TEST_VERIFIED
+#define TEST_COMPRESSION
+#define TEST_DELTA
+#define TEST_TRACKED
+#define TEST_MOVE_INSERT
+#define TEST_FIXED_SIZE
+#define TEST_LAZY_VIEW
+#define TEST_INDEXED
+#define TEST_INCREMENTAL
+#define TEST_CHANNEL
+#define TEST_SCATTER_GATHER
+#define TEST_BITWISE
+#define TEST_COLUMNAR
+#define TEST_INSTRUMENTATION
+#define TEST_LARGE_BYTES
+#define TEST_SMALL_BYTES
+#define TEST_REUSE
+#define TEST_STATIC_DISPATCH
+#define TEST_CODEC
+#define TEST_CONTIGUOUS_ARRAYS
+#define TEST_INTERNED_STRINGS
+#define TEST_SHARED_RING
+#define TEST_DISPATCHER
+#define TEST_NUMERIC_CODECS
+#define TEST_VARIANTS
+#define TEST_PINNED
+#define TEST_MPI
 
 /******************************************************************************/
 /*                         tests with a simple class                          */
@@ -1052,12 +1093,3938 @@ TEST_CASE("hedgehog") {
     matrix->serialize(buff);
     Network::send(buff);
 
-    tm.receive(Network::rcv()); // receive the matrix in the split task
-    tm.receive(Network::rcv()); // receive the blocks in the compute task
-    tm.receive(Network::rcv()); // receive the partial sums in the result task
+    tm.receive(*Network::rcv()); // receive the matrix in the split task
+    tm.receive(*Network::rcv()); // receive the blocks in the compute task
+    tm.receive(*Network::rcv()); // receive the partial sums in the result task
 
     REQUIRE(rt->result == sum);
 
     delete[] data;
 }
 #endif
+
+/******************************************************************************/
+/*                              serialized size                               */
+/******************************************************************************/
+
+#ifdef TEST_SERIALIZED_SIZE
+#include "test-classes/hedgehog.hpp"
+#include "test-classes/simple.hpp"
+#include "test-classes/withcontainer.hpp"
+TEST_CASE("serialized size") {
+    Simple simple(1, 2, "hello world");
+    WithContainer container;
+    double data[16] = {0};
+    Matrix<double> matrix(4, 4, 2, data);
+    MatrixBlock<double, Input> block(0, 0, 4, 4, 2, 16, data);
+    serializer::Bytes result;
+
+    for (int i = 0; i < 10; ++i) {
+        container.addInt(i);
+        container.addDouble(double(i));
+        container.addSimple(Simple(i, 2 * i, "simple"));
+        container.addVec(std::vector<int>(i, i));
+    }
+
+    REQUIRE(serializer::serializedSize(simple) == simple.serialize(result));
+    REQUIRE(serializer::serializedSize(simple) == result.size());
+    REQUIRE(serializer::serializedSize(container) ==
+            container.serialize(result));
+    REQUIRE(serializer::serializedSize(matrix) == matrix.serialize(result));
+    REQUIRE(serializer::serializedSize(block) == block.serialize(result));
+    REQUIRE(serializer::serializedSize(simple, container) ==
+            serializer::serializedSize(simple) +
+                serializer::serializedSize(container));
+
+    // the buffer is allocated only once
+    serializer::Bytes exact;
+    size_t size = serializer::serializedSize(container);
+    exact.reserve(size);
+    container.serialize(exact);
+    REQUIRE(exact.size() == size);
+    REQUIRE(exact.capacity() == size);
+}
+#endif
+
+/******************************************************************************/
+/*                            unchecked serializer                            */
+/******************************************************************************/
+
+#ifdef TEST_UNCHECKED
+#include "test-classes/cstruct.h"
+#include "test-classes/withcontainer.hpp"
+TEST_CASE("unchecked serializer") {
+    WithContainer origin;
+    WithContainer other;
+    CStructSerializable cstruct('a', 1, 2, 3.0, 4.0);
+    CStructSerializable cstructOther;
+    serializer::Bytes checked;
+    serializer::Bytes result;
+    std::vector<std::byte> vec;
+
+    for (int i = 0; i < 10; ++i) {
+        origin.addInt(i);
+        origin.addDouble(double(i));
+        origin.addSimple(Simple(i, 2 * i, "simple"));
+        origin.addVec(std::vector<int>(i, i));
+    }
+
+    size_t size = origin.serialize(checked);
+    REQUIRE(serializer::serializeExact(result, 0, origin) == size);
+    REQUIRE(result.size() == size);
+    REQUIRE(result.capacity() == size);
+    REQUIRE(std::memcmp(result.data(), checked.data(), size) == 0);
+
+    other.deserialize(result);
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(origin.getVec()[i] == other.getVec()[i]);
+        REQUIRE(origin.getClassVec()[i] == other.getClassVec()[i]);
+    }
+
+    // serialize after some data
+    size_t end = serializer::serializeExact(result, size, cstruct);
+    REQUIRE(end == result.size());
+    REQUIRE(end == size + serializer::serializedSize(cstruct));
+    cstructOther.deserialize(result, size);
+    REQUIRE(cstructOther.c() == 'a');
+    REQUIRE(cstructOther.i() == 1);
+    REQUIRE(cstructOther.l() == 2);
+    REQUIRE(cstructOther.f() == 3.0);
+    REQUIRE(cstructOther.d() == 4.0);
+
+    // resizeable memory
+    REQUIRE(serializer::serializeExact(vec, 0, origin) == size);
+    REQUIRE(vec.size() == size);
+    REQUIRE(std::memcmp(vec.data(), checked.data(), size) == 0);
+
+    // fixed memory
+    std::array<std::byte, 8> small;
+    REQUIRE_THROWS_AS(serializer::serializeExact(small, 0, cstruct),
+                      std::out_of_range);
+}
+#endif
+
+/******************************************************************************/
+/*                            packed trivial types                            */
+/******************************************************************************/
+
+#ifdef TEST_PACKED
+#include "test-classes/cstruct.h"
+#include "test-classes/hedgehog.hpp"
+
+/// @brief Memory buffer that counts the appends.
+struct AppendCounter {
+    using byte_type = std::byte;
+    serializer::Bytes bytes;
+    size_t nbAppends = 0;
+
+    void append(size_t pos, std::byte const *elts, size_t nbBytes) {
+        ++nbAppends;
+        bytes.append(pos, elts, nbBytes);
+    }
+    std::byte const *data() const { return bytes.data(); }
+    size_t size() const { return bytes.size(); }
+    std::byte const &operator[](size_t idx) const { return bytes[idx]; }
+};
+
+TEST_CASE("packed trivial types") {
+    CStructSerializable origin('a', 1, 2, 3.0, 4.0);
+    CStructSerializable other;
+    AppendCounter mem;
+
+    // the 5 trivial members are appended at once
+    REQUIRE(origin.serialize(mem) == sizeof(char) + sizeof(int) +
+                                         sizeof(long) + sizeof(float) +
+                                         sizeof(double));
+    REQUIRE(mem.nbAppends == 1);
+
+    other.deserialize(mem);
+    REQUIRE(other.c() == 'a');
+    REQUIRE(other.i() == 1);
+    REQUIRE(other.l() == 2);
+    REQUIRE(other.f() == 3.0);
+    REQUIRE(other.d() == 4.0);
+
+    // the runs are interrupted by non trivial types: id + 5 sizes, then the
+    // array (marker + data)
+    double data[4] = {1, 2, 3, 4};
+    Matrix<double> matrix(2, 2, 1, data);
+    Matrix<double> matrixOther;
+    AppendCounter matrixMem;
+
+    matrix.serialize(matrixMem);
+    REQUIRE(matrixMem.nbAppends == 3);
+    matrixOther.deserialize(matrixMem);
+    REQUIRE(matrixOther.width() == 2);
+    REQUIRE(matrixOther.height() == 2);
+    REQUIRE(matrixOther.blockSize() == 1);
+    REQUIRE(matrixOther.nbRawBlocks() == 2);
+    REQUIRE(matrixOther.nbColBlocks() == 2);
+    for (size_t i = 0; i < 4; ++i) {
+        REQUIRE(matrixOther.data()[i] == data[i]);
+    }
+    delete[] matrixOther.data();
+}
+#endif
+
+/******************************************************************************/
+/*                                   views                                    */
+/******************************************************************************/
+
+#ifdef TEST_VIEWS
+#include "test-classes/withviews.hpp"
+TEST_CASE("views") {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    std::string str = "hello world!"; // the doubles are aligned
+    std::vector<double> values = {1, 2, 3, 4, 5};
+    WithViews origin(4, str, values);
+    WithViews other;
+    serializer::Bytes result;
+
+    REQUIRE(!serializer::concepts::Trivial<std::string_view>);
+    REQUIRE(!serializer::concepts::Trivial<std::span<const double>>);
+
+    origin.serialize(result);
+    other.deserialize(result);
+
+    REQUIRE(other.x() == 4);
+    REQUIRE(other.str() == str);
+    REQUIRE(other.values().size() == values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        REQUIRE(other.values()[i] == values[i]);
+    }
+
+    // no copy: the views point into the buffer
+    auto begin = std::bit_cast<const char *>(result.data());
+    auto end = begin + result.size();
+    REQUIRE(other.str().data() > begin);
+    REQUIRE(other.str().data() < end);
+    REQUIRE(std::bit_cast<const char *>(other.values().data()) > begin);
+    REQUIRE(std::bit_cast<const char *>(other.values().data()) < end);
+
+    // same format as the strings and the containers
+    std::string_view strView;
+    std::span<const double> valuesView;
+    size_t pos = serializer::serialize<Ser>(result, 0, values, str);
+    REQUIRE(serializer::deserialize<Ser>(result, 0, valuesView, strView) ==
+            pos);
+    REQUIRE(strView == str);
+    REQUIRE(std::equal(values.begin(), values.end(), valuesView.begin()));
+
+    // the elements must be aligned in the buffer
+    serializer::serialize<Ser>(result, 0, 'c', values);
+    char c = 0;
+    REQUIRE_THROWS_AS(
+        serializer::deserialize<Ser>(result, 0, c, valuesView),
+        std::invalid_argument);
+
+    // the characters are always aligned
+    pos = serializer::serialize<Ser>(result, 0, 'c', str);
+    REQUIRE(serializer::deserialize<Ser>(result, 0, c, strView) == pos);
+    REQUIRE(strView == str);
+}
+#endif
+
+/******************************************************************************/
+/*                                mapped file                                 */
+/******************************************************************************/
+
+#ifdef TEST_MAPPED_FILE
+#include "serializer/tools/mapped_file.hpp"
+#include "test-classes/withcontainer.hpp"
+#include <filesystem>
+TEST_CASE("mapped file") {
+    using File = serializer::tools::MappedFile<std::byte>;
+    std::string path = std::filesystem::temp_directory_path() /
+                       "serializer-test-mapped-file.bin";
+    WithContainer origin;
+    WithContainer other;
+    serializer::Bytes expected;
+
+    for (int i = 0; i < 1000; ++i) {
+        origin.addInt(i);
+        origin.addDouble(double(i));
+        origin.addSimple(Simple(i, 2 * i, "simple"));
+        origin.addVec(std::vector<int>(i % 10, i));
+    }
+    origin.serialize(expected);
+
+    {
+        // small capacity to test the growth of the mapping
+        File file(path, File::Mode::Write, 16);
+        REQUIRE(origin.serialize(file) == expected.size());
+        REQUIRE(file.size() == expected.size());
+        REQUIRE(file.capacity() >= expected.size());
+    }
+
+    REQUIRE(std::filesystem::file_size(path) == expected.size());
+
+    {
+        File file(path);
+        REQUIRE(file.size() == expected.size());
+        REQUIRE(std::memcmp(file.data(), expected.data(), file.size()) == 0);
+        other.deserialize(file);
+        REQUIRE(other.getVec() == origin.getVec());
+        REQUIRE(other.getLst() == origin.getLst());
+        REQUIRE(other.getClassVec() == origin.getClassVec());
+        REQUIRE(other.getVec2D() == origin.getVec2D());
+        REQUIRE_THROWS_AS(file.resize(file.size() + 1), std::system_error);
+    }
+
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS(File(path), std::system_error);
+}
+#endif
+
+/******************************************************************************/
+/*                                   stream                                   */
+/******************************************************************************/
+
+#ifdef TEST_STREAM
+#include "serializer/tools/stream.hpp"
+#include "test-classes/cstruct.h"
+#include "test-classes/withcontainer.hpp"
+#include <cstdio>
+#include <sstream>
+TEST_CASE("stream writer / reader") {
+    WithContainer origin;
+    WithContainer other;
+    CStructSerializable cstruct('a', 1, 2, 3.0, 4.0);
+    CStructSerializable cstructOther;
+    std::vector<double> large(1000, 3.14);
+    std::vector<double> largeOther;
+    serializer::Bytes expected;
+
+    for (int i = 0; i < 100; ++i) {
+        origin.addInt(i);
+        origin.addDouble(double(i));
+        origin.addSimple(Simple(i, 2 * i, "simple"));
+        origin.addVec(std::vector<int>(i % 10, i));
+    }
+
+    size_t pos = origin.serialize(expected);
+    pos = cstruct.serialize(expected, pos);
+    pos = serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+        expected, pos, large);
+
+    SECTION("std::ostream / std::istream") {
+        std::stringstream stream;
+        {
+            // small buffer: many flushes and direct writes
+            serializer::tools::StreamWriter<std::ostream> writer(stream, 64);
+            size_t end = origin.serialize(writer);
+            end = cstruct.serialize(writer, end);
+            end = serializer::serialize<serializer::Serializer<decltype(writer)>>(
+                writer, end, large);
+            REQUIRE(end == pos);
+            REQUIRE(writer.size() == pos);
+            writer.flush();
+            REQUIRE_THROWS_AS(writer.append(0, nullptr, 0), std::logic_error);
+        }
+
+        std::string str = stream.str();
+        REQUIRE(str.size() == expected.size());
+        REQUIRE(std::memcmp(str.data(), expected.data(), str.size()) == 0);
+
+        serializer::tools::StreamReader<std::istream> reader(stream, 64);
+        size_t end = other.deserialize(reader);
+        end = cstructOther.deserialize(reader, end);
+        end = serializer::deserialize<serializer::Serializer<decltype(reader)>>(
+            reader, end, largeOther);
+        REQUIRE(end == pos);
+        REQUIRE(other.getVec() == origin.getVec());
+        REQUIRE(other.getLst() == origin.getLst());
+        REQUIRE(other.getClassVec() == origin.getClassVec());
+        REQUIRE(other.getVec2D() == origin.getVec2D());
+        REQUIRE(cstructOther.c() == 'a');
+        REQUIRE(cstructOther.d() == 4.0);
+        REQUIRE(largeOther == large);
+        REQUIRE(reader.capacity() == 64);
+
+        // end of the stream
+        REQUIRE_THROWS_AS(other.deserialize(reader, end), std::out_of_range);
+    }
+
+    SECTION("file descriptor") {
+        std::FILE *file = std::tmpfile();
+        serializer::tools::FdStream stream(fileno(file));
+        {
+            serializer::tools::StreamWriter<serializer::tools::FdStream> writer(
+                stream, 128);
+            origin.serialize(writer);
+        }
+        std::rewind(file);
+        serializer::tools::StreamReader<serializer::tools::FdStream> reader(
+            stream, 128);
+        other.deserialize(reader);
+        REQUIRE(other.getVec() == origin.getVec());
+        REQUIRE(other.getClassVec() == origin.getClassVec());
+        std::fclose(file);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                                   arena                                    */
+/******************************************************************************/
+
+#ifdef TEST_ARENA
+struct ArenaNode {
+    int value = 0;
+    std::string name;
+    ArenaNode *left = nullptr;
+    ArenaNode *right = nullptr;
+    std::shared_ptr<std::vector<int>> values = nullptr;
+
+    SERIALIZE(value, name, left, right, values);
+};
+
+TEST_CASE("deserialization with an arena") {
+    serializer::tools::Arena arena(256);
+    serializer::Bytes result;
+    ArenaNode right{3, "right", nullptr, nullptr,
+                    std::make_shared<std::vector<int>>(10, 3)};
+    ArenaNode left{2, "left", nullptr, nullptr, nullptr};
+    ArenaNode origin{1, "root", &left, &right, nullptr};
+    ArenaNode other;
+    int *arr = new int[10];
+
+    for (int i = 0; i < 10; ++i) {
+        arr[i] = i;
+    }
+
+    size_t pos = origin.serialize(result);
+    serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+        result, pos, serializer::tools::DynamicArray(arr, 10));
+
+    for (int iteration = 0; iteration < 3; ++iteration) {
+        serializer::tools::WithArena mem(result, arena);
+        int *arrOther = nullptr;
+
+        pos = other.deserialize(mem);
+        serializer::deserialize<serializer::Serializer<decltype(mem)>>(
+            mem, pos, serializer::tools::DynamicArray(arrOther, 10));
+
+        REQUIRE(other.value == 1);
+        REQUIRE(other.left->value == 2);
+        REQUIRE(other.left->name == "left");
+        REQUIRE(other.right->value == 3);
+        REQUIRE(other.right->name == "right");
+        REQUIRE(*other.right->values == std::vector<int>(10, 3));
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(arrOther[i] == i);
+        }
+
+        // all the objects are in the arena
+        REQUIRE(arena.size() >= 2 * sizeof(ArenaNode) + 10 * sizeof(int));
+        REQUIRE(arena.capacity() > 0);
+
+        // the shared pointers must be released before the arena
+        other = ArenaNode();
+        arena.reset();
+        REQUIRE(arena.size() == 0);
+    }
+    size_t capacity = arena.capacity();
+    arena.release();
+    REQUIRE(arena.capacity() == 0);
+    REQUIRE(capacity > 0);
+    delete[] arr;
+}
+#endif
+
+/******************************************************************************/
+/*                                 bytes pool                                 */
+/******************************************************************************/
+
+#ifdef TEST_BYTES_POOL
+#include <thread>
+TEST_CASE("bytes") {
+    serializer::Bytes bytes(16);
+    serializer::Bytes other(64);
+    std::byte data[32] = {};
+
+    bytes.append(0, data, 8);
+    other.append(0, data, 32);
+
+    // the copy reuses the capacity
+    auto ptr = other.data();
+    other = bytes;
+    REQUIRE(other.data() == ptr);
+    REQUIRE(other.size() == 8);
+    REQUIRE(other.capacity() == 64);
+
+    // the move swaps the buffers
+    serializer::Bytes moved;
+    moved = std::move(other);
+    REQUIRE(moved.data() == ptr);
+    REQUIRE(moved.size() == 8);
+    REQUIRE(moved.capacity() == 64);
+    REQUIRE(other.capacity() == 0);
+}
+
+TEST_CASE("bytes pool") {
+    serializer::BytesPool pool(128);
+    std::byte *ptr = nullptr;
+
+    {
+        auto lease = pool.acquire();
+        REQUIRE(lease->capacity() == 128);
+        REQUIRE(lease->size() == 0);
+        ptr = lease->data();
+        lease->append(0, ptr, 10);
+        REQUIRE(pool.size() == 0);
+    }
+    REQUIRE(pool.size() == 1);
+
+    {
+        // the buffer is reused and cleared
+        auto lease = pool.acquire();
+        REQUIRE(lease->data() == ptr);
+        REQUIRE(lease->size() == 0);
+
+        // larger capacity
+        auto other = pool.acquire(1024);
+        REQUIRE(other->capacity() == 1024);
+
+        // buffer taken out of the pool
+        serializer::Bytes bytes = other.release();
+        REQUIRE(bytes.capacity() == 1024);
+    }
+    REQUIRE(pool.size() == 1);
+
+    // concurrent leases
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < 1000; ++i) {
+                auto lease = pool.acquire();
+                serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+                    *lease, 0, i, std::string("hello"));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(pool.size() >= 1);
+    REQUIRE(pool.size() <= 4);
+}
+#endif
+
+/******************************************************************************/
+/*                                  compact                                   */
+/******************************************************************************/
+
+#ifdef TEST_COMPACT
+#include "test-classes/polymorphic.hpp"
+#include "test-classes/simple.hpp"
+#include "test-classes/withcontainer.hpp"
+TEST_CASE("compact encoding") {
+    using Compact = serializer::tools::Compact<serializer::Bytes>;
+    using CompactIntegers = serializer::tools::Compact<serializer::Bytes, true>;
+    serializer::Bytes bytes;
+    serializer::Bytes compactBytes;
+
+    SECTION("varint") {
+        std::byte buf[serializer::tools::varint_max_size];
+        REQUIRE(serializer::tools::varintEncode(0, buf) == 1);
+        REQUIRE(serializer::tools::varintEncode(127, buf) == 1);
+        REQUIRE(serializer::tools::varintEncode(128, buf) == 2);
+        REQUIRE(buf[0] == std::byte(0x80));
+        REQUIRE(buf[1] == std::byte(0x01));
+        REQUIRE(serializer::tools::varintEncode(uint64_t(-1), buf) == 10);
+        for (int64_t value : {0l, -1l, 1l, -64l, 64l, INT64_MIN, INT64_MAX}) {
+            REQUIRE(serializer::tools::zigzagDecode(
+                        serializer::tools::zigzagEncode(value)) == value);
+        }
+        REQUIRE(serializer::tools::zigzagEncode(-1) == 1);
+        REQUIRE(serializer::tools::zigzagEncode(1) == 2);
+    }
+
+    SECTION("sizes") {
+        WithContainer origin;
+        WithContainer other;
+
+        for (int i = 0; i < 10; ++i) {
+            origin.addInt(i);
+            origin.addDouble(double(i));
+            origin.addSimple(Simple(i, 2 * i, "simple"));
+            origin.addVec(std::vector<int>(i, i));
+        }
+        Compact compact(compactBytes);
+        size_t size = origin.serialize(bytes);
+        size_t compactSize = origin.serialize(compact);
+
+        // 38 sizes (8 members, 10 vectors and 20 strings): 7 bytes are saved
+        // per size
+        REQUIRE(compactSize == compactBytes.size());
+        REQUIRE(compactSize == size - 7 * 38);
+        REQUIRE(other.deserialize(compact) == compactSize);
+        REQUIRE(other.getVec() == origin.getVec());
+        REQUIRE(other.getEmptyVec().empty());
+        REQUIRE(other.getLst() == origin.getLst());
+        REQUIRE(other.getClassVec() == origin.getClassVec());
+        REQUIRE(other.getVec2D() == origin.getVec2D());
+
+        // large sizes
+        std::string str(300, 'a');
+        std::string strOther;
+        REQUIRE(serializer::serialize<serializer::Serializer<Compact>>(
+                    compact, 0, str) == 302);
+        serializer::deserialize<serializer::Serializer<Compact>>(compact, 0,
+                                                                 strOther);
+        REQUIRE(strOther == str);
+    }
+
+    SECTION("integers") {
+        CompactIntegers compact(compactBytes);
+        int i = -3, iOther = 0;
+        unsigned long ul = 300, ulOther = 0;
+        char c = 'c', cOther = 0;
+        double d = 3.14, dOther = 0;
+        long l = INT64_MIN, lOther = 0;
+
+        using Ser = serializer::Serializer<CompactIntegers>;
+        REQUIRE(serializer::serialize<Ser>(compact, 0, i, ul, c, d, l) ==
+                1 + 2 + 1 + 8 + 10);
+        serializer::deserialize<Ser>(compact, 0, iOther, ulOther, cOther,
+                                     dOther, lOther);
+        REQUIRE(iOther == i);
+        REQUIRE(ulOther == ul);
+        REQUIRE(cOther == c);
+        REQUIRE(dOther == d);
+        REQUIRE(lOther == l);
+
+        Simple simple(1, -1, "hello");
+        Simple simpleOther;
+        REQUIRE(simple.serialize(compact) == 1 + 1 + 1 + 5);
+        simpleOther.deserialize(compact);
+        REQUIRE(simpleOther.x() == 1);
+        REQUIRE(simpleOther.y() == -1);
+        REQUIRE(simpleOther.str() == "hello");
+    }
+
+    SECTION("stacked wrappers") {
+        using Big =
+            serializer::tools::Endian<serializer::Bytes, std::endian::big>;
+        using Stacked = serializer::tools::Compact<Big, true>;
+        using Ser = serializer::Serializer<Stacked>;
+        using Inner = serializer::tools::Compact<serializer::Bytes, true>;
+        using Outer = serializer::tools::Endian<Inner, std::endian::big>;
+        Big big(bytes);
+        Stacked stacked(big);
+        Inner inner(compactBytes);
+        Outer outer(inner);
+
+        // both flags are kept whatever the order of the wrappers
+        static_assert(serializer::concepts::CompactIntegers<Stacked>);
+        static_assert(serializer::concepts::FixedByteOrder<Stacked>);
+        static_assert(serializer::concepts::CompactIntegers<Outer>);
+        static_assert(serializer::concepts::FixedByteOrder<Outer>);
+
+        std::string str(200, 'a'), strOther;
+        int i = -3, iOther = 0;
+        double d = 3.14, dOther = 0;
+        size_t end = serializer::serialize<Ser>(stacked, 0, str, i, d);
+        REQUIRE(end == 2 + 200 + 1 + 8);
+        REQUIRE(serializer::serialize<serializer::Serializer<Outer>>(
+                    outer, 0, str, i, d) == end);
+        REQUIRE(std::equal(bytes.data(), bytes.data() + end,
+                           compactBytes.data()));
+        REQUIRE(bytes[end - 8] == std::byte(0x40)); // big endian double
+
+        REQUIRE(serializer::deserialize<Ser>(stacked, 0, strOther, iOther,
+                                             dOther) == end);
+        REQUIRE(strOther == str);
+        REQUIRE(iOther == i);
+        REQUIRE(dOther == d);
+    }
+}
+
+TEST_CASE("type table id type") {
+    REQUIRE(std::is_same_v<SuperTable::id_type, uint8_t>);
+    REQUIRE(std::is_same_v<serializer::tools::TypeTable<>::id_type, uint8_t>);
+
+    try {
+        SuperClass *ptr = nullptr;
+        serializer::tools::createId<SuperTable>(SuperTable::id_type(42), ptr);
+        REQUIRE(false);
+    } catch (serializer::exceptions::IdNotFoundError const &e) {
+        REQUIRE(std::string(e.what()).find("'42'") != std::string::npos);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                                  dispatch                                  */
+/******************************************************************************/
+
+#ifdef TEST_DISPATCH
+template <size_t Id> struct Message {
+    size_t value = Id;
+};
+
+template <size_t... Ids>
+auto makeMessageTable(std::index_sequence<Ids...>)
+    -> serializer::tools::TypeTable<Message<Ids>...>;
+
+TEST_CASE("type table dispatch") {
+    using Table = decltype(makeMessageTable(std::make_index_sequence<300>()));
+    REQUIRE(std::is_same_v<Table::id_type, uint16_t>);
+
+    for (size_t id : {0, 1, 63, 255, 256, 299}) {
+        size_t result = 0;
+        serializer::tools::applyId(Table::id_type(id), Table(),
+                                   [&]<typename T>() { result = T().value; });
+        REQUIRE(result == id);
+    }
+    REQUIRE_THROWS_AS(serializer::tools::applyId(Table::id_type(300), Table(),
+                                                 []<typename T>() {}),
+                      std::logic_error);
+}
+#endif
+
+/******************************************************************************/
+/*                                   batch                                    */
+/******************************************************************************/
+
+#ifdef TEST_BATCH
+#include "test-classes/hedgehog.hpp"
+#include <cstring>
+#include <string>
+struct BatchName {
+    std::string name;
+    SERIALIZE(name);
+};
+
+TEST_CASE("batch") {
+    using Table = TypeTable<double>;
+    using Writer = serializer::tools::BatchWriter<Table>;
+    using Reader = serializer::tools::BatchReader<Table>;
+    serializer::Bytes buff;
+    double data[16];
+    double sum = 0;
+
+    for (size_t i = 0; i < 16; ++i) {
+        data[i] = (double)i;
+        sum += (double)i;
+    }
+
+    Writer writer(buff);
+    for (size_t i = 0; i < 100; ++i) {
+        writer.write(PartialSum<double>{(double)i});
+    }
+    auto record = writer.write(MatrixBlock<double, Input>(0, 0, 4, 4, 4, 16,
+                                                          data));
+    REQUIRE(writer.size() == 101);
+    REQUIRE(writer.pos() == buff.size());
+    REQUIRE(record.id == serializer::tools::getId<MatrixBlock<double, Input>>(
+                             Table()));
+
+    SECTION("iterate") {
+        Reader reader(buff);
+        Matrix<double> matrix;
+        size_t count = 0;
+
+        for (auto const &r : reader) {
+            if (count < 100) {
+                PartialSum<double> ps;
+                REQUIRE(r.id ==
+                        serializer::tools::getId<PartialSum<double>>(Table()));
+                reader.read(r, ps);
+                REQUIRE(ps.value == (double)count);
+                REQUIRE_THROWS_AS(reader.read(r, matrix), std::logic_error);
+            } else {
+                REQUIRE(r.pos == record.pos);
+                REQUIRE(r.size == record.size);
+            }
+            ++count;
+        }
+        REQUIRE(count == 101);
+    }
+
+    SECTION("dispatch") {
+        Reader reader(buff);
+        double result = 0;
+        size_t blocks = 0;
+
+        // the matrix blocks are skipped
+        REQUIRE(reader.dispatch([&](std::shared_ptr<PartialSum<double>> ps) {
+            result += ps->value;
+        }) == 100);
+        REQUIRE(result == 4950);
+
+        reader.dispatch([&](std::shared_ptr<MatrixBlock<double, Input>> b) {
+            REQUIRE(b->data()[15] == 15);
+            delete[] b->data();
+            ++blocks;
+        });
+        REQUIRE(blocks == 1);
+    }
+
+    SECTION("task manager") {
+        auto ct = std::make_shared<ComputeTask<double>>();
+        auto rt = std::make_shared<ResultTask<double>>();
+        TaskManager<Table, ComputeTask<double>, ResultTask<double>> tm(ct, rt);
+        serializer::Bytes blocks;
+        Writer blocksWriter(blocks);
+
+        blocksWriter.write(MatrixBlock<double, Input>(0, 0, 4, 4, 2, 16, data));
+        blocksWriter.write(MatrixBlock<double, Input>(2, 0, 4, 4, 2, 16, data));
+        blocksWriter.write(MatrixBlock<double, Input>(0, 2, 4, 4, 2, 16, data));
+        blocksWriter.write(MatrixBlock<double, Input>(2, 2, 4, 4, 2, 16, data));
+        tm.receiveBatch(blocks);
+        tm.receive(*Network::rcv());
+        REQUIRE(rt->result == sum);
+    }
+
+    SECTION("truncated") {
+        buff.resize(buff.size() - 1);
+        Reader reader(buff);
+        REQUIRE_THROWS_AS(reader.dispatch([](auto) {}), std::out_of_range);
+    }
+
+    SECTION("malformed payload") {
+        using NameTable = serializer::tools::TypeTable<BatchName>;
+        serializer::Bytes names;
+        serializer::tools::BatchWriter<NameTable> namesWriter(names);
+        auto first = namesWriter.write(BatchName{"ab"});
+        namesWriter.write(BatchName{"cd"});
+        serializer::tools::BatchReader<NameTable> reader(names);
+        BatchName result;
+
+        // the string cannot be read in the next record
+        size_t length = 20;
+        std::memcpy(names.data() + first.pos, &length, sizeof(length));
+        REQUIRE_THROWS_AS(reader.read(first, result),
+                          serializer::exceptions::CorruptedDataError);
+        REQUIRE_THROWS_AS(reader.dispatch([](std::shared_ptr<BatchName>) {}),
+                          serializer::exceptions::CorruptedDataError);
+
+        // the whole payload must be read
+        length = 1;
+        std::memcpy(names.data() + first.pos, &length, sizeof(length));
+        REQUIRE_THROWS_AS(reader.read(first, result),
+                          serializer::exceptions::CorruptedDataError);
+
+        // the other records are still valid
+        auto second = *++reader.begin();
+        reader.read(second, result);
+        REQUIRE(result.name == "cd");
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                       parallel batch deserialization                       */
+/******************************************************************************/
+
+#ifdef TEST_BATCH_PARALLEL
+#include "test-classes/hedgehog.hpp"
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+TEST_CASE("parallel batch deserialization") {
+    using Table = TypeTable<double>;
+    serializer::Bytes buff;
+    serializer::tools::BatchWriter<Table> writer(buff);
+    constexpr size_t nbRecords = 10000;
+    double data[4] = {1, 2, 3, 4};
+
+    for (size_t i = 0; i < nbRecords; ++i) {
+        writer.write(PartialSum<double>{(double)i});
+    }
+    // not handled
+    writer.write(MatrixBlock<double, Input>(0, 0, 2, 2, 2, 4, data));
+
+    std::atomic<size_t> sum = 0;
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    size_t count = serializer::tools::deserializeBatchParallel(
+        buff, Table(),
+        [&](std::shared_ptr<PartialSum<double>> ps) {
+            sum += (size_t)ps->value;
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        },
+        4);
+
+    REQUIRE(count == nbRecords);
+    REQUIRE(sum == nbRecords * (nbRecords - 1) / 2);
+    REQUIRE(threads.size() >= 1);
+    REQUIRE(threads.size() <= 4);
+
+    // the errors are forwarded
+    REQUIRE_THROWS_AS(serializer::tools::deserializeBatchParallel(
+                          buff, Table(),
+                          [&](std::shared_ptr<PartialSum<double>> ps) {
+                              if (ps->value == 42) {
+                                  throw std::runtime_error("error");
+                              }
+                          },
+                          4),
+                      std::runtime_error);
+
+    // empty batch
+    serializer::Bytes empty;
+    REQUIRE(serializer::tools::deserializeBatchParallel(empty, Table(),
+                                                        [](auto) {}) == 0);
+}
+#endif
+
+/******************************************************************************/
+/*                    parallel serialization of containers                    */
+/******************************************************************************/
+
+#ifdef TEST_PARALLEL
+#include "test-classes/simple.hpp"
+#include "test-classes/withcontainer.hpp"
+#include <array>
+#include <string>
+#include <vector>
+TEST_CASE("parallel serialization of containers") {
+    using Parallel = serializer::tools::Parallel<serializer::Bytes>;
+    serializer::Bytes expected;
+    serializer::Bytes bytes;
+
+    SECTION("vector of strings") {
+        std::vector<std::string> strs, result;
+        for (size_t i = 0; i < 10000; ++i) {
+            strs.push_back(std::string(i % 37, 'a' + i % 26));
+        }
+        Parallel par(bytes, 4);
+
+        size_t pos = serializer::serialize<serializer::Serializer<Parallel>>(
+            par, 0, 42, strs, 7);
+        serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+            expected, 0, 42, strs, 7);
+        REQUIRE(pos == expected.size());
+        REQUIRE(bytes.size() == expected.size());
+        REQUIRE(std::memcmp(bytes.data(), expected.data(), pos) == 0);
+
+        int a = 0, b = 0;
+        serializer::deserialize<serializer::Serializer<serializer::Bytes>>(
+            bytes, 0, a, result, b);
+        REQUIRE(a == 42);
+        REQUIRE(b == 7);
+        REQUIRE(result == strs);
+
+        // the memory is overwritten
+        size_t end = serializer::serialize<serializer::Serializer<Parallel>>(
+            par, 0, strs);
+        REQUIRE(bytes.size() == end);
+    }
+
+    SECTION("nested objects") {
+        WithContainer original, other;
+        for (int i = 0; i < 1000; ++i) {
+            original.addSimple(Simple(i, i * 2, "str" + std::to_string(i)));
+            original.addVec(std::vector<int>(i % 10, i));
+        }
+        Parallel par(bytes, 3, 16);
+
+        original.serialize(par);
+        original.serialize(expected);
+        REQUIRE(bytes.size() == expected.size());
+        REQUIRE(std::memcmp(bytes.data(), expected.data(), bytes.size()) == 0);
+
+        other.deserialize(bytes);
+        REQUIRE(other.getClassVec().size() == 1000);
+        REQUIRE(other.getClassVec()[999].x() == 999);
+        REQUIRE(other.getClassVec()[999].str() == "str999");
+        REQUIRE(other.getVec2D() == original.getVec2D());
+    }
+
+    SECTION("compact and byte order memories") {
+        using Compact = serializer::tools::Compact<serializer::Bytes, true>;
+        using Big =
+            serializer::tools::Endian<serializer::Bytes, std::endian::big>;
+        WithContainer original;
+        for (int i = 0; i < 1000; ++i) {
+            original.addSimple(Simple(i, -i, "str" + std::to_string(i)));
+            original.addVec(std::vector<int>(i % 10, i));
+        }
+
+        // the format of the wrapped memory is kept
+        Compact compact(bytes), compactExpected(expected);
+        serializer::tools::Parallel<Compact> par(compact, 3, 16);
+        original.serialize(par);
+        original.serialize(compactExpected);
+        REQUIRE(bytes.size() == expected.size());
+        REQUIRE(std::memcmp(bytes.data(), expected.data(), bytes.size()) == 0);
+
+        Big big(bytes), bigExpected(expected);
+        serializer::tools::Parallel<Big> parBig(big, 3, 16);
+        original.serialize(parBig);
+        original.serialize(bigExpected);
+        REQUIRE(bytes.size() == expected.size());
+        REQUIRE(std::memcmp(bytes.data(), expected.data(), bytes.size()) == 0);
+
+        // the parallel memory can also be wrapped
+        Parallel inner(bytes, 3, 16);
+        serializer::tools::Compact<Parallel, true> outer(inner);
+        original.serialize(outer);
+        original.serialize(compactExpected);
+        REQUIRE(bytes.size() == expected.size());
+        REQUIRE(std::memcmp(bytes.data(), expected.data(), bytes.size()) == 0);
+    }
+
+    SECTION("fixed size buffer") {
+        std::vector<std::string> strs(1000, "hello");
+        std::array<std::byte, 100> small;
+        serializer::tools::Parallel<std::array<std::byte, 100>> par(small, 2);
+
+        REQUIRE_THROWS_AS(
+            serializer::serialize<serializer::Serializer<decltype(par)>>(
+                par, 0, strs),
+            std::out_of_range);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                                 byte order                                 */
+/******************************************************************************/
+
+#ifdef TEST_ENDIAN
+#include "test-classes/simple.hpp"
+#include "test-classes/withdynamicarrays.hpp"
+#include "test-classes/withenums.hpp"
+#include <bit>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+/// @brief Check that the values of a vector are stored in big endian after
+///        the size.
+template <typename T>
+static bool isBigEndian(serializer::Bytes const &bytes,
+                        std::vector<T> const &values) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        auto expected = std::bit_cast<std::array<std::byte, sizeof(T)>>(
+            serializer::tools::byteswap(values[i]));
+        if (std::memcmp(bytes.data() + sizeof(size_t) + i * sizeof(T),
+                        expected.data(), sizeof(T)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T> static void checkBigEndianVectors() {
+    using Big = serializer::tools::Endian<serializer::Bytes, std::endian::big>;
+    serializer::Bytes bytes;
+    Big big(bytes);
+
+    for (size_t size : {0, 1, 3, 7, 16, 33, 100, 2000}) {
+        std::vector<T> values(size), result;
+        std::iota(values.begin(), values.end(), T(1));
+        for (auto &value : values) {
+            value = T(value * 31);
+        }
+        serializer::serialize<serializer::Serializer<Big>>(big, 0, values);
+        REQUIRE(isBigEndian(bytes, values));
+        serializer::deserialize<serializer::Serializer<Big>>(big, 0, result);
+        REQUIRE(result == values);
+    }
+}
+
+struct EndianPoint {
+    uint32_t a = 1;
+    uint16_t b = 2;
+
+    SERIALIZE_STRUCT();
+
+    bool operator==(EndianPoint const &) const = default;
+};
+
+TEST_CASE("byte order") {
+    using Big = serializer::tools::Endian<serializer::Bytes, std::endian::big>;
+    using Little =
+        serializer::tools::Endian<serializer::Bytes, std::endian::little>;
+    serializer::Bytes bytes;
+    Big big(bytes);
+
+    SECTION("byteswap") {
+        REQUIRE(serializer::tools::byteswap(uint16_t(0x0102)) == 0x0201);
+        REQUIRE(serializer::tools::byteswap(uint32_t(0x01020304)) ==
+                0x04030201);
+        REQUIRE(serializer::tools::byteswap(uint64_t(0x0102030405060708)) ==
+                0x0807060504030201);
+        REQUIRE(serializer::tools::byteswap(serializer::tools::byteswap(
+                    3.14)) == 3.14);
+
+        for (size_t size = 0; size < 80; ++size) {
+            std::vector<uint32_t> values(size), swapped(size);
+            std::iota(values.begin(), values.end(), 0x10203040u);
+            serializer::tools::byteswapArray(values.data(), swapped.data(),
+                                             size);
+            for (size_t i = 0; i < size; ++i) {
+                REQUIRE(swapped[i] == serializer::tools::byteswap(values[i]));
+            }
+            // in place
+            serializer::tools::byteswapArray(swapped.data(), swapped.data(),
+                                             size);
+            REQUIRE(swapped == values);
+        }
+    }
+
+    SECTION("scalars") {
+        uint32_t u = 0x01020304, ur = 0;
+        int16_t i = -2, ir = 0;
+        double d = 3.5, dr = 0;
+        DndClasses e = DndClasses::WIZARD, er = DndClasses::BARBARIAN;
+
+        size_t pos = serializer::serialize<serializer::Serializer<Big>>(
+            big, 0, u, i, d, e);
+        REQUIRE(pos == 4 + 2 + 8 + sizeof(e));
+        REQUIRE(bytes[0] == std::byte(0x01));
+        REQUIRE(bytes[1] == std::byte(0x02));
+        REQUIRE(bytes[2] == std::byte(0x03));
+        REQUIRE(bytes[3] == std::byte(0x04));
+        REQUIRE(bytes[4] == std::byte(0xff));
+        REQUIRE(bytes[5] == std::byte(0xfe));
+
+        serializer::deserialize<serializer::Serializer<Big>>(big, 0, ur, ir,
+                                                             dr, er);
+        REQUIRE(ur == u);
+        REQUIRE(ir == i);
+        REQUIRE(dr == d);
+        REQUIRE(er == e);
+    }
+
+    SECTION("trivial arrays") {
+        checkBigEndianVectors<uint16_t>();
+        checkBigEndianVectors<int32_t>();
+        checkBigEndianVectors<uint64_t>();
+        checkBigEndianVectors<float>();
+        checkBigEndianVectors<double>();
+
+        // the size is big endian too
+        std::vector<uint16_t> values = {1, 2, 3};
+        serializer::serialize<serializer::Serializer<Big>>(big, 0, values);
+        REQUIRE(bytes[sizeof(size_t) - 1] == std::byte(3));
+
+        int arr[7] = {1, 2, 3, 4, 5, 6, 7}, arrResult[7] = {};
+        serializer::serialize<serializer::Serializer<Big>>(big, 0, arr);
+        REQUIRE(bytes[3] == std::byte(1));
+        serializer::deserialize<serializer::Serializer<Big>>(big, 0,
+                                                             arrResult);
+        REQUIRE(std::equal(arr, arr + 7, arrResult));
+    }
+
+    SECTION("objects") {
+        Simple original(1, 2, "hello"), other;
+        original.serialize(big);
+        REQUIRE(bytes[3] == std::byte(1));
+        other.deserialize(big);
+        REQUIRE(other == original);
+
+        WithDynamicArray origin, result;
+        for (size_t i = 0; i < 5; ++i) {
+            origin.own()[i] = (int)i + 1;
+        }
+        for (size_t i = 0; i < 16; ++i) {
+            origin.twoDOneD()[i] = (int)i * 2;
+        }
+        origin.serialize(big);
+        result.deserialize(big);
+        for (size_t i = 0; i < 5; ++i) {
+            REQUIRE(result.own()[i] == origin.own()[i]);
+        }
+        for (size_t i = 0; i < 16; ++i) {
+            REQUIRE(result.twoDOneD()[i] == origin.twoDOneD()[i]);
+        }
+    }
+
+    SECTION("native order") {
+        serializer::Bytes expected;
+        Little little(bytes);
+        std::vector<uint32_t> values = {1, 2, 3};
+        Simple simple(4, 5, "native");
+
+        serializer::serialize<serializer::Serializer<Little>>(little, 0,
+                                                              values, simple);
+        serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+            expected, 0, values, simple);
+        if constexpr (std::endian::native == std::endian::little) {
+            REQUIRE(bytes.size() == expected.size());
+            REQUIRE(std::memcmp(bytes.data(), expected.data(),
+                                bytes.size()) == 0);
+        }
+    }
+    SECTION("bitwise structures") {
+        using Native = serializer::tools::Endian<serializer::Bytes,
+                                                 std::endian::native>;
+        using Swapped = std::conditional_t<std::endian::native ==
+                                               std::endian::little,
+                                           Big, Little>;
+        // the raw copy is only used when the order is the host one (the
+        // SERIALIZE_STRUCT types don't compile with the swapped memories)
+        static_assert(
+            serializer::Serializer<Native>::is_bitwise_v<EndianPoint>);
+        static_assert(
+            !serializer::Serializer<Swapped>::is_bitwise_v<EndianPoint>);
+        static_assert(!serializer::Serializer<Swapped>::is_bitwise_v<int>);
+
+        Native native(bytes);
+        EndianPoint point{3, 4}, pointResult;
+        std::vector<EndianPoint> points(10), pointsResult;
+        uint32_t value = 1, valueResult = 0;
+        points[5] = point;
+        size_t end = serializer::serialize<serializer::Serializer<Native>>(
+            native, 0, point, points, value);
+        REQUIRE(end == sizeof(EndianPoint) + sizeof(size_t) +
+                           10 * sizeof(EndianPoint) + 4);
+        REQUIRE(serializer::deserialize<serializer::Serializer<Native>>(
+                    native, 0, pointResult, pointsResult, valueResult) == end);
+        REQUIRE(pointResult == point);
+        REQUIRE(pointsResult == points);
+        REQUIRE(valueResult == 1);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                          verified deserialization                          */
+/******************************************************************************/
+
+#ifdef TEST_VERIFIED
+#include "test-classes/simple.hpp"
+#include "test-classes/withcontainer.hpp"
+#include <string>
+#include <vector>
+TEST_CASE("verified deserialization") {
+    using CorruptedDataError = serializer::exceptions::CorruptedDataError;
+    serializer::Bytes bytes;
+
+    SECTION("crc32c") {
+        std::string check = "123456789";
+        REQUIRE(serializer::tools::crc32c(check.data(), check.size()) ==
+                0xe3069283);
+        REQUIRE(serializer::tools::crc32c(check.data(), 0) == 0);
+
+        // by parts
+        uint32_t crc = serializer::tools::crc32c(check.data(), 4);
+        REQUIRE(serializer::tools::crc32c(check.data() + 4, 5, crc) ==
+                0xe3069283);
+
+        // same result as the software implementation for all the sizes
+        std::vector<unsigned char> data(100);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = (unsigned char)(i * 7);
+        }
+        for (size_t size = 0; size < data.size(); ++size) {
+            uint32_t expected = ~serializer::tools::crc32c_impl::update(
+                ~0u, data.data(), size);
+            REQUIRE(serializer::tools::crc32c(data.data(), size) == expected);
+        }
+    }
+
+    SECTION("checksum") {
+        Simple original(1, 2, "hello"), other;
+        std::vector<std::string> strs = {"a", "bc", "def"}, strsResult;
+
+        size_t end =
+            serializer::serializeWithChecksum(bytes, 0, original, strs);
+        REQUIRE(end == bytes.size());
+        REQUIRE(serializer::deserializeVerified(bytes, 0, other,
+                                                strsResult) == end);
+        REQUIRE(other == original);
+        REQUIRE(strsResult == strs);
+
+        // corrupted byte
+        bytes[5] ^= std::byte(1);
+        REQUIRE_THROWS_AS(serializer::deserializeVerified(bytes, 0, other,
+                                                          strsResult),
+                          CorruptedDataError);
+        bytes[5] ^= std::byte(1);
+
+        // truncated data
+        bytes.resize(3);
+        REQUIRE_THROWS_AS(serializer::deserializeVerified(bytes, 0, other,
+                                                          strsResult),
+                          CorruptedDataError);
+
+        // std::vector memory
+        std::vector<std::byte> vec;
+        end = serializer::serializeWithChecksum(vec, 0, strs);
+        REQUIRE(end == vec.size());
+        strsResult.clear();
+        serializer::deserializeVerified(vec, 0, strsResult);
+        REQUIRE(strsResult == strs);
+    }
+
+    SECTION("compact and byte order memories") {
+        using Compact = serializer::tools::Compact<serializer::Bytes, true>;
+        using Big =
+            serializer::tools::Endian<serializer::Bytes, std::endian::big>;
+        std::vector<std::string> strs(3, std::string(200, 'a')), strsResult;
+        uint32_t u = 0x01020304, uResult = 0;
+        Compact compact(bytes);
+        Big big(bytes);
+
+        size_t end = serializer::serializeWithChecksum(compact, 0, strs, u);
+        REQUIRE(end == 1 + 3 * (2 + 200) + 4 + 4);
+        REQUIRE(serializer::deserializeVerified(compact, 0, strsResult,
+                                                uResult) == end);
+        REQUIRE(strsResult == strs);
+        REQUIRE(uResult == u);
+
+        strsResult.clear();
+        uResult = 0;
+        end = serializer::serializeWithChecksum(big, 0, strs, u);
+        REQUIRE(serializer::deserializeVerified(big, 0, strsResult,
+                                                uResult) == end);
+        REQUIRE(strsResult == strs);
+        REQUIRE(uResult == u);
+    }
+
+    SECTION("bounds checks") {
+        using Verified = serializer::tools::Verified<serializer::Bytes>;
+        std::vector<std::string> strs = {"hello", "world"}, result;
+        Verified verified(bytes);
+
+        // invalid size
+        serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+            bytes, 0, size_t(1) << 60);
+        REQUIRE_THROWS_AS(
+            serializer::deserialize<serializer::Serializer<Verified>>(
+                verified, 0, result),
+            CorruptedDataError);
+
+        // truncated string
+        serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+            bytes, 0, strs);
+        for (size_t size = 0; size < bytes.size(); ++size) {
+            Verified truncated(bytes, size);
+            REQUIRE_THROWS_AS(
+                serializer::deserialize<serializer::Serializer<Verified>>(
+                    truncated, 0, result),
+                CorruptedDataError);
+        }
+
+        // nested objects
+        WithContainer original, other;
+        original.addSimple(Simple(1, 2, "simple"));
+        original.addVec({1, 2, 3});
+        original.serialize(bytes);
+        other.deserialize(verified);
+        REQUIRE(other.getClassVec() == original.getClassVec());
+        Verified truncated(bytes, bytes.size() - 1);
+        REQUIRE_THROWS_AS(other.deserialize(truncated), CorruptedDataError);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                                compression                                 */
+/******************************************************************************/
+
+#ifdef TEST_COMPRESSION
+#include "test-classes/simple.hpp"
+#include <cstring>
+#include <serializer/tools/compression.hpp>
+#include <string>
+#include <vector>
+TEST_CASE("compression") {
+    using serializer::tools::Codec;
+    using serializer::tools::Compression;
+    serializer::Bytes bytes;
+    std::vector<float> data(100000), dataResult;
+    Simple simple(1, 2, std::string(1000, 'a')), simpleResult;
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = float(i % 100) * 0.5f;
+    }
+    size_t rawSize = serializer::serializedSize(data, simple);
+
+    for (Codec codec : {Codec::Store, Codec::Deflate, Codec::LZ4, Codec::Zstd}) {
+        if (!serializer::tools::codecAvailable(codec)) {
+            REQUIRE_THROWS_AS(serializer::tools::serializeCompressed(
+                                  bytes, 0, Compression{codec}, data),
+                              std::invalid_argument);
+            continue;
+        }
+        for (size_t chunkSize : {100, 4096, 64 * 1024}) {
+            Compression compression{codec, 0, chunkSize};
+            bytes.clear();
+            size_t end = serializer::tools::serializeCompressed(
+                bytes, 0, compression, data, simple);
+            REQUIRE(end == bytes.size());
+            if (codec == Codec::Store) {
+                REQUIRE(end > rawSize);
+            } else if (chunkSize >= 4096) {
+                REQUIRE(end < rawSize / 4);
+            }
+
+            dataResult.clear();
+            REQUIRE(serializer::tools::deserializeCompressed(
+                        bytes, 0, dataResult, simpleResult) == end);
+            REQUIRE(dataResult == data);
+            REQUIRE(simpleResult == simple);
+        }
+    }
+
+    SECTION("following data") {
+        Compression compression{Codec::Store, 0, 1000};
+        size_t pos = serializer::serialize<
+            serializer::Serializer<serializer::Bytes>>(bytes, 0, 42);
+        pos = serializer::tools::serializeCompressed(bytes, pos, compression,
+                                                     simple);
+        size_t end = serializer::serialize<
+            serializer::Serializer<serializer::Bytes>>(bytes, pos, 7);
+
+        int before = 0, after = 0;
+        pos = serializer::deserialize<
+            serializer::Serializer<serializer::Bytes>>(bytes, 0, before);
+        pos = serializer::tools::deserializeCompressed(bytes, pos,
+                                                       simpleResult);
+        REQUIRE(serializer::deserialize<
+                    serializer::Serializer<serializer::Bytes>>(
+                    bytes, pos, after) == end);
+        REQUIRE(before == 42);
+        REQUIRE(after == 7);
+        REQUIRE(simpleResult == simple);
+    }
+
+    SECTION("invalid frames") {
+        Compression compression{Codec::Store, 0, 1000};
+        serializer::tools::serializeCompressed(bytes, 0, compression, simple);
+        bytes.resize(bytes.size() / 2);
+        REQUIRE_THROWS_AS(
+            serializer::tools::deserializeCompressed(bytes, 0, simpleResult),
+            std::out_of_range);
+        bytes[0] = std::byte(42); // invalid codec
+        REQUIRE_THROWS_AS(
+            serializer::tools::deserializeCompressed(bytes, 0, simpleResult),
+            std::runtime_error);
+    }
+
+    SECTION("oversized frame") {
+        Compression compression{Codec::Store, 0, 1000};
+        serializer::tools::serializeCompressed(bytes, 0, compression, simple);
+        uint32_t raw = 0xFFFFFFFF; // the size is read before the payload
+        std::memcpy(bytes.data() + 1, &raw, sizeof(raw));
+        REQUIRE_THROWS_AS(
+            serializer::tools::deserializeCompressed(bytes, 0, simpleResult),
+            serializer::exceptions::CorruptedDataError);
+    }
+
+    SECTION("non zero position") {
+        Compression compression{Codec::Store, 0, 1000};
+        std::vector<std::byte> buffer(100000); // resizeable, not appendable
+        size_t end = serializer::tools::serializeCompressed(buffer, 10,
+                                                            compression,
+                                                            simple);
+        REQUIRE(end < buffer.size());
+        REQUIRE(buffer.size() == 100000);
+        REQUIRE(serializer::tools::deserializeCompressed(buffer, 10,
+                                                         simpleResult) == end);
+        REQUIRE(simpleResult == simple);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                                   delta                                    */
+/******************************************************************************/
+
+#ifdef TEST_DELTA
+#include "test-classes/simple.hpp"
+#include <map>
+#include <string>
+#include <vector>
+struct DeltaState {
+    int id = 0;
+    double position[3] = {0, 0, 0};
+    std::vector<int> samples;
+    std::map<std::string, int> counters;
+    Simple simple;
+
+    SERIALIZE(id, position, samples, counters, simple);
+
+    bool operator==(DeltaState const &other) const {
+        return id == other.id && position[0] == other.position[0] &&
+               position[1] == other.position[1] &&
+               position[2] == other.position[2] && samples == other.samples &&
+               counters == other.counters && simple == other.simple;
+    }
+};
+
+TEST_CASE("delta serialization") {
+    serializer::Bytes patch;
+    serializer::tools::Snapshot snapshot;
+    DeltaState state, replica;
+
+    state.id = 1;
+    state.samples.assign(1000, 7);
+    state.counters = {{"a", 1}, {"b", 2}};
+    state.simple = Simple(1, 2, "hello");
+
+    // first delta: all the members
+    size_t full = serializer::tools::serializeDelta(patch, 0, snapshot, state);
+    REQUIRE(full == patch.size());
+    REQUIRE(snapshot.nbMembers() == 5);
+    REQUIRE(serializer::tools::deserializeDelta(patch, 0, replica) == full);
+    REQUIRE(replica == state);
+
+    SECTION("changed members") {
+        state.id = 2;
+        state.counters["c"] = 3;
+        size_t end =
+            serializer::tools::serializeDelta(patch, 0, snapshot, state);
+        REQUIRE(end == patch.size());
+        REQUIRE(end < full / 10);
+        REQUIRE(serializer::tools::deserializeDelta(patch, 0, replica) == end);
+        REQUIRE(replica == state);
+
+        // nested object and size change
+        state.simple.str("world!");
+        state.samples.push_back(8);
+        end = serializer::tools::serializeDelta(patch, 0, snapshot, state);
+        REQUIRE(serializer::tools::deserializeDelta(patch, 0, replica) == end);
+        REQUIRE(replica == state);
+    }
+
+    SECTION("unchanged object") {
+        size_t end =
+            serializer::tools::serializeDelta(patch, 0, snapshot, state);
+        REQUIRE(end == sizeof(size_t) + 1);
+        replica.id = 42; // not modified by the patch
+        REQUIRE(serializer::tools::deserializeDelta(patch, 0, replica) == end);
+        REQUIRE(replica.id == 42);
+        replica.id = state.id;
+        REQUIRE(replica == state);
+    }
+
+    SECTION("cleared snapshot") {
+        snapshot.clear();
+        REQUIRE(serializer::tools::serializeDelta(patch, 0, snapshot, state) ==
+                full);
+    }
+
+    SECTION("following data") {
+        state.id = 3;
+        size_t pos = serializer::serialize<
+            serializer::Serializer<serializer::Bytes>>(patch, 0, 42);
+        pos = serializer::tools::serializeDelta(patch, pos, snapshot, state);
+        size_t end = serializer::serialize<
+            serializer::Serializer<serializer::Bytes>>(patch, pos, 7);
+
+        int before = 0, after = 0;
+        pos = serializer::deserialize<
+            serializer::Serializer<serializer::Bytes>>(patch, 0, before);
+        pos = serializer::tools::deserializeDelta(patch, pos, replica);
+        REQUIRE(serializer::deserialize<
+                    serializer::Serializer<serializer::Bytes>>(
+                    patch, pos, after) == end);
+        REQUIRE(before == 42);
+        REQUIRE(after == 7);
+        REQUIRE(replica == state);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                              tracked objects                               */
+/******************************************************************************/
+
+#ifdef TEST_TRACKED
+#include "test-classes/simple.hpp"
+#include <memory>
+#include <vector>
+struct TrackedNode {
+    int value = 0;
+    std::vector<std::shared_ptr<TrackedNode>> children;
+
+    SERIALIZE(value, children);
+};
+
+TEST_CASE("tracked objects") {
+    serializer::Bytes bytes;
+
+    SECTION("shared pointers") {
+        auto leaf = std::make_shared<TrackedNode>();
+        leaf->value = 42;
+        leaf->children.push_back(std::make_shared<TrackedNode>());
+        auto root = std::make_shared<TrackedNode>();
+        for (size_t i = 0; i < 1000; ++i) {
+            auto child = std::make_shared<TrackedNode>();
+            child->value = int(i);
+            child->children = {leaf, leaf};
+            root->children.push_back(child);
+        }
+
+        serializer::tools::Tracked tracked(bytes);
+        size_t end = serializer::serialize<
+            serializer::Serializer<decltype(tracked)>>(tracked, 0, root, leaf);
+        REQUIRE(tracked.objects().size() == 1003);
+
+        serializer::Bytes untracked;
+        REQUIRE(serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+                    untracked, 0, root, leaf) > 2 * end);
+
+        std::shared_ptr<TrackedNode> rootResult, leafResult;
+        serializer::tools::Tracked trackedResult(bytes);
+        REQUIRE(serializer::deserialize<
+                    serializer::Serializer<decltype(trackedResult)>>(
+                    trackedResult, 0, rootResult, leafResult) == end);
+        REQUIRE(rootResult->children.size() == 1000);
+        REQUIRE(leafResult->value == 42);
+        REQUIRE(leafResult->children.size() == 1);
+        for (size_t i = 0; i < 1000; ++i) {
+            auto const &child = rootResult->children[i];
+            REQUIRE(child->value == int(i));
+            REQUIRE(child->children[0] == leafResult);
+            REQUIRE(child->children[1] == leafResult);
+        }
+        // shared ownership: the tracker, the leaf and 2 references per child
+        REQUIRE(leafResult.use_count() == 2002);
+    }
+
+    SECTION("raw pointers") {
+        int value = 7;
+        int *first = &value, *second = &value, *null = nullptr;
+        double other = 3.5;
+        double *otherPtr = &other;
+
+        serializer::tools::Tracked tracked(bytes);
+        size_t end = serializer::serialize<
+            serializer::Serializer<decltype(tracked)>>(tracked, 0, first,
+                                                       second, null, otherPtr);
+
+        int *firstResult = nullptr, *secondResult = nullptr, *nullResult = &value;
+        double *otherResult = nullptr;
+        serializer::tools::Tracked trackedResult(bytes);
+        REQUIRE(serializer::deserialize<
+                    serializer::Serializer<decltype(trackedResult)>>(
+                    trackedResult, 0, firstResult, secondResult, nullResult,
+                    otherResult) == end);
+        REQUIRE(*firstResult == 7);
+        REQUIRE(firstResult == secondResult);
+        REQUIRE(nullResult == nullptr);
+        REQUIRE(*otherResult == 3.5);
+        delete firstResult;
+        delete otherResult;
+    }
+
+    SECTION("serializable pointee") {
+        auto simple = std::make_shared<Simple>(1, 2, "hello");
+        std::shared_ptr<Simple> simpleResult, sameResult;
+        int after = 0;
+
+        serializer::tools::Tracked tracked(bytes);
+        size_t end = serializer::serialize<
+            serializer::Serializer<decltype(tracked)>>(tracked, 0, simple,
+                                                       simple, 42);
+        serializer::tools::Tracked trackedResult(bytes);
+        REQUIRE(serializer::deserialize<
+                    serializer::Serializer<decltype(trackedResult)>>(
+                    trackedResult, 0, simpleResult, sameResult, after) == end);
+        REQUIRE(*simpleResult == *simple);
+        REQUIRE(sameResult == simpleResult);
+        REQUIRE(after == 42);
+
+        // not tracked
+        end = serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+            bytes, 0, simple, 42);
+        after = 0;
+        REQUIRE(serializer::deserialize<
+                    serializer::Serializer<serializer::Bytes>>(
+                    bytes, 0, simpleResult, after) == end);
+        REQUIRE(*simpleResult == *simple);
+        REQUIRE(after == 42);
+    }
+
+    SECTION("invalid reference") {
+        auto leaf = std::make_shared<TrackedNode>();
+        serializer::tools::Tracked tracked(bytes);
+        serializer::serialize<serializer::Serializer<decltype(tracked)>>(
+            tracked, 0, leaf, leaf);
+        std::shared_ptr<TrackedNode> result, same;
+        // the reference is deserialized before the object
+        serializer::tools::Tracked trackedResult(bytes);
+        REQUIRE_THROWS_AS(
+            (serializer::deserialize<
+                serializer::Serializer<decltype(trackedResult)>>(
+                trackedResult, bytes.size() - sizeof(size_t) - 1, same)),
+            serializer::exceptions::CorruptedDataError);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                           move into containers                             */
+/******************************************************************************/
+
+#ifdef TEST_MOVE_INSERT
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+struct CountCopies {
+    static inline size_t copies = 0;
+    std::vector<int> values;
+
+    CountCopies() = default;
+    CountCopies(std::vector<int> values) : values(std::move(values)) {}
+    CountCopies(CountCopies const &other) : values(other.values) { ++copies; }
+    CountCopies(CountCopies &&) = default;
+    CountCopies &operator=(CountCopies const &other) {
+        values = other.values;
+        ++copies;
+        return *this;
+    }
+    CountCopies &operator=(CountCopies &&) = default;
+
+    bool operator==(CountCopies const &) const = default;
+    auto operator<=>(CountCopies const &) const = default;
+
+    SERIALIZE(values);
+};
+
+TEST_CASE("move the elements into the containers") {
+    serializer::Bytes bytes;
+    std::map<std::string, CountCopies> map, mapResult;
+    std::unordered_map<int, CountCopies> umap, umapResult;
+    std::set<CountCopies> set, setResult;
+    std::list<CountCopies> lst, lstResult;
+
+    for (int i = 0; i < 100; ++i) {
+        map.emplace(std::to_string(i), std::vector<int>(10, i));
+        umap.emplace(i, std::vector<int>(i, i));
+        set.emplace(std::vector<int>(1, i));
+        lst.emplace_back(std::vector<int>(2, i));
+    }
+    mapResult = {{"old", {}}};
+
+    size_t end = serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+        bytes, 0, map, umap, set, lst);
+    CountCopies::copies = 0;
+    REQUIRE(serializer::deserialize<serializer::Serializer<serializer::Bytes>>(
+                bytes, 0, mapResult, umapResult, setResult, lstResult) == end);
+    REQUIRE(CountCopies::copies == 0);
+    REQUIRE(mapResult == map);
+    REQUIRE(umapResult == umap);
+    REQUIRE(setResult == set);
+    REQUIRE(lstResult == lst);
+    REQUIRE(umapResult.bucket_count() >= umap.size());
+}
+#endif
+
+/******************************************************************************/
+/*                                 fixed size                                 */
+/******************************************************************************/
+
+#ifdef TEST_FIXED_SIZE
+#include "test-classes/cstruct.h"
+#include "test-classes/simple.hpp"
+#include "test-classes/withstaticarrays.hpp"
+#include <array>
+#include <string>
+#include <tuple>
+#include <vector>
+struct FixedHeader {
+    int id = 0;
+    double position[3] = {0, 0, 0};
+    std::array<short, 2> flags = {0, 0};
+    std::tuple<char, long> key = {0, 0};
+    CStructSerializable cs;
+
+    SERIALIZE(id, position, flags, key, cs);
+};
+
+struct FixedIndexed {
+    int a = 0, b = 0;
+
+    SERIALIZE_INDEXED(a, b);
+};
+
+TEST_CASE("fixed size serialization") {
+    using serializer::mtf::dynamic_size;
+    using serializer::mtf::static_serialized_size_v;
+
+    static_assert(static_serialized_size_v<int> == sizeof(int));
+    static_assert(static_serialized_size_v<CStruct> == sizeof(CStruct));
+    static_assert(static_serialized_size_v<CStructSerializable> == 25);
+    static_assert(static_serialized_size_v<int[2][3]> == 6 * sizeof(int));
+    static_assert(static_serialized_size_v<std::array<int, 4>> ==
+                  sizeof(size_t) + 4 * sizeof(int));
+    static_assert(static_serialized_size_v<std::tuple<int, char[3]>> == 7);
+    static_assert(static_serialized_size_v<FixedHeader> ==
+                  4 + 24 + sizeof(size_t) + 4 + 9 + 25);
+    static_assert(static_serialized_size_v<Simple> == dynamic_size);
+    static_assert(static_serialized_size_v<WithStaticArrays> == dynamic_size);
+    static_assert(static_serialized_size_v<std::string> == dynamic_size);
+    static_assert(static_serialized_size_v<std::vector<int>> == dynamic_size);
+    static_assert(static_serialized_size_v<int *> == dynamic_size);
+    static_assert(!serializer::concepts::FixedSize<std::tuple<int, Simple>>);
+
+    FixedHeader header, headerResult;
+    header.id = 42;
+    header.position[1] = 3.5;
+    header.flags = {1, 2};
+    header.key = {'k', 1l << 40};
+    header.cs = CStructSerializable('c', 1, 2, 3.5f, 4.5);
+    CStruct cstruct = {'a', 1, 2, 3.0f, 4.0}, cstructResult = {};
+    int after = 7, afterResult = 0;
+
+    // same layout as the default serializer
+    REQUIRE(serializer::serializedSize(header) ==
+            static_serialized_size_v<FixedHeader>);
+    REQUIRE(serializer::serializedSize(header, cstruct) ==
+            static_serialized_size_v<FixedHeader> + sizeof(CStruct));
+
+    serializer::fixed_bytes_t<FixedHeader, CStruct, int> bytes;
+    static_assert(bytes.size() ==
+                  static_serialized_size_v<FixedHeader> + sizeof(CStruct) + 4);
+    REQUIRE(serializer::serializeFixed(bytes, header, cstruct, after) ==
+            bytes.size());
+    REQUIRE(serializer::deserializeFixed(bytes, headerResult, cstructResult,
+                                         afterResult) == bytes.size());
+    REQUIRE(headerResult.id == 42);
+    REQUIRE(headerResult.position[1] == 3.5);
+    REQUIRE(headerResult.flags == header.flags);
+    REQUIRE(headerResult.key == header.key);
+    REQUIRE(headerResult.cs.c() == 'c');
+    REQUIRE(headerResult.cs.d() == 4.5);
+    REQUIRE(cstructResult.l == 2);
+    REQUIRE(afterResult == 7);
+
+    // same bytes as the default serializer
+    serializer::Bytes dynamicBytes;
+    serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+        dynamicBytes, 0, header, cstruct, after);
+    REQUIRE(dynamicBytes.size() == bytes.size());
+    REQUIRE(std::equal(bytes.begin(), bytes.end(), dynamicBytes.data()));
+
+    SECTION("indexed objects") {
+        // number of members and offset table
+        static_assert(static_serialized_size_v<FixedIndexed> == 4 + 2 * 4 + 8);
+        FixedIndexed indexed{1, 2}, indexedResult;
+        REQUIRE(serializer::serializedSize(indexed) ==
+                static_serialized_size_v<FixedIndexed>);
+
+        // the guard bytes after the array are not overwritten
+        struct {
+            serializer::fixed_bytes_t<FixedIndexed> bytes;
+            std::array<std::byte, 16> guard;
+        } buffer;
+        buffer.guard.fill(std::byte(0xAB));
+        REQUIRE(serializer::serializeFixed(buffer.bytes, indexed) ==
+                buffer.bytes.size());
+        for (std::byte guard : buffer.guard) {
+            REQUIRE(guard == std::byte(0xAB));
+        }
+        REQUIRE(serializer::deserializeFixed(buffer.bytes, indexedResult) ==
+                buffer.bytes.size());
+        REQUIRE(indexedResult.a == 1);
+        REQUIRE(indexedResult.b == 2);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                                 lazy view                                  */
+/******************************************************************************/
+
+#ifdef TEST_LAZY_VIEW
+#include "test-classes/hedgehog.hpp"
+#include "test-classes/simple.hpp"
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+struct ViewRecord {
+    int id = 0;
+    double score = 0;
+    std::vector<int> values;
+    std::string name;
+    std::map<int, std::string> tags;
+    std::list<short> shorts;
+    Simple simple;
+    long tail = 0;
+
+    SERIALIZE(id, score, values, name, tags, shorts, simple, tail);
+};
+
+TEST_CASE("lazy view") {
+    serializer::Bytes bytes;
+
+    SECTION("record") {
+        ViewRecord record;
+        record.id = 42;
+        record.score = 3.5;
+        record.values = {1, 2, 3};
+        record.name = "record";
+        record.tags = {{1, "one"}, {2, "two"}};
+        record.shorts = {4, 5};
+        record.simple = Simple(1, 2, "hello");
+        record.tail = 7;
+
+        size_t pos = serializer::serialize<
+            serializer::Serializer<serializer::Bytes>>(bytes, 0, 1234);
+        size_t end = serializer::serialize<
+            serializer::Serializer<serializer::Bytes>>(bytes, pos, record);
+
+        serializer::Bytes const &cbytes = bytes;
+        serializer::View<ViewRecord> view(cbytes, pos);
+        static_assert(decltype(view)::nb_members == 8);
+        REQUIRE(view.offset<0>() == pos);
+        REQUIRE(view.offset<2>() == pos + sizeof(int) + sizeof(double));
+        REQUIRE(view.get<0>() == 42);
+        REQUIRE(view.get<1>() == 3.5);
+        REQUIRE(view.get<7>() == 7);
+        REQUIRE(view.get<2>() == record.values);
+        REQUIRE(view.get<3>() == record.name);
+        REQUIRE(view.get<4>() == record.tags);
+        REQUIRE(view.get<5>() == record.shorts);
+        REQUIRE(view.get<6>() == record.simple);
+        REQUIRE(view.end() == end);
+    }
+
+    SECTION("type table") {
+        double data[16] = {0};
+        MatrixBlock<double, Input> block(1, 2, 4, 4, 2, 16, data);
+        size_t end = block.serialize(bytes);
+
+        serializer::Bytes const &cbytes = bytes;
+        serializer::View<MatrixBlock<double, Input>,
+                         HHSerializer<double, serializer::Bytes const>>
+            view(cbytes);
+        REQUIRE(view.offset<0>() == sizeof(HHSerializer<double>::id_type));
+        REQUIRE(view.get<0>() == 1);
+        REQUIRE(view.get<1>() == 2);
+        REQUIRE(view.get<4>() == 2);
+        REQUIRE(view.get<5>() == 16);
+        // the dynamic array only follows fixed size members
+        REQUIRE(view.offset<6>() == view.offset<5>() + sizeof(size_t));
+        REQUIRE(view.offset<6>() + 16 * sizeof(double) <= end);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                                  indexed                                   */
+/******************************************************************************/
+
+#ifdef TEST_INDEXED
+#include <map>
+#include <string>
+#include <vector>
+struct IndexedV1 {
+    std::map<int, std::string> tags;
+    std::vector<int> values;
+    int id = 0;
+
+    SERIALIZE_INDEXED(tags, values, id);
+};
+
+struct IndexedV2 {
+    std::map<int, std::string> tags;
+    std::vector<int> values;
+    int id = 0;
+    std::string extra = "default";
+
+    SERIALIZE_INDEXED(tags, values, id, extra);
+};
+
+TEST_CASE("serialization with an offset index") {
+    serializer::Bytes bytes;
+    IndexedV2 v2;
+    v2.tags = {{1, "one"}, {2, "two"}};
+    v2.values = std::vector<int>(100, 3);
+    v2.id = 42;
+    v2.extra = "extra";
+
+    SECTION("same schema") {
+        IndexedV2 result;
+        size_t end = v2.serialize(bytes);
+        REQUIRE(end == bytes.size());
+        REQUIRE(result.deserialize(bytes) == end);
+        REQUIRE(result.tags == v2.tags);
+        REQUIRE(result.values == v2.values);
+        REQUIRE(result.id == 42);
+        REQUIRE(result.extra == "extra");
+    }
+
+    SECTION("schema evolution") {
+        // new data read by an old reader: the extra member is skipped
+        IndexedV1 v1;
+        std::vector<IndexedV2> v2s = {v2, v2};
+        std::vector<IndexedV1> v1s;
+        size_t end = serializer::serialize<
+            serializer::Serializer<serializer::Bytes>>(bytes, 0, v2s, 7);
+        int after = 0;
+        REQUIRE(serializer::deserialize<
+                    serializer::Serializer<serializer::Bytes>>(
+                    bytes, 0, v1s, after) == end);
+        REQUIRE(v1s.size() == 2);
+        REQUIRE(v1s[1].tags == v2.tags);
+        REQUIRE(v1s[1].id == 42);
+        REQUIRE(after == 7);
+
+        // old data read by a new reader: the missing member is not modified
+        IndexedV2 result;
+        end = v1s[0].serialize(bytes);
+        REQUIRE(result.deserialize(bytes) == end);
+        REQUIRE(result.values == v2.values);
+        REQUIRE(result.id == 42);
+        REQUIRE(result.extra == "default");
+    }
+
+    SECTION("view") {
+        size_t pos = serializer::serialize<
+            serializer::Serializer<serializer::Bytes>>(bytes, 0, 1234);
+        size_t end = v2.serialize(bytes, pos);
+        serializer::Bytes const &cbytes = bytes;
+        serializer::View<IndexedV2> view(cbytes, pos);
+        REQUIRE(view.get<2>() == 42);
+        REQUIRE(view.get<3>() == "extra");
+        REQUIRE(view.get<0>() == v2.tags);
+        REQUIRE(view.end() == end);
+
+        // old data
+        IndexedV1 v1;
+        v1.id = 3;
+        end = v1.serialize(bytes, pos);
+        serializer::View<IndexedV2> oldView(cbytes, pos);
+        REQUIRE(oldView.get<2>() == 3);
+        REQUIRE(oldView.end() == end);
+        REQUIRE_THROWS_AS(oldView.get<3>(), std::out_of_range);
+    }
+
+    SECTION("pre-size pass") {
+        IndexedV1 v1, result;
+        v1.values = v2.values;
+        v1.id = 5;
+        size_t end = v1.serialize(bytes);
+        REQUIRE(serializer::serializedSize(v1) == end);
+
+        serializer::Bytes exact;
+        REQUIRE(serializer::serializeExact(exact, 0, v1) == end);
+        REQUIRE(exact.size() == end);
+        REQUIRE(std::memcmp(exact.data(), bytes.data(), end) == 0);
+        REQUIRE(result.deserialize(exact) == end);
+        REQUIRE(result.values == v1.values);
+        REQUIRE(result.id == 5);
+    }
+
+    SECTION("fixed byte order") {
+        serializer::tools::Endian<serializer::Bytes, std::endian::big> big(
+            bytes);
+        IndexedV2 result;
+        size_t end = v2.serialize(big);
+        REQUIRE(result.deserialize(big) == end);
+        REQUIRE(result.values == v2.values);
+        REQUIRE(result.extra == "extra");
+    }
+}
+#endif
+
+#ifdef TEST_INCREMENTAL
+#include <map>
+#include <string>
+#include <vector>
+struct IncrementalMessage {
+    std::string name;
+    std::vector<double> values;
+    std::map<int, std::string> tags;
+    size_t size = 0;
+    int *data = nullptr;
+    IndexedV2 indexed;
+
+    IncrementalMessage() = default;
+    IncrementalMessage(IncrementalMessage const &) = delete;
+    ~IncrementalMessage() { delete[] data; }
+
+    SERIALIZE(name, values, tags, size, SER_DARR(data, size), indexed);
+};
+
+struct IncrementalIndexed {
+    int a = 0, b = 0;
+
+    SERIALIZE_INDEXED(a, b);
+};
+
+TEST_CASE("incremental deserialization") {
+    using Buffer = serializer::tools::IncrementalBuffer<>;
+    serializer::Bytes bytes;
+    IncrementalMessage msg;
+    msg.name = "incremental message";
+    msg.values = std::vector<double>(1000, 3.5);
+    msg.tags = {{1, "one"}, {2, "two"}, {3, "three"}};
+    msg.size = 500;
+    msg.data = new int[msg.size];
+    for (size_t i = 0; i < msg.size; ++i) {
+        msg.data[i] = int(i);
+    }
+    msg.indexed.extra = "extra";
+    msg.indexed.id = 42;
+    size_t end = serializer::serialize<
+        serializer::Serializer<serializer::Bytes>>(bytes, 0, msg, 7);
+
+    auto feed = [&](Buffer &buffer, size_t chunk) {
+        for (size_t pos = 0; pos < bytes.size(); pos += chunk) {
+            buffer.feed(bytes.data() + pos,
+                        std::min(chunk, bytes.size() - pos));
+        }
+    };
+
+    for (size_t chunk : {size_t(1), size_t(7), size_t(4096)}) {
+        Buffer buffer;
+        IncrementalMessage result;
+        int after = 0;
+        auto task =
+            serializer::tools::deserializeIncremental(buffer, 0, result, after);
+        REQUIRE(!task.done());
+        REQUIRE_THROWS_AS(task.result(), std::logic_error);
+        feed(buffer, chunk);
+        REQUIRE(task.done());
+        REQUIRE(task.result() == end);
+        REQUIRE(result.name == msg.name);
+        REQUIRE(result.values == msg.values);
+        REQUIRE(result.tags == msg.tags);
+        REQUIRE(result.size == msg.size);
+        REQUIRE(std::equal(result.data, result.data + result.size, msg.data));
+        REQUIRE(result.indexed.extra == "extra");
+        REQUIRE(result.indexed.id == 42);
+        REQUIRE(after == 7);
+    }
+
+    SECTION("already received") {
+        Buffer buffer;
+        IncrementalMessage result;
+        feed(buffer, 4096);
+        auto task = serializer::tools::deserializeIncremental(buffer, 0, result);
+        REQUIRE(task.done());
+        REQUIRE(task.result() < end);
+        REQUIRE(result.values == msg.values);
+    }
+
+    SECTION("truncated data") {
+        Buffer buffer;
+        IncrementalMessage result;
+        auto task = serializer::tools::deserializeIncremental(buffer, 0, result);
+        buffer.feed(bytes.data(), bytes.size() / 2);
+        REQUIRE(!task.done());
+        buffer.finish();
+        REQUIRE(task.done());
+        REQUIRE_THROWS_AS(task.result(), std::out_of_range);
+        REQUIRE_THROWS_AS(buffer.feed(bytes.data(), 1), std::logic_error);
+    }
+
+    SECTION("fixed size indexed object") {
+        Buffer buffer;
+        IncrementalIndexed indexed{1, 2}, result;
+        size_t size = serializer::serialize<
+            serializer::Serializer<serializer::Bytes>>(bytes, 0, indexed);
+        auto task = serializer::tools::deserializeIncremental(buffer, 0, result);
+        buffer.feed(bytes.data(), size / 2);
+        REQUIRE(!task.done());
+        buffer.feed(bytes.data() + size / 2, size - size / 2);
+        REQUIRE(task.done());
+        REQUIRE(task.result() == size);
+        REQUIRE(result.a == 1);
+        REQUIRE(result.b == 2);
+    }
+}
+#endif
+
+#ifdef TEST_CHANNEL
+#include "serializer/tools/channel.hpp"
+#include "test-classes/hedgehog.hpp"
+#include <sys/socket.h>
+TEST_CASE("async channel") {
+    using Channel = serializer::tools::AsyncChannel<TypeTable<double>>;
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    std::vector<double> data(256 * 256);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = double(i);
+    }
+
+    {
+        Channel sender(fds[0], 4096);
+        Channel receiver(fds[1], 4096);
+        size_t nbSums = 0, nbBlocks = 0;
+        double sum = 0;
+        auto handler = [&]<typename T>(std::shared_ptr<T> obj) {
+            if constexpr (std::is_same_v<T, PartialSum<double>>) {
+                sum += obj->value;
+                ++nbSums;
+            } else if constexpr (std::is_same_v<T,
+                                                MatrixBlock<double, Input>>) {
+                REQUIRE(obj->data()[255 * 256 + 255] ==
+                        double(255 * 256 + 255));
+                delete[] obj->data();
+                ++nbBlocks;
+            }
+        };
+
+        // the pooled buffers are reused once written
+        for (size_t i = 0; i < 1000; ++i) {
+            sender.send(PartialSum<double>{double(i)});
+        }
+        for (size_t i = 0; i < 10; ++i) {
+            sender.send(MatrixBlock<double, Input>(0, 0, 256, 256, 256,
+                                                   data.size(), data.data()));
+        }
+
+        // several records in one buffer
+        auto lease = sender.pool().acquire();
+        serializer::tools::BatchWriter<TypeTable<double>> batch(*lease);
+        for (size_t i = 0; i < 100; ++i) {
+            batch.write(PartialSum<double>{1});
+        }
+        sender.submit(lease.release());
+        sender.flush();
+        REQUIRE(sender.pool().size() > 0);
+
+        while (nbSums + nbBlocks < 1110) {
+            receiver.dispatch(handler);
+        }
+        REQUIRE(nbSums == 1100);
+        REQUIRE(nbBlocks == 10);
+        REQUIRE(sum == 499500 + 100);
+        REQUIRE(receiver.tryDispatch(handler) == 0);
+
+        // end of the connection
+        shutdown(fds[0], SHUT_WR);
+        while (!receiver.closed()) {
+            REQUIRE(receiver.dispatch(handler) == 0);
+        }
+    }
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif
+
+#ifdef TEST_SCATTER_GATHER
+#include "serializer/tools/scatter_gather.hpp"
+#include "test-classes/hedgehog.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+TEST_CASE("scatter gather output") {
+    std::vector<double> data(256 * 256);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = double(i);
+    }
+    Matrix<double> matrix(256, 256, 16, data.data());
+    std::vector<int> values(2000, 7);
+    std::string small = "small string";
+    serializer::Bytes expected;
+    size_t end = serializer::serialize<
+        serializer::Serializer<serializer::Bytes>>(expected, 0, matrix, values,
+                                                   small);
+    serializer::tools::ScatterGather<> sg;
+    REQUIRE(serializer::serialize<
+                serializer::Serializer<serializer::tools::ScatterGather<>>>(
+                sg, 0, matrix, values, small) == end);
+    REQUIRE(sg.size() == end);
+
+    // the large blocks are referenced, not copied
+    auto const &iovecs = sg.iovecs();
+    REQUIRE(sg.staged() < 256);
+    REQUIRE(std::any_of(iovecs.begin(), iovecs.end(), [&](iovec const &iov) {
+        return iov.iov_base == data.data() &&
+               iov.iov_len == data.size() * sizeof(double);
+    }));
+    REQUIRE(std::any_of(iovecs.begin(), iovecs.end(), [&](iovec const &iov) {
+        return iov.iov_base == values.data();
+    }));
+    REQUIRE(sg.vector() == expected.vector());
+    REQUIRE_THROWS_AS(sg.append(0, expected.data(), 1), std::logic_error);
+
+    SECTION("writev") {
+        FILE *file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        sg.writeTo(fileno(file));
+        std::rewind(file);
+        serializer::Bytes bytes(end);
+        bytes.resize(std::fread(bytes.data(), 1, end, file));
+        std::fclose(file);
+        REQUIRE(bytes.size() == end);
+
+        Matrix<double> result;
+        std::vector<int> resultValues;
+        std::string resultSmall;
+        serializer::deserialize<serializer::Serializer<serializer::Bytes>>(
+            bytes, 0, result, resultValues, resultSmall);
+        REQUIRE(std::equal(data.begin(), data.end(), result.data()));
+        REQUIRE(resultValues == values);
+        REQUIRE(resultSmall == small);
+        delete[] result.data();
+    }
+
+    SECTION("byte swapped") {
+        // the swapped values are copied
+        serializer::tools::ScatterGather<> other;
+        serializer::tools::Endian<serializer::tools::ScatterGather<>,
+                                  std::endian::big>
+            big(other);
+        serializer::serialize<serializer::Serializer<decltype(big)>>(big, 0,
+                                                                     values);
+        REQUIRE(other.staged() == other.size());
+    }
+}
+#endif
+
+#ifdef TEST_BITWISE
+#include "serializer/tools/scatter_gather.hpp"
+#include <array>
+#include <vector>
+struct BitwisePoint {
+    double x = 0;
+    double y = 0;
+    int tag = 0;
+
+    SERIALIZE_STRUCT();
+
+    bool operator==(BitwisePoint const &) const = default;
+};
+
+TEST_CASE("bulk copy of the bitwise serializable objects") {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    static_assert(Ser::is_bitwise_v<BitwisePoint>);
+    static_assert(!Ser::is_bitwise_v<int>);
+    serializer::Bytes bytes;
+    std::vector<BitwisePoint> points(1000);
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i] = BitwisePoint{double(i), -double(i), int(i)};
+    }
+    std::array<BitwisePoint, 4> array = {points[1], points[2], points[3]};
+    BitwisePoint staticArray[3] = {points[4], points[5], points[6]};
+    size_t size = 10;
+    BitwisePoint *dynamicArray = points.data() + 10;
+
+    size_t end = serializer::serialize<Ser>(bytes, 0, points, array,
+                                            staticArray,
+                                            SER_DARR(dynamicArray, size));
+
+    // same layout as the element by element serialization
+    serializer::Bytes expected;
+    size_t pos = serializer::serialize<Ser>(expected, 0, points.size());
+    for (auto const &point : points) {
+        pos = point.serialize(expected, pos);
+    }
+    REQUIRE(std::memcmp(bytes.data(), expected.data(), pos) == 0);
+
+    std::vector<BitwisePoint> resultPoints;
+    std::array<BitwisePoint, 4> resultArray;
+    BitwisePoint resultStaticArray[3];
+    BitwisePoint *resultDynamicArray = nullptr;
+    REQUIRE(serializer::deserialize<Ser>(bytes, 0, resultPoints, resultArray,
+                                         resultStaticArray,
+                                         SER_DARR(resultDynamicArray, size)) ==
+            end);
+    REQUIRE(resultPoints == points);
+    REQUIRE(resultArray == array);
+    REQUIRE(std::equal(staticArray, staticArray + 3, resultStaticArray));
+    REQUIRE(std::equal(dynamicArray, dynamicArray + size, resultDynamicArray));
+    delete[] resultDynamicArray;
+
+    SECTION("one block") {
+        serializer::tools::ScatterGather<> sg;
+        serializer::serialize<
+            serializer::Serializer<serializer::tools::ScatterGather<>>>(
+            sg, 0, points);
+        REQUIRE(sg.iovecs().size() == 2);
+        REQUIRE(sg.iovecs()[1].iov_base == points.data());
+    }
+
+    SECTION("verified") {
+        serializer::tools::Verified<serializer::Bytes> verified(bytes);
+        resultPoints.clear();
+        serializer::deserialize<serializer::Serializer<decltype(verified)>>(
+            verified, 0, resultPoints);
+        REQUIRE(resultPoints == points);
+        bytes.resize(100);
+        REQUIRE_THROWS_AS(
+            serializer::deserialize<serializer::Serializer<decltype(verified)>>(
+                verified, 0, resultPoints),
+            serializer::exceptions::CorruptedDataError);
+    }
+}
+#endif
+
+#ifdef TEST_COLUMNAR
+#include <string>
+#include <vector>
+struct ColumnRow {
+    int id = 0;
+    double value = 0;
+    std::string name;
+    float weight = 0;
+
+    SERIALIZE(id, value, name, weight);
+
+    bool operator==(ColumnRow const &) const = default;
+};
+
+struct ColumnTable {
+    std::vector<ColumnRow> rows;
+
+    SERIALIZE(SER_COLUMNS(rows));
+};
+
+TEST_CASE("columnar containers") {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    serializer::Bytes bytes;
+    ColumnTable table, result;
+    for (int i = 0; i < 3000; ++i) {
+        table.rows.push_back(ColumnRow{i, i * 0.5, std::to_string(i),
+                                       float(i) * 2});
+    }
+    size_t end = table.serialize(bytes);
+    REQUIRE(result.deserialize(bytes) == end);
+    REQUIRE(result.rows == table.rows);
+
+    // the first column is stored contiguously after the size
+    std::vector<int> ids(table.rows.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ids[i] = table.rows[i].id;
+    }
+    REQUIRE(std::memcmp(bytes.data() + sizeof(size_t), ids.data(),
+                        ids.size() * sizeof(int)) == 0);
+
+    SECTION("single column") {
+        std::vector<float> weights;
+        std::vector<double> values;
+        REQUIRE(serializer::deserializeColumn<Ser, ColumnRow, 3>(
+                    bytes, 0, weights) == end);
+        serializer::deserializeColumn<Ser, ColumnRow, 1>(bytes, 0, values);
+        REQUIRE(weights.size() == 3000);
+        REQUIRE(weights[2999] == 5998);
+        REQUIRE(values[10] == 5);
+    }
+
+    SECTION("wrappers") {
+        serializer::tools::Compact<serializer::Bytes> compact(bytes);
+        ColumnTable other;
+        end = table.serialize(compact);
+        REQUIRE(end < result.rows.size() * sizeof(ColumnRow));
+        REQUIRE(other.deserialize(compact) == end);
+        REQUIRE(other.rows == table.rows);
+
+        serializer::tools::Endian<serializer::Bytes, std::endian::big> big(
+            bytes);
+        ColumnTable swapped;
+        end = table.serialize(big);
+        REQUIRE(swapped.deserialize(big) == end);
+        REQUIRE(swapped.rows == table.rows);
+    }
+
+    SECTION("empty") {
+        ColumnTable empty;
+        end = empty.serialize(bytes);
+        REQUIRE(end == sizeof(size_t));
+        REQUIRE(result.deserialize(bytes) == end);
+        REQUIRE(result.rows.empty());
+    }
+}
+#endif
+
+#ifdef TEST_INSTRUMENTATION
+#include "test-classes/hedgehog.hpp"
+#include <algorithm>
+#include <string>
+#include <typeinfo>
+#include <vector>
+TEST_CASE("instrumentation") {
+    using Mem = serializer::tools::Instrumented<serializer::Bytes>;
+    using Ser = serializer::Serializer<Mem, TypeTable<double>>;
+    using serializer::tools::Phases;
+    serializer::Bytes bytes;
+    Mem mem(bytes);
+    std::vector<int> values(1000, 3), otherValues;
+    std::string str = "hello", otherStr;
+    auto *sum = new PartialSum<double>{4.5};
+    PartialSum<double> otherSum;
+
+    auto counters = [](auto const &snapshot, Phases phase,
+                       std::type_info const &type) {
+        auto it = std::find_if(snapshot.types.begin(), snapshot.types.end(),
+                               [&](auto const &entry) {
+                                   return entry.phase == phase &&
+                                          entry.type == type.name();
+                               });
+        REQUIRE(it != snapshot.types.end());
+        return it->counters;
+    };
+
+    size_t end = serializer::serialize<Ser>(mem, 0, values, str, sum);
+    serializer::serialize<Ser>(mem, 0, values, str, sum);
+    REQUIRE(serializer::deserialize<Ser>(mem, 0, otherValues, otherStr,
+                                         otherSum) == end);
+    REQUIRE(otherValues == values);
+    REQUIRE(otherStr == str);
+    REQUIRE(otherSum.value == 4.5);
+
+    auto snapshot = mem.instrumentation().snapshot();
+    auto vec = counters(snapshot, Phases::Serialization,
+                        typeid(std::vector<int>));
+    REQUIRE(vec.calls == 2);
+    REQUIRE(vec.bytes == 2 * (sizeof(size_t) + 1000 * sizeof(int)));
+    auto read =
+        counters(snapshot, Phases::Deserialization, typeid(std::string));
+    REQUIRE(read.calls == 1);
+    REQUIRE(read.bytes == sizeof(size_t) + 5);
+
+    // the objects of the type table are counted per id (the dynamic type is
+    // used for the pointers)
+    size_t id =
+        serializer::tools::getId<PartialSum<double>>(TypeTable<double>());
+    REQUIRE(snapshot.ids.size() == 2);
+    for (auto const &entry : snapshot.ids) {
+        REQUIRE(entry.id == id);
+        REQUIRE(entry.counters.calls == (entry.phase == Phases::Serialization
+                                             ? 2
+                                             : 1));
+        REQUIRE(entry.counters.bytes ==
+                entry.counters.calls * (sizeof(uint8_t) + sizeof(double)));
+    }
+    REQUIRE(snapshot.reallocations > 0);
+
+    mem.instrumentation().clear();
+    snapshot = mem.instrumentation().snapshot();
+    REQUIRE(snapshot.types.empty());
+    REQUIRE(snapshot.ids.empty());
+    REQUIRE(snapshot.reallocations == 0);
+
+    delete sum;
+}
+#endif
+
+#ifdef TEST_LARGE_BYTES
+#include "serializer/tools/large_bytes.hpp"
+#include <vector>
+TEST_CASE("large bytes") {
+    using Mem = serializer::tools::LargeBytes<std::byte>;
+    using Ser = serializer::Serializer<Mem>;
+    Mem mem;
+    std::vector<int> values(100000), other;
+    std::string str = "large bytes", otherStr;
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = int(i);
+    }
+
+    // the mapping grows from one page
+    size_t end = serializer::serialize<Ser>(mem, 0, str, values);
+    REQUIRE(mem.size() == end);
+    REQUIRE(mem.capacity() >= end);
+    REQUIRE(mem.capacity() % size_t(sysconf(_SC_PAGESIZE)) == 0);
+    REQUIRE(serializer::deserialize<Ser>(mem, 0, otherStr, other) == end);
+    REQUIRE(otherStr == str);
+    REQUIRE(other == values);
+
+    SECTION("growth keeps the content") {
+        std::vector<std::byte> before = mem.vector();
+        mem.reserve(64 * mem.capacity());
+        REQUIRE(mem.size() == end);
+        REQUIRE(mem.vector() == before);
+        mem.resize(end + 10);
+        REQUIRE(mem.size() == end + 10);
+    }
+
+    SECTION("move") {
+        Mem moved(std::move(mem));
+        REQUIRE(mem.data() == nullptr);
+        REQUIRE(mem.capacity() == 0);
+        REQUIRE(moved.size() == end);
+        other.clear();
+        serializer::deserialize<Ser>(moved, 0, otherStr, other);
+        REQUIRE(other == values);
+    }
+
+    SECTION("capacity") {
+        Mem empty(1);
+        REQUIRE(empty.capacity() == size_t(sysconf(_SC_PAGESIZE)));
+        REQUIRE(empty.size() == 0);
+        REQUIRE(empty.vector().empty());
+    }
+}
+#endif
+
+#ifdef TEST_SMALL_BYTES
+#include "test-classes/hedgehog.hpp"
+TEST_CASE("small bytes") {
+    using Small = serializer::SmallBytes<32>;
+    static_assert(serializer::mtf::is_serializer_bytes_v<Small>);
+    Small bytes;
+    PartialSum<double> sum{4.5}, other;
+
+    // the small messages are stored inside the object
+    REQUIRE(bytes.isInline());
+    REQUIRE(bytes.capacity() == 32);
+    size_t end = sum.serialize(bytes);
+    REQUIRE(bytes.isInline());
+    REQUIRE(other.deserialize(bytes) == end);
+    REQUIRE(other.value == 4.5);
+
+    SECTION("copy and move") {
+        Small copy(bytes);
+        REQUIRE(copy.isInline());
+        REQUIRE(copy.vector() == bytes.vector());
+        Small moved(std::move(copy));
+        REQUIRE(moved.isInline());
+        REQUIRE(moved.vector() == bytes.vector());
+        REQUIRE(copy.size() == 0);
+
+        Small large;
+        large.resize(100);
+        REQUIRE(!large.isInline());
+        large = std::move(moved);
+        REQUIRE(large.vector() == bytes.vector());
+        moved = Small(200);
+        REQUIRE(!moved.isInline());
+        REQUIRE(moved.capacity() == 200);
+
+        // buffer smaller than the inline bytes
+        Small external(new std::byte[4], 4), source(bytes);
+        REQUIRE(source.size() > 4);
+        external = std::move(source);
+        REQUIRE(external.isInline());
+        REQUIRE(external.vector() == bytes.vector());
+    }
+
+    SECTION("spill to the heap") {
+        std::vector<int> values(100, 7), otherValues;
+        end = serializer::serialize<serializer::Serializer<Small>>(bytes, 0,
+                                                                    values);
+        REQUIRE(!bytes.isInline());
+        REQUIRE(bytes.capacity() >= end);
+        serializer::deserialize<serializer::Serializer<Small>>(bytes, 0,
+                                                               otherValues);
+        REQUIRE(otherValues == values);
+        Small moved(std::move(bytes));
+        REQUIRE(!moved.isInline());
+        REQUIRE(bytes.isInline());
+        REQUIRE(bytes.capacity() == 32);
+    }
+}
+#endif
+
+#ifdef TEST_REUSE
+#include <memory>
+#include <string>
+#include <vector>
+struct ReuseBase;
+struct ReuseInt;
+struct ReuseString;
+using ReuseTable =
+    serializer::tools::TypeTable<ReuseBase, ReuseInt, ReuseString>;
+using ReuseSerializer =
+    serializer::Serializer<serializer::tools::Reuse<serializer::Bytes>,
+                           ReuseTable>;
+
+struct ReuseBase {
+    virtual ~ReuseBase() = default;
+    SERIALIZE_ABSTRACT(ReuseSerializer);
+};
+
+struct ReuseInt : ReuseBase {
+    explicit ReuseInt(int value = 0) : value(value) {}
+    int value;
+    SERIALIZE_OVERRIDE(ReuseSerializer, serializer::tools::getId<ReuseInt>(
+                                            ReuseTable()),
+                       value);
+};
+
+struct ReuseString : ReuseBase {
+    explicit ReuseString(std::string value = "") : value(std::move(value)) {}
+    std::string value;
+    SERIALIZE_OVERRIDE(ReuseSerializer, serializer::tools::getId<ReuseString>(
+                                            ReuseTable()),
+                       value);
+};
+
+TEST_CASE("reuse the destination objects") {
+    serializer::Bytes bytes;
+    serializer::tools::Reuse<serializer::Bytes> mem(bytes);
+    std::vector<std::unique_ptr<ReuseBase>> elts, result;
+    std::shared_ptr<std::vector<int>> shared, sharedResult;
+    std::string str = "reused string", strResult;
+
+    elts.push_back(std::make_unique<ReuseInt>(1));
+    elts.push_back(std::make_unique<ReuseString>("a"));
+    shared = std::make_shared<std::vector<int>>(100, 3);
+
+    serializer::serialize<ReuseSerializer>(mem, 0, elts, shared, str);
+    serializer::deserialize<ReuseSerializer>(mem, 0, result, sharedResult,
+                                             strResult);
+    REQUIRE(static_cast<ReuseInt *>(result[0].get())->value == 1);
+    REQUIRE(static_cast<ReuseString *>(result[1].get())->value == "a");
+    REQUIRE(*sharedResult == *shared);
+    REQUIRE(strResult == str);
+
+    ReuseBase *first = result[0].get();
+    ReuseBase *second = result[1].get();
+    std::vector<int> *vec = sharedResult.get();
+    int const *vecData = sharedResult->data();
+    char const *strData = strResult.data();
+
+    SECTION("same types") {
+        static_cast<ReuseInt *>(elts[0].get())->value = 2;
+        static_cast<ReuseString *>(elts[1].get())->value = "b";
+        (*shared)[0] = 4;
+        str = "reused";
+        serializer::serialize<ReuseSerializer>(mem, 0, elts, shared, str);
+        serializer::deserialize<ReuseSerializer>(mem, 0, result, sharedResult,
+                                                 strResult);
+        REQUIRE(result[0].get() == first);
+        REQUIRE(result[1].get() == second);
+        REQUIRE(sharedResult.get() == vec);
+        REQUIRE(sharedResult->data() == vecData);
+        REQUIRE(strResult.data() == strData);
+        REQUIRE(static_cast<ReuseInt *>(result[0].get())->value == 2);
+        REQUIRE(static_cast<ReuseString *>(result[1].get())->value == "b");
+        REQUIRE((*sharedResult)[0] == 4);
+        REQUIRE(strResult == "reused");
+    }
+
+    SECTION("different types") {
+        std::swap(elts[0], elts[1]);
+        serializer::serialize<ReuseSerializer>(mem, 0, elts, shared, str);
+        serializer::deserialize<ReuseSerializer>(mem, 0, result, sharedResult,
+                                                 strResult);
+        REQUIRE(dynamic_cast<ReuseString *>(result[0].get()));
+        REQUIRE(dynamic_cast<ReuseInt *>(result[1].get()));
+        REQUIRE(static_cast<ReuseString *>(result[0].get())->value == "a");
+        REQUIRE(static_cast<ReuseInt *>(result[1].get())->value == 1);
+    }
+
+    SECTION("shared pointees are not reused") {
+        auto owner = sharedResult;
+        serializer::deserialize<ReuseSerializer>(mem, 0, result, sharedResult,
+                                                 strResult);
+        REQUIRE(sharedResult.get() != vec);
+        REQUIRE(*owner == *sharedResult);
+    }
+}
+#endif
+
+#ifdef TEST_STATIC_DISPATCH
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+struct Shape;
+struct Circle;
+struct Rectangle;
+using ShapeTable = serializer::tools::TypeTable<Shape, Circle, Rectangle>;
+
+struct Shape {
+    virtual ~Shape() = default;
+    virtual double area() const = 0;
+};
+
+struct Circle : Shape {
+    double radius = 0;
+    std::string name;
+    SERIALIZE_POLYMORPHIC(ShapeTable, radius, name);
+    double area() const override { return 3 * radius * radius; }
+};
+
+struct Rectangle : Shape {
+    double width = 0, height = 0;
+    std::shared_ptr<Shape> inner;
+    SERIALIZE_POLYMORPHIC(ShapeTable, width, height, inner);
+    double area() const override { return width * height; }
+};
+
+struct Untabled : Shape {
+    double area() const override { return 0; }
+};
+
+struct Marker;
+using MarkerTable = serializer::tools::TypeTable<Marker>;
+
+struct Marker {
+    int value = 0;
+    SERIALIZE_POLYMORPHIC(MarkerTable, value);
+};
+
+TEST_CASE("polymorphic types dispatched with the type table") {
+    std::vector<std::unique_ptr<Shape>> shapes, result;
+    auto circle = std::make_unique<Circle>();
+    circle->radius = 2;
+    circle->name = "circle";
+    auto rectangle = std::make_unique<Rectangle>();
+    rectangle->width = 3;
+    rectangle->height = 4;
+    rectangle->inner = std::make_shared<Circle>();
+    shapes.push_back(std::move(circle));
+    shapes.push_back(std::move(rectangle));
+
+    auto check = [&] {
+        REQUIRE(result.size() == 2);
+        REQUIRE(dynamic_cast<Circle *>(result[0].get()));
+        REQUIRE(dynamic_cast<Circle *>(result[0].get())->name == "circle");
+        REQUIRE(result[0]->area() == 12);
+        auto *rect = dynamic_cast<Rectangle *>(result[1].get());
+        REQUIRE(rect);
+        REQUIRE(rect->area() == 12);
+        REQUIRE(dynamic_cast<Circle *>(rect->inner.get()));
+    };
+
+    SECTION("bytes") {
+        using Ser = serializer::Serializer<serializer::Bytes, ShapeTable>;
+        serializer::Bytes bytes;
+        size_t end = serializer::serialize<Ser>(bytes, 0, shapes);
+        REQUIRE(serializer::deserialize<Ser>(bytes, 0, result) == end);
+        check();
+
+        // the same hierarchy can be measured without serializing it
+        using Measure =
+            serializer::Serializer<serializer::tools::Measure<std::byte>,
+                                   ShapeTable>;
+        REQUIRE(serializer::serializedSize<Measure>(shapes) == end);
+
+        // and serialized with one allocation
+        serializer::Bytes exact;
+        REQUIRE(serializer::serializeExact<Ser>(exact, 0, shapes) == end);
+        REQUIRE(exact.capacity() == end);
+        result.clear();
+        REQUIRE(serializer::deserialize<Ser>(exact, 0, result) == end);
+        check();
+    }
+
+    SECTION("other memory") {
+        using Mem = serializer::tools::Compact<serializer::Bytes, true>;
+        using Ser = serializer::Serializer<Mem, ShapeTable>;
+        serializer::Bytes bytes;
+        Mem mem(bytes);
+        size_t end = serializer::serialize<Ser>(mem, 0, shapes);
+        REQUIRE(serializer::deserialize<Ser>(mem, 0, result) == end);
+        check();
+    }
+
+    SECTION("unknown dynamic type") {
+        using Ser = serializer::Serializer<serializer::Bytes, ShapeTable>;
+        serializer::Bytes bytes;
+        std::unique_ptr<Shape> shape = std::make_unique<Untabled>();
+        REQUIRE_THROWS_AS(serializer::serialize<Ser>(bytes, 0, shape),
+                          std::logic_error);
+    }
+
+    SECTION("static size") {
+        // the id is serialized before the members
+        static_assert(serializer::mtf::static_serialized_size_v<Marker> ==
+                      sizeof(MarkerTable::id_type) + sizeof(int));
+        Marker marker{42}, markerResult;
+        REQUIRE(serializer::serializedSize(marker) ==
+                serializer::mtf::static_serialized_size_v<Marker>);
+
+        struct {
+            serializer::fixed_bytes_t<Marker> bytes;
+            std::array<std::byte, 8> guard;
+        } buffer;
+        buffer.guard.fill(std::byte(0xAB));
+        serializer::serializeFixed(buffer.bytes, marker);
+        for (std::byte guard : buffer.guard) {
+            REQUIRE(guard == std::byte(0xAB));
+        }
+        serializer::deserializeFixed(buffer.bytes, markerResult);
+        REQUIRE(markerResult.value == 42);
+
+        // the view skips the id of the table of the type
+        serializer::Bytes bytes;
+        marker.serialize(bytes);
+        serializer::tools::View<Marker> view(bytes);
+        REQUIRE(view.get<0>() == 42);
+        REQUIRE(view.end() == bytes.size());
+    }
+}
+#endif
+
+#ifdef TEST_CODEC
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+// external types that cannot be modified
+struct Temperature {
+    double celsius = 0;
+};
+
+class Label {
+  public:
+    Label() = default;
+    explicit Label(std::string text) : text_(std::move(text)) {}
+    std::string const &text() const { return text_; }
+    void text(std::string text) { text_ = std::move(text); }
+
+  private:
+    std::string text_;
+};
+
+// the temperatures are stored in tenths of degree
+template <> struct serializer::Codec<Temperature> {
+    static constexpr void serialize(auto &ser, Temperature const &t) {
+        ser.serialize_(int16_t(std::lround(t.celsius * 10)));
+    }
+    static constexpr void deserialize(auto &ser, Temperature &t) {
+        int16_t tenths = 0;
+        ser.deserialize_(tenths);
+        t.celsius = tenths / 10.;
+    }
+};
+
+template <> struct serializer::Codec<Label> {
+    static constexpr void serialize(auto &ser, Label const &label) {
+        ser.serialize_(label.text());
+    }
+    static constexpr void deserialize(auto &ser, Label &label) {
+        std::string text;
+        ser.deserialize_(text);
+        label.text(std::move(text));
+    }
+};
+
+struct WithCodecs {
+    std::vector<Temperature> temperatures;
+    Temperature array[2];
+    std::vector<Label> labels;
+    SERIALIZE(temperatures, array, labels);
+};
+
+TEST_CASE("codecs") {
+    serializer::Bytes bytes;
+    Temperature t1{21.5}, t2{-3.2}, r1, r2;
+
+    // the codec is used instead of copying the bytes of the trivial type
+    REQUIRE(serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+                bytes, 0, t1, t2) == 2 * sizeof(int16_t));
+    serializer::deserialize<serializer::Serializer<serializer::Bytes>>(
+        bytes, 0, r1, r2);
+    REQUIRE(r1.celsius == 21.5);
+    REQUIRE(r2.celsius == -3.2);
+    REQUIRE(serializer::mtf::static_serialized_size_v<Temperature> ==
+            serializer::mtf::dynamic_size);
+
+    WithCodecs original, other;
+    original.temperatures = {{1.5}, {2.5}, {-10}};
+    original.array[0].celsius = 4;
+    original.array[1].celsius = 5;
+    original.labels = {Label("a"), Label("label")};
+    size_t end = original.serialize(bytes);
+    REQUIRE(end == sizeof(size_t) + 5 * sizeof(int16_t) + sizeof(size_t) +
+                       2 * sizeof(size_t) + 6);
+    REQUIRE(other.deserialize(bytes) == end);
+    REQUIRE(other.temperatures.size() == 3);
+    REQUIRE(other.temperatures[2].celsius == -10);
+    REQUIRE(other.array[1].celsius == 5);
+    REQUIRE(other.labels.size() == 2);
+    REQUIRE(other.labels[1].text() == "label");
+}
+#endif
+
+/******************************************************************************/
+/*                             contiguous arrays                              */
+/******************************************************************************/
+
+#ifdef TEST_CONTIGUOUS_ARRAYS
+TEST_CASE("contiguous and strided arrays") {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    serializer::Bytes bytes;
+    size_t rows = 3, cols = 4;
+
+    // one allocation for the elements, one table for the rows
+    int *block = new int[rows * cols];
+    int **matrix = new int *[rows];
+    for (size_t i = 0; i < rows; ++i) {
+        matrix[i] = block + i * cols;
+        for (size_t j = 0; j < cols; ++j) {
+            matrix[i][j] = int(i * 10 + j);
+        }
+    }
+
+    size_t end = serializer::serialize<Ser>(
+        bytes, 0, SER_DARR_CONTIGUOUS(matrix, rows, cols));
+    REQUIRE(end == 1 + rows * cols * sizeof(int));
+
+    // same format as a flat dynamic array
+    int *flat = nullptr;
+    size_t size = rows * cols;
+    serializer::deserialize<Ser>(bytes, 0, SER_DARR(flat, size));
+    for (size_t i = 0; i < size; ++i) {
+        REQUIRE(flat[i] == block[i]);
+    }
+
+    // the tables are allocated when the pointer is null
+    int **result = nullptr;
+    REQUIRE(serializer::deserialize<Ser>(
+                bytes, 0, SER_DARR_CONTIGUOUS(result, rows, cols)) == end);
+    REQUIRE(result[1] == result[0] + cols);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            REQUIRE(result[i][j] == matrix[i][j]);
+        }
+    }
+
+    // 3D array
+    size_t d0 = 2, d1 = 3, d2 = 2;
+    int ***cube = nullptr;
+    int values[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    int *pvalues = values;
+    size_t nbValues = 12;
+    serializer::serialize<Ser>(bytes, 0, SER_DARR(pvalues, nbValues));
+    serializer::deserialize<Ser>(bytes, 0,
+                                 SER_DARR_CONTIGUOUS(cube, d0, d1, d2));
+    REQUIRE(cube[1][2][1] == 11);
+    REQUIRE(cube[1][0][0] == 6);
+    REQUIRE(cube[0][2][1] == 5);
+
+    // only the block is serialized
+    int *sub = matrix[1] + 1;
+    size_t subRows = 2, subCols = 2;
+    end = serializer::serialize<Ser>(bytes, 0,
+                                     SER_STRIDED(sub, subRows, subCols, cols));
+    REQUIRE(end == 1 + subRows * subCols * sizeof(int));
+    int *dense = nullptr;
+    serializer::deserialize<Ser>(bytes, 0, SER_DARR(dense, subRows, subCols));
+    REQUIRE(dense[0] == 11);
+    REQUIRE(dense[1] == 12);
+    REQUIRE(dense[2] == 21);
+    REQUIRE(dense[3] == 22);
+
+    // the block is scattered in the destination matrix
+    int target[12] = {};
+    int *ptarget = target + 1;
+    serializer::deserialize<Ser>(bytes, 0,
+                                 SER_STRIDED(ptarget, subRows, subCols, cols));
+    REQUIRE(target[0] == 0);
+    REQUIRE(target[1] == 11);
+    REQUIRE(target[2] == 12);
+    REQUIRE(target[3] == 0);
+    REQUIRE(target[5] == 21);
+    REQUIRE(target[6] == 22);
+
+    // non trivial elements
+    std::string *strings = new std::string[4]{"a", "b", "c", "d"};
+    std::string **table = new std::string *[2]{strings, strings + 2};
+    std::string **stringsResult = nullptr;
+    size_t two = 2;
+    serializer::serialize<Ser>(bytes, 0,
+                               SER_DARR_CONTIGUOUS(table, two, two));
+    serializer::deserialize<Ser>(
+        bytes, 0, SER_DARR_CONTIGUOUS(stringsResult, two, two));
+    REQUIRE(stringsResult[1][0] == "c");
+    REQUIRE(stringsResult[1][1] == "d");
+
+    delete[] result[0];
+    delete[] result;
+
+    // null pointer
+    int **null = nullptr;
+    REQUIRE(serializer::serialize<Ser>(
+                bytes, 0, SER_DARR_CONTIGUOUS(null, rows, cols)) == 1);
+    serializer::deserialize<Ser>(bytes, 0,
+                                 SER_DARR_CONTIGUOUS(result, rows, cols));
+    REQUIRE(result == nullptr);
+
+    delete[] stringsResult[0];
+    delete[] stringsResult;
+    delete[] strings;
+    delete[] table;
+    delete[] cube[0][0];
+    delete[] cube[0];
+    delete[] cube;
+    delete[] dense;
+    delete[] flat;
+    delete[] block;
+    delete[] matrix;
+}
+#endif
+
+/******************************************************************************/
+/*                              interned strings                              */
+/******************************************************************************/
+
+#ifdef TEST_INTERNED_STRINGS
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+TEST_CASE("interned strings") {
+    using Mem = serializer::tools::Interned<serializer::Bytes>;
+    using Ser = serializer::Serializer<Mem>;
+    serializer::Bytes bytes;
+    std::vector<std::string> tags = {"cpu", "gpu", "cpu", "cpu", "gpu"};
+    std::map<std::string, int> counters = {{"cpu", 3}, {"mem", 1}};
+    std::vector<std::string> tagsResult;
+    std::map<std::string, int> countersResult;
+
+    Mem sender(bytes);
+    size_t end = serializer::serialize<Ser>(sender, 0, tags, counters);
+    REQUIRE(sender.strings().size() == 3);
+    // 3 new strings (marker + size + bytes), 4 references (one byte)
+    REQUIRE(end == 2 * sizeof(size_t) + 3 * (1 + sizeof(size_t) + 3) + 4 +
+                       2 * sizeof(int));
+
+    Mem receiver(bytes);
+    REQUIRE(serializer::deserialize<Ser>(receiver, 0, tagsResult,
+                                         countersResult) == end);
+    REQUIRE(tagsResult == tags);
+    REQUIRE(countersResult == counters);
+
+    SECTION("persistent dictionary") {
+        // the strings of the previous message are only referenced
+        std::string_view view;
+        std::string cpu = "cpu";
+        end = serializer::serialize<Ser>(sender, 0, cpu, tags);
+        REQUIRE(end == 1 + sizeof(size_t) + tags.size());
+        REQUIRE(serializer::deserialize<Ser>(receiver, 0, view, tagsResult) ==
+                end);
+        REQUIRE(view == "cpu");
+        REQUIRE(view.data() == receiver.strings().get(0).data());
+        REQUIRE(tagsResult == tags);
+    }
+
+    SECTION("dictionary per message") {
+        sender.strings().clear();
+        receiver.strings().clear();
+        std::vector<std::string_view> views = {"disk", "disk"};
+        std::vector<std::string> result;
+        end = serializer::serialize<Ser>(sender, 0, views);
+        REQUIRE(end == sizeof(size_t) + 1 + sizeof(size_t) + 4 + 1);
+        serializer::deserialize<Ser>(receiver, 0, result);
+        REQUIRE(result == std::vector<std::string>{"disk", "disk"});
+    }
+
+    SECTION("compact sizes") {
+        using CompactMem = serializer::tools::Compact<Mem>;
+        using CompactSer = serializer::Serializer<CompactMem>;
+        Mem compactSender(bytes), compactReceiver(bytes);
+        CompactMem csender(compactSender), creceiver(compactReceiver);
+        end = serializer::serialize<CompactSer>(csender, 0, tags);
+        REQUIRE(end == 1 + 2 * (1 + 1 + 3) + 3);
+        serializer::deserialize<CompactSer>(creceiver, 0, tagsResult);
+        REQUIRE(tagsResult == tags);
+    }
+
+    SECTION("invalid reference") {
+        // the string is only referenced, the new receiver doesn't know it
+        std::string str;
+        Mem other(bytes);
+        REQUIRE(serializer::serialize<Ser>(sender, 0, tags[0]) == 1);
+        REQUIRE_THROWS_AS(serializer::deserialize<Ser>(other, 0, str),
+                          serializer::exceptions::CorruptedDataError);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                                shared ring                                 */
+/******************************************************************************/
+
+#ifdef TEST_SHARED_RING
+#include "serializer/tools/shared_ring.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+TEST_CASE("shared ring") {
+    using Ring = serializer::tools::SharedRing<std::byte>;
+    using WriteSer = serializer::Serializer<Ring::Slot>;
+    using ReadSer = serializer::Serializer<Ring::Message const>;
+
+    SECTION("in place serialization") {
+        Ring ring(1000);
+        REQUIRE(ring.capacity() == 1024);
+        REQUIRE(!ring.tryReceive());
+
+        std::string str = "shared memory", result;
+        std::vector<int> values = {1, 2, 3}, valuesResult;
+        Ring::Slot slot = ring.reserve(serializer::serializedSize(str, values));
+        size_t end = serializer::serialize<WriteSer>(slot, 0, str, values);
+        slot.commit(end);
+
+        Ring::Message message = ring.receive();
+        REQUIRE(message.size() == end);
+        REQUIRE(serializer::deserialize<ReadSer>(message, 0, result,
+                                                 valuesResult) == end);
+        REQUIRE(result == str);
+        REQUIRE(valuesResult == values);
+
+        // the views point into the ring
+        std::string_view view;
+        serializer::deserialize<ReadSer>(message, 0, view);
+        REQUIRE(view == str);
+        REQUIRE((void const *)view.data() ==
+                (void const *)(message.data() + sizeof(size_t)));
+        REQUIRE_THROWS_AS(ring.tryReceive(), std::logic_error);
+        message.release();
+        REQUIRE(!ring.tryReceive());
+    }
+
+    SECTION("wrap around and abandoned slots") {
+        Ring ring(256);
+        REQUIRE_THROWS_AS(ring.tryReserve(ring.capacity()), std::out_of_range);
+        {
+            // too small slot: the slot is abandoned during the unwinding
+            Ring::Slot slot = ring.reserve(4);
+            std::string str = "too long";
+            REQUIRE_THROWS_AS(serializer::serialize<WriteSer>(slot, 0, str),
+                              std::out_of_range);
+        }
+        REQUIRE(!ring.tryReceive());
+
+        for (int i = 0; i < 100; ++i) {
+            std::vector<int> values(size_t(i % 20), i), result;
+            Ring::Slot slot =
+                ring.tryReserve(serializer::serializedSize(values));
+            REQUIRE(slot);
+            slot.commit(serializer::serialize<WriteSer>(slot, 0, values));
+            Ring::Message message = ring.receive();
+            serializer::deserialize<ReadSer>(message, 0, result);
+            REQUIRE(result == values);
+        }
+
+    }
+
+    SECTION("largest messages in an empty ring") {
+        Ring ring(64);
+        REQUIRE(ring.maxMessageSize() == 16);
+        REQUIRE_THROWS_AS(ring.tryReserve(17), std::out_of_range);
+
+        for (size_t i = 0; i < 20; ++i) {
+            // the offset moves by 16 or 32 bytes, the largest messages need
+            // a padding record every other time
+            size_t size = i % 3 == 0 ? 0 : ring.maxMessageSize();
+            Ring::Slot slot = ring.tryReserve(size);
+            REQUIRE(slot);
+            std::memset(slot.data(), int(i), size);
+            slot.commit(size);
+            Ring::Message message = ring.receive();
+            REQUIRE(message.size() == size);
+            auto expected = [i](std::byte b) { return b == std::byte(i); };
+            REQUIRE(std::all_of(message.data(), message.data() + size,
+                                expected));
+            message.release();
+            REQUIRE(!ring.tryReceive());
+        }
+    }
+
+    SECTION("publication order") {
+        Ring ring(256);
+        Ring::Slot first = ring.tryReserve(100);
+        Ring::Slot second = ring.tryReserve(100);
+        REQUIRE(first);
+        REQUIRE(second);
+        REQUIRE(!ring.tryReserve(100)); // full
+        // the second message waits for the first one
+        std::thread thread([&second] { second.commit(0); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        REQUIRE(!ring.tryReceive());
+        first.commit(0);
+        thread.join();
+        REQUIRE(ring.receive().size() == 0);
+        REQUIRE(ring.receive().size() == 0);
+        REQUIRE(ring.tryReserve(100));
+    }
+
+    SECTION("concurrent producers") {
+        constexpr int nbProducers = 4;
+        constexpr int nbMessages = 2000;
+        Ring ring(4096);
+        std::vector<std::thread> producers;
+
+        for (int p = 0; p < nbProducers; ++p) {
+            producers.emplace_back([&ring, p] {
+                for (int i = 0; i < nbMessages; ++i) {
+                    std::string str(size_t(i % 50), char('a' + p));
+                    Ring::Slot slot =
+                        ring.reserve(serializer::serializedSize(p, i, str));
+                    slot.commit(
+                        serializer::serialize<WriteSer>(slot, 0, p, i, str));
+                }
+            });
+        }
+
+        std::vector<int> next(nbProducers, 0);
+        for (int n = 0; n < nbProducers * nbMessages; ++n) {
+            int p = 0, i = 0;
+            std::string str;
+            Ring::Message message = ring.receive();
+            serializer::deserialize<ReadSer>(message, 0, p, i, str);
+            REQUIRE(i == next[size_t(p)]++); // in order for each producer
+            REQUIRE(str == std::string(size_t(i % 50), char('a' + p)));
+        }
+        for (auto &producer : producers) {
+            producer.join();
+        }
+        REQUIRE(!ring.tryReceive());
+    }
+
+    SECTION("named ring") {
+        std::string name = "/serializer-test-" + std::to_string(::getpid());
+        Ring producer = Ring::create(name, 4096);
+        Ring consumer = Ring::open(name);
+        Ring::unlink(name);
+        REQUIRE(consumer.capacity() == 4096);
+        REQUIRE_THROWS_AS(Ring::open(name), std::system_error);
+
+        std::string str = "other mapping", result;
+        Ring::Slot slot = producer.reserve(serializer::serializedSize(str));
+        slot.commit(serializer::serialize<WriteSer>(slot, 0, str));
+        Ring::Message message = consumer.receive();
+        serializer::deserialize<ReadSer>(message, 0, result);
+        REQUIRE(result == str);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                                 dispatcher                                 */
+/******************************************************************************/
+
+#ifdef TEST_DISPATCHER
+#include "serializer/tools/dispatcher.hpp"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+struct DispatchValue;
+struct DispatchText;
+struct DispatchIgnored;
+using DispatchTable = serializer::tools::TypeTable<DispatchValue, DispatchText,
+                                                   DispatchIgnored>;
+
+struct DispatchValue {
+    int value = 0;
+    SERIALIZE(serializer::tools::getId<DispatchValue>(DispatchTable()), value);
+};
+
+struct DispatchText {
+    std::string text;
+    SERIALIZE(serializer::tools::getId<DispatchText>(DispatchTable()), text);
+};
+
+struct DispatchIgnored {
+    int value = 0;
+    SERIALIZE(serializer::tools::getId<DispatchIgnored>(DispatchTable()),
+              value);
+};
+
+template <typename... Fs> struct DispatchHandlers : Fs... {
+    using Fs::operator()...;
+};
+template <typename... Fs> DispatchHandlers(Fs...) -> DispatchHandlers<Fs...>;
+
+TEST_CASE("dispatcher") {
+    using Dispatcher = serializer::tools::Dispatcher<DispatchTable>;
+
+    SECTION("mpmc queue") {
+        serializer::tools::MpmcQueue<int> queue(3);
+        REQUIRE(queue.capacity() == 4);
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(queue.tryPush(i));
+        }
+        int value = 10;
+        REQUIRE(!queue.tryPush(value));
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(queue.tryPop(value));
+            REQUIRE(value == i);
+        }
+        REQUIRE(!queue.tryPop(value));
+
+        // concurrent producers and consumers
+        serializer::tools::MpmcQueue<int> shared(64);
+        std::atomic<long> sum = 0;
+        std::atomic<int> popped = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&shared] {
+                for (int i = 1; i <= 10000; ++i) {
+                    int v = i;
+                    while (!shared.tryPush(v)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+            threads.emplace_back([&] {
+                int v = 0;
+                while (popped.load() < 40000) {
+                    if (shared.tryPop(v)) {
+                        sum += v;
+                        ++popped;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        REQUIRE(sum == 4 * 10000L * 10001 / 2);
+    }
+
+    SECTION("deserialization stage and back-pressure") {
+        std::atomic<long> sum = 0;
+        std::atomic<size_t> texts = 0;
+        serializer::Bytes buff;
+        size_t pos = 0;
+        long expected = 0;
+
+        for (int i = 0; i < 1000; ++i) {
+            DispatchValue value{i};
+            DispatchText text{std::to_string(i)};
+            DispatchIgnored ignored{i};
+            pos = value.serialize(buff, pos);
+            pos = text.serialize(buff, pos);
+            pos = ignored.serialize(buff, pos);
+            expected += i;
+        }
+
+        Dispatcher dispatcher(
+            DispatchTable(),
+            DispatchHandlers{
+                [&](std::shared_ptr<DispatchValue> v) { sum += v->value; },
+                [&](std::shared_ptr<DispatchText> t) {
+                    texts += !t->text.empty();
+                }},
+            4, 8);
+        REQUIRE(dispatcher.receive(buff) == 2000);
+        dispatcher.wait();
+        REQUIRE(sum == expected);
+        REQUIRE(texts == 1000);
+        REQUIRE(!dispatcher.post(std::make_shared<DispatchIgnored>()));
+    }
+
+    SECTION("chained handlers") {
+        std::atomic<Dispatcher *> self = nullptr;
+        std::atomic<size_t> texts = 0;
+        Dispatcher dispatcher(
+            DispatchTable(),
+            DispatchHandlers{
+                [&](std::shared_ptr<DispatchValue> v) {
+                    auto text = std::make_shared<DispatchText>();
+                    text->text = std::to_string(v->value);
+                    self.load()->post(text);
+                },
+                [&](std::shared_ptr<DispatchText>) { ++texts; }},
+            2, 2);
+        self = &dispatcher;
+        for (int i = 0; i < 500; ++i) {
+            auto value = std::make_shared<DispatchValue>();
+            value->value = i;
+            REQUIRE(dispatcher.post(value));
+        }
+        dispatcher.wait();
+        REQUIRE(texts == 500);
+    }
+
+    SECTION("errors") {
+        Dispatcher dispatcher(
+            DispatchTable(),
+            [](std::shared_ptr<DispatchValue> v) {
+                if (v->value < 0) {
+                    throw std::runtime_error("negative value");
+                }
+            },
+            2);
+        auto value = std::make_shared<DispatchValue>();
+        value->value = -1;
+        dispatcher.post(value);
+        REQUIRE_THROWS_AS(dispatcher.wait(), std::runtime_error);
+        dispatcher.wait(); // the error is reported once
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                               numeric codecs                               */
+/******************************************************************************/
+
+#ifdef TEST_NUMERIC_CODECS
+#include <cmath>
+#include <cstring>
+#include <vector>
+struct WithCodecArrays {
+    std::vector<double> sparse;
+    std::vector<float> series;
+    std::vector<double> measures;
+    std::vector<int> counts;
+    size_t size = 0;
+    int *block = nullptr;
+
+    SERIALIZE(SER_ENCODED(serializer::tools::SparseCodec{}, sparse),
+              SER_ENCODED(serializer::tools::XorCodec{}, series),
+              SER_ENCODED(serializer::tools::QuantizedCodec(0.01), measures),
+              SER_ENCODED(serializer::tools::QuantizedCodec(1), counts), size,
+              SER_ENCODED(serializer::tools::SparseCodec{},
+                          SER_DARR(block, size)));
+};
+
+TEST_CASE("numeric codecs") {
+    serializer::Bytes bytes;
+    WithCodecArrays original, other;
+
+    original.sparse.resize(10000);
+    original.sparse[0] = 1.5;
+    original.sparse[77] = -0.0;
+    original.sparse[4000] = 3;
+    original.sparse[9999] = -2;
+    for (size_t i = 0; i < 1000; ++i) {
+        original.series.push_back(20.0f + float(i % 100) * 0.25f);
+        original.measures.push_back(std::sin(double(i) / 100.0));
+    }
+    original.counts = {-5, 100000, 3, 3, 3};
+    original.size = 300;
+    original.block = new int[300]();
+    original.block[150] = 42;
+
+    size_t end = original.serialize(bytes);
+    REQUIRE(other.deserialize(bytes) == end);
+
+    REQUIRE(other.sparse.size() == original.sparse.size());
+    for (size_t i = 0; i < original.sparse.size(); ++i) {
+        REQUIRE(std::signbit(other.sparse[i]) ==
+                std::signbit(original.sparse[i]));
+        REQUIRE(other.sparse[i] == original.sparse[i]);
+    }
+    REQUIRE(other.series == original.series);
+    REQUIRE(other.measures.size() == original.measures.size());
+    for (size_t i = 0; i < original.measures.size(); ++i) {
+        REQUIRE(std::abs(other.measures[i] - original.measures[i]) <= 0.005);
+    }
+    REQUIRE(other.counts == original.counts);
+    REQUIRE(other.size == 300);
+    REQUIRE(other.block[150] == 42);
+    REQUIRE(other.block[149] == 0);
+
+    // the encoded arrays are much smaller than the dense ones
+    size_t dense = serializer::serialize<serializer::Serializer<
+        serializer::Bytes>>(bytes, 0, original.sparse, original.series,
+                            original.measures, original.counts, original.size,
+                            SER_DARR(original.block, original.size));
+    REQUIRE(end * 10 < dense);
+
+    SECTION("compact sizes and null arrays") {
+        using Mem = serializer::tools::Compact<serializer::Bytes>;
+        using Ser = serializer::Serializer<Mem>;
+        Mem mem(bytes);
+        std::vector<float> series, result;
+        int *null = nullptr;
+        int *allocated = new int[1];
+        int *nullResult = allocated;
+        size_t size = 1;
+        for (float v : {1.0f, 1.0f, 1.5f, 1.25f}) {
+            series.push_back(v);
+        }
+        end = serializer::serialize<Ser>(
+            mem, 0, SER_ENCODED(serializer::tools::XorCodec{}, series),
+            SER_ENCODED(serializer::tools::SparseCodec{},
+                        SER_DARR(null, size)));
+        REQUIRE(serializer::deserialize<Ser>(
+                    mem, 0, SER_ENCODED(serializer::tools::XorCodec{}, result),
+                    SER_ENCODED(serializer::tools::SparseCodec{},
+                                SER_DARR(nullResult, size))) == end);
+        REQUIRE(result == series);
+        REQUIRE(nullResult == nullptr);
+        delete[] allocated;
+    }
+
+    SECTION("errors") {
+        std::vector<double> values = {NAN};
+        REQUIRE_THROWS_AS(
+            serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+                bytes, 0,
+                SER_ENCODED(serializer::tools::QuantizedCodec(0.1), values)),
+            std::out_of_range);
+        REQUIRE_THROWS_AS(serializer::tools::QuantizedCodec(0),
+                          std::invalid_argument);
+
+        // index out of the array
+        std::vector<int> sparse(10, 0), result;
+        sparse[9] = 1;
+        serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+            bytes, 0, SER_ENCODED(serializer::tools::SparseCodec{}, sparse));
+        bytes[0] = std::byte(5); // size of the array
+        REQUIRE_THROWS_AS(
+            serializer::deserialize<serializer::Serializer<serializer::Bytes>>(
+                bytes, 0,
+                SER_ENCODED(serializer::tools::SparseCodec{}, result)),
+            serializer::exceptions::CorruptedDataError);
+    }
+
+    SECTION("invalid container sizes") {
+        using Verified = serializer::tools::Verified<serializer::Bytes>;
+        using Ser = serializer::Serializer<Verified>;
+        std::vector<int> sparse(10, 0), counts = {1, 2, 3}, result;
+        Verified verified(bytes);
+
+        // the elements take at least one byte
+        end = serializer::serialize<Ser>(
+            verified, 0,
+            SER_ENCODED(serializer::tools::QuantizedCodec(1), counts));
+        size_t huge = size_t(1) << 40;
+        std::memcpy(bytes.data(), &huge, sizeof(huge));
+        REQUIRE_THROWS_AS(
+            serializer::deserialize<Ser>(
+                verified, 0,
+                SER_ENCODED(serializer::tools::QuantizedCodec(1), result)),
+            serializer::exceptions::CorruptedDataError);
+
+        // the sparse arrays are limited by maxSize
+        end = serializer::serialize<Ser>(
+            verified, 0, SER_ENCODED(serializer::tools::SparseCodec{}, sparse));
+        REQUIRE(serializer::deserialize<Ser>(
+                    verified, 0,
+                    SER_ENCODED(serializer::tools::SparseCodec{}, result)) ==
+                end);
+        REQUIRE(result == sparse);
+        REQUIRE_THROWS_AS(
+            serializer::deserialize<Ser>(
+                verified, 0,
+                SER_ENCODED(serializer::tools::SparseCodec{5}, result)),
+            serializer::exceptions::CorruptedDataError);
+        std::memcpy(bytes.data(), &huge, sizeof(huge));
+        REQUIRE_THROWS_AS(
+            serializer::deserialize<Ser>(
+                verified, 0,
+                SER_ENCODED(serializer::tools::SparseCodec{}, result)),
+            serializer::exceptions::CorruptedDataError);
+    }
+
+    delete[] original.block;
+    delete[] other.block;
+}
+#endif
+
+/******************************************************************************/
+/*                           optionals and variants                           */
+/******************************************************************************/
+
+#ifdef TEST_VARIANTS
+#include "test-classes/simple.hpp"
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+struct WithVariants {
+    std::optional<int> number;
+    std::optional<std::string> name;
+    std::variant<std::monostate, int, std::string, Simple> value;
+    std::vector<std::variant<double, std::vector<int>>> values;
+    std::optional<std::variant<char, Simple>> nested;
+
+    SERIALIZE(number, name, value, values, nested);
+};
+
+TEST_CASE("optional and variant") {
+    serializer::Bytes bytes;
+    WithVariants original, other;
+
+    static_assert(!serializer::concepts::Trivial<std::optional<int>>);
+    static_assert(!serializer::concepts::Trivial<std::variant<int, char>>);
+
+    original.number = 42;
+    original.value = Simple(1, 2, "simple");
+    original.values = {3.5, std::vector<int>{1, 2, 3}, 4.5};
+    original.nested = 'c';
+    other.name = "reset";
+
+    size_t end = original.serialize(bytes);
+    REQUIRE(other.deserialize(bytes) == end);
+    REQUIRE(other.number == 42);
+    REQUIRE(!other.name.has_value());
+    REQUIRE(std::get<Simple>(other.value) == Simple(1, 2));
+    REQUIRE(std::get<Simple>(other.value).str() == "simple");
+    REQUIRE(other.values == original.values);
+    REQUIRE(other.nested == original.nested);
+
+    SECTION("in place deserialization") {
+        original.number.reset();
+        original.name = "name";
+        original.value = std::monostate();
+        original.values = {std::vector<int>{4}};
+        original.nested = Simple(3, 4);
+        end = original.serialize(bytes);
+        REQUIRE(other.deserialize(bytes) == end);
+        REQUIRE(!other.number.has_value());
+        REQUIRE(other.name == "name");
+        REQUIRE(other.value.index() == 0);
+        REQUIRE(other.values == original.values);
+        REQUIRE(std::get<Simple>(*other.nested) == Simple(3, 4));
+
+        // the empty optional and the monostate only take their flag / index
+        std::optional<int> none;
+        std::variant<std::monostate, int> empty;
+        using Ser = serializer::Serializer<serializer::Bytes>;
+        REQUIRE(serializer::serialize<Ser>(bytes, 0, none, empty) == 2);
+    }
+
+    SECTION("compact memory") {
+        using Mem = serializer::tools::Compact<serializer::Bytes>;
+        Mem mem(bytes);
+        size_t compactEnd = original.serialize(mem);
+        REQUIRE(compactEnd < end);
+        WithVariants result;
+        REQUIRE(result.deserialize(mem) == compactEnd);
+        REQUIRE(result.values == original.values);
+        REQUIRE(std::get<Simple>(result.value) == Simple(1, 2));
+    }
+
+    SECTION("corrupted data") {
+        using Ser = serializer::Serializer<serializer::Bytes>;
+        std::optional<int> opt = 1;
+        std::variant<int, std::string> var = "str";
+        serializer::serialize<Ser>(bytes, 0, opt, var);
+
+        bytes[5] = std::byte(2); // invalid index
+        REQUIRE_THROWS_AS(serializer::deserialize<Ser>(bytes, 0, opt, var),
+                          serializer::exceptions::CorruptedDataError);
+        bytes[0] = std::byte(3); // invalid flag
+        REQUIRE_THROWS_AS(serializer::deserialize<Ser>(bytes, 0, opt, var),
+                          serializer::exceptions::CorruptedDataError);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                           pinned and staged memory                         */
+/******************************************************************************/
+
+#ifdef TEST_PINNED
+#include "serializer/tools/pinned.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+struct StagedBlock {
+    size_t size = 0;
+    double *values = nullptr;
+    std::vector<int> indices;
+    int *meta = nullptr;
+
+    SERIALIZE(size, SER_DARR(values, size), indices, meta);
+};
+
+TEST_CASE("pinned and staged memory") {
+    StagedBlock original;
+    original.size = 1000;
+    original.values = new double[1000];
+    for (size_t i = 0; i < original.size; ++i) {
+        original.values[i] = double(i) * 0.5;
+    }
+    original.indices = {1, 2, 3};
+    original.meta = new int(7);
+
+    SECTION("pinned bytes") {
+        serializer::tools::PinnedBytes<> bytes;
+        StagedBlock other;
+
+        REQUIRE(bytes.capacity() == 0);
+        size_t end = original.serialize(bytes);
+        REQUIRE(bytes.size() == end);
+        REQUIRE(bytes.capacity() >= end);
+        REQUIRE(bytes.capacity() % size_t(sysconf(_SC_PAGESIZE)) == 0);
+        REQUIRE(other.deserialize(bytes) == end);
+        REQUIRE(other.size == 1000);
+        REQUIRE(other.values[999] == 499.5);
+        REQUIRE(other.indices == original.indices);
+        REQUIRE(*other.meta == 7);
+
+        serializer::tools::PinnedBytes<> moved(std::move(bytes));
+        REQUIRE(moved.size() == end);
+        REQUIRE(bytes.data() == nullptr);
+        delete[] other.values;
+        delete other.meta;
+    }
+
+    SECTION("allocator hook") {
+        static size_t allocated = 0;
+        serializer::tools::HostAllocator hook{
+            [](size_t size) -> void * {
+                allocated += size;
+                return std::malloc(size);
+            },
+            [](void *ptr, size_t size) {
+                allocated -= size;
+                std::free(ptr);
+            }};
+        {
+            serializer::tools::PinnedBytes<> bytes(10, hook);
+            REQUIRE(allocated == bytes.capacity());
+            original.serialize(bytes);
+            REQUIRE(allocated == bytes.capacity());
+        }
+        REQUIRE(allocated == 0);
+
+        serializer::tools::HostAllocator failing{
+            [](size_t) -> void * { return nullptr; }, [](void *, size_t) {}};
+        REQUIRE_THROWS_AS(serializer::tools::PinnedBytes<>(1, failing),
+                          std::bad_alloc);
+    }
+
+    SECTION("staging buffer") {
+        serializer::Bytes bytes;
+        size_t end = original.serialize(bytes);
+        std::vector<std::byte> device(sizeof(double) * original.size + 256);
+        serializer::tools::StagingBuffer staging(device.data(), device.size());
+        serializer::tools::WithStaging<serializer::Bytes> mem(bytes, staging);
+        StagedBlock first, second;
+
+        // the payloads are placed one after the other in the staging memory
+        REQUIRE(first.deserialize(mem) == end);
+        size_t offset = staging.offset(first.values);
+        REQUIRE(offset < 256);
+        REQUIRE(reinterpret_cast<uintptr_t>(first.values) % 256 == 0);
+        REQUIRE(staging.size() == offset + sizeof(double) * original.size);
+        REQUIRE(first.values[999] == 499.5);
+        REQUIRE(*first.meta == 7);
+        REQUIRE_THROWS_AS(second.deserialize(mem), std::bad_alloc);
+
+        staging.reset();
+        REQUIRE(second.deserialize(mem) == end);
+        REQUIRE(staging.offset(second.values) == offset);
+        REQUIRE(second.indices == original.indices);
+    }
+
+    delete[] original.values;
+    delete original.meta;
+}
+#endif
+
+/******************************************************************************/
+/*                                    mpi                                     */
+/******************************************************************************/
+
+#if defined(TEST_MPI) && defined(SERIALIZER_WITH_MPI)
+#include "serializer/tools/mpi.hpp"
+#include "test-classes/simple.hpp"
+#include <cstdlib>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+struct MpiPoint {
+    double x = 0;
+    double y = 0;
+    int id = 0;
+
+    SERIALIZE_STRUCT();
+
+    bool operator==(MpiPoint const &) const = default;
+};
+
+struct MpiShape;
+struct MpiCircle;
+using MpiShapeTable = serializer::tools::TypeTable<MpiShape, MpiCircle>;
+
+struct MpiShape {
+    virtual ~MpiShape() = default;
+};
+
+struct MpiCircle : MpiShape {
+    double radius = 0;
+    SERIALIZE_POLYMORPHIC(MpiShapeTable, radius);
+};
+
+struct MpiBlock {
+    size_t size = 0;
+    double *values = nullptr;
+    std::string name;
+
+    SERIALIZE(size, SER_DARR(values, size), name);
+};
+
+TEST_CASE("mpi channel") {
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if (!initialized) {
+        MPI_Init(nullptr, nullptr);
+        std::atexit([] { MPI_Finalize(); });
+    }
+    // the messages are sent to the rank itself
+    serializer::tools::MpiChannel channel(MPI_COMM_SELF, 4096);
+
+    SECTION("chunked messages") {
+        MpiBlock original, other;
+        original.size = 100000;
+        original.values = new double[original.size];
+        for (size_t i = 0; i < original.size; ++i) {
+            original.values[i] = double(i) / 4;
+        }
+        original.name = "block";
+
+        auto receive = channel.receive(0, 1);
+        auto send = channel.send(0, 1, original, Simple(1, 2, "simple"));
+        REQUIRE(send.bytes().size() > 8 * original.size);
+        Simple simple;
+        REQUIRE(receive.deserialize(other, simple) + 8 == send.bytes().size());
+        send.wait();
+        REQUIRE(receive.source() == 0);
+        REQUIRE(receive.tag() == 1);
+        REQUIRE(other.size == original.size);
+        REQUIRE(other.values[original.size - 1] == original.values[99999]);
+        REQUIRE(other.name == "block");
+        REQUIRE(simple == Simple(1, 2));
+        delete[] original.values;
+        delete[] other.values;
+    }
+
+    SECTION("small messages and progress") {
+        std::vector<int> values = {1, 2, 3}, result;
+        auto send = channel.send(0, 2, values);
+        auto receive = channel.receive(MPI_ANY_SOURCE, MPI_ANY_TAG);
+        while (!receive.test()) {
+        }
+        REQUIRE(receive.deserialize(result) == send.bytes().size() - 8);
+        REQUIRE(result == values);
+
+        // the pending receptions are cancelled
+        { auto unmatched = channel.receive(0, 10); }
+    }
+
+    SECTION("bitwise structures") {
+        std::vector<MpiPoint> points(1000), result(1000);
+        for (int i = 0; i < 1000; ++i) {
+            points[size_t(i)] = MpiPoint{double(i), double(-i), i};
+        }
+        auto receive =
+            channel.receiveStructs(0, 4, std::span<MpiPoint>(result));
+        auto send =
+            channel.sendStructs(0, 4, std::span<MpiPoint const>(points));
+        receive.wait();
+        send.wait();
+        REQUIRE(result == points);
+    }
+
+    SECTION("type table") {
+        using Ser = serializer::Serializer<serializer::tools::PinnedBytes<>,
+                                           MpiShapeTable>;
+        std::vector<std::unique_ptr<MpiShape>> shapes, result;
+        shapes.push_back(std::make_unique<MpiCircle>());
+        static_cast<MpiCircle *>(shapes[0].get())->radius = 2.5;
+
+        auto receive = channel.receive(0, 5);
+        auto send = channel.send<Ser>(0, 5, shapes);
+        receive.deserialize<Ser>(result);
+        REQUIRE(result.size() == 1);
+        auto *circle = dynamic_cast<MpiCircle *>(result[0].get());
+        REQUIRE(circle);
+        REQUIRE(circle->radius == 2.5);
+    }
+
+    REQUIRE_THROWS_AS(serializer::tools::MpiChannel(MPI_COMM_SELF, 4),
+                      std::invalid_argument);
+}
+#endif